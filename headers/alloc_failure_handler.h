@@ -1,18 +1,28 @@
 /**
  * This file includes prototypes for functions that allow for knowing if an allocation failure has occurred,
  * which is necessary in order to a void memory-related errors.
+ * The failure flag is kept per assembly: every thread that assembles a file binds the handler to that assembly's own
+ * flag, so an allocation failure in one file does not affect files that are assembled concurrently.
  */
 
 #ifndef ALLOC_FAILURE_HANDLER_H
 #define ALLOC_FAILURE_HANDLER_H
 
+/**
+ * Binds the handler of the calling thread to a given flag, which belongs to the assembly that the thread is working on.
+ * Every following call to set_alloc_failure and is_alloc_failure from the same thread refers to that flag.
+ *
+ * @param flag a pointer to the flag of the current assembly, or NULL to go back to the process-wide flag
+ */
+void bind_alloc_failure_flag(unsigned *flag);
+
 /**
  * Notifies the handler that a memory allocation failure has occurred.
  */
 void set_alloc_failure();
 
 /**
- * Returns whether a memory allocation failure has occurred. 
+ * Returns whether a memory allocation failure has occurred.
  * @return 1 if an allocation failure has occurred, 0 otherwise
  */
 unsigned is_alloc_failure();
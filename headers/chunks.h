@@ -0,0 +1,54 @@
+/**
+ * Includes the state that every chunk of a file shares, and prototypes for functions that handle the chunks of a file
+ * at the same time, each on its own thread.
+ * A pass over a long file may split its work into chunks that are handled at the same time, and only use the result if
+ * it is the same as the result of a single run over the file. The messages of every chunk are buffered while the
+ * chunks run, and printed in the order of the chunks once the pass decides to use the result, so they are the same as
+ * the messages of a single run. A file is only split if every chunk would be long enough to be worth a thread.
+ * Every kind of chunk is a struct whose first member is a Chunk, so these functions can handle a list of any kind of
+ * chunks given the size of a chunk.
+ */
+#ifndef CHUNKS_H
+#define CHUNKS_H
+
+#include "stdio.h"
+
+/**
+ * The state that every chunk of a file shares, which should be the first member of every kind of chunk.
+ */
+typedef struct {
+    /* the stream that the chunk's messages are buffered in, or NULL if it was not created */
+    FILE *output;
+    /* the chunk's allocation failure flag */
+    unsigned alloc_failure;
+    /* whether an error was found in the chunk */
+    int error_found;
+} Chunk;
+
+/**
+ * Handles a list of chunks at the same time, each on its own thread, and waits for all of them to be done.
+ * Every chunk is handled with the thread's console bound to the chunk's buffer and the thread's allocation failure
+ * handler bound to the chunk's flag, and the result of the handling is kept as the chunk's error_found field.
+ * If a thread can't be started for a chunk, no more threads are started, so the result of the chunks that were
+ * handled should not be used.
+ *
+ * @param chunks      the list of chunks, whose buffers should already be created
+ * @param chunk_count the number of chunks
+ * @param chunk_size  the size of every chunk in the list
+ * @param handle      the function that handles a chunk, given a pointer to it, and returns 1 if an error was found in
+ *                    it, 0 otherwise
+ * @return 1 if every chunk was handled, 0 otherwise (in which case allocation failures in the chunks are ignored)
+ */
+int run_chunks(void *chunks, int chunk_count, size_t chunk_size, int (*handle)(void *chunk));
+
+/**
+ * Prints the messages of a list of chunks in order, if the result of the chunks is used, and closes their buffers.
+ *
+ * @param chunks      the list of chunks, some of which may have no buffer
+ * @param chunk_count the number of chunks
+ * @param chunk_size  the size of every chunk in the list
+ * @param used        whether the result of the chunks is used, in which case their messages should be printed
+ */
+void close_chunks(void *chunks, int chunk_count, size_t chunk_size, int used);
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * Includes prototypes for functions that print messages (errors, warnings and progress reports) to the user.
+ * Messages are printed to the console stream of the calling thread, which is the standard output unless the thread
+ * has been bound to another stream. This allows for buffering the messages of every assembled file separately when
+ * several files are assembled at the same time.
+ */
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "stdio.h"
+
+/**
+ * Binds the console of the calling thread to a given stream. Every following message printed by the thread using
+ * console_printf is written to that stream.
+ *
+ * @param stream the stream that messages should be written to, or NULL to go back to the standard output
+ */
+void bind_console(FILE *stream);
+
+/**
+ * Returns the stream that the calling thread's messages are written to.
+ *
+ * @return the stream the calling thread is bound to, or the standard output if it is not bound to any stream
+ */
+FILE *console();
+
+/**
+ * Prints a formatted message to the console of the calling thread, using the same format as printf.
+ *
+ * @param format the format of the message
+ * @param ...    the values that should be formatted into the message
+ */
+void console_printf(char *format, ...);
+
+/**
+ * Prints the messages that were buffered in a stream to the console of the calling thread, from the start of the
+ * stream.
+ *
+ * @param buffer the stream that the messages were buffered in
+ */
+void console_flush_buffer(FILE *buffer);
+
+#endif
@@ -6,7 +6,6 @@
 #ifndef CONVERSIONS_H
 #define CONVERSIONS_H
 
-#include "math.h"
 #include "operators.h"
 #include "symbols.h"
 
@@ -26,7 +25,7 @@
  * The unsigned value of a word in the memory representing an integer in the 2's complement method.
  * Returns it as an unsigned short whose leftmost bit is 0.
  */
-#define DATA_NUM_TO_WORD(x) (((unsigned short)((x) >= 0 ? (x) : (pow(2, WORD_SIZE_BITS)) - (-(x)))))
+#define DATA_NUM_TO_WORD(x) ((unsigned short) ((x) >= 0 ? (x) : (1L << WORD_SIZE_BITS) + (x)))
 
 /**
  * The size in bits of a number given in the immediate address method.
@@ -36,33 +35,39 @@
 /**
  * The maximum value that a number given in the immediate address method can have.
  */
-#define IMMEDIATE_VALUE_MAX (pow(2, (IMMEDIATE_VALUE_SIZE_BITS - 1)) - 1)
+#define IMMEDIATE_VALUE_MAX ((1 << (IMMEDIATE_VALUE_SIZE_BITS - 1)) - 1)
 
 /**
  * The minimum value that a number given in the immediate address method can have.
  */
-#define IMMEDIATE_VALUE_MIN (-pow(2, (IMMEDIATE_VALUE_SIZE_BITS - 1)))
+#define IMMEDIATE_VALUE_MIN (-(1 << (IMMEDIATE_VALUE_SIZE_BITS - 1)))
 
 /**
- * Creates the first memory word representing an instruction.
- * 
- * @param op                 the instruction's operator
- * @param source_method      the address method for the source operand
- * @param destination_method the address method for the destination operand
- * @return the first word of the instruction's binary value, padded with a zero on the left so it can be returned
- * as an unsigned short.
+ * The maximum number of memory words of an instruction - its first word and a word for each of its two operands.
+ */
+#define MAX_INSTRUCTION_WORDS 3
+
+/**
+ * Represents the encoding of an instruction that is known from its operator and the address methods of its operands
+ * alone - its first memory word, and the layout of the words after it.
  */
-short unsigned build_instruction_first_word(Operator op, AddressMethod source_method, AddressMethod destination_method);
+typedef struct {
+    /* the first word of the instruction's binary value, padded with a zero on the left */
+    short unsigned first_word;
+    /* whether the operands share a single additional word (when both are in one of the register address methods) */
+    unsigned combined : 1;
+} InstructionEncoding;
 
 /**
- * Checks if the second and third words of an instruction should be combined to a single word.
- * Should only for two-operand instructions.
+ * Returns the encoding of an instruction based on its operator and the address methods of its operands.
  * 
+ * @param op                 the instruction's operator, which should be legal
  * @param source_method      the address method for the source operand
  * @param destination_method the address method for the destination operand
- * @return 1 if the additional words should be combined, 0 otherwise
+ * @return a pointer to the (constant) encoding of the instruction
  */
-int should_combine_additional_words(AddressMethod source_method, AddressMethod destination_method);
+const InstructionEncoding *get_instruction_encoding(Operator op, AddressMethod source_method,
+                                                    AddressMethod destination_method);
 
 /**
  * Creates a memory word representing a source register (a source operand in either one of the register
@@ -0,0 +1,67 @@
+/**
+ * Includes the encoding cache, which maps the instructions of a file that do not refer to any symbol to their memory
+ * words, and prototypes for functions that allow for interacting with it.
+ * The words of such an instruction depend on nothing but its text, so an instruction that appears again (as the lines
+ * of expanded code often do) is encoded by copying the words that were found for it the first time, without checking
+ * the address methods of its operands or encoding them again.
+ * An instruction is represented by its normalized text - its operator and operands, without the whitespaces around
+ * them. The cache is a hash-map of encodings (see HashMap) from that text to the instruction's words, and its keys are
+ * allocated from the arena of the file.
+ */
+#ifndef ENCODING_CACHE_H
+#define ENCODING_CACHE_H
+
+#include "conversions.h"
+#include "structures/arena.h"
+#include "structures/hash_map.h"
+
+/**
+ * The encoding cache of a file, along with the number of instructions that were and were not found in it.
+ */
+typedef struct {
+    /* the map from the normalized text of every cached instruction to its memory words */
+    HashMap *map;
+    /* the arena that the keys are allocated from */
+    Arena *arena;
+    /* the number of lookups that found the instruction, and that did not */
+    long hits;
+    long misses;
+} EncodingCache;
+
+/**
+ * Creates a new, empty encoding cache.
+ *
+ * @param arena a pointer to the arena that the keys should be allocated from
+ * @return a pointer to the new cache, or NULL if an allocation failure has occurred
+ */
+EncodingCache *create_encoding_cache(Arena *arena);
+
+/**
+ * Looks for an instruction in an encoding cache, and counts the lookup as a hit or a miss.
+ *
+ * @param cache a pointer to the cache
+ * @param key   the normalized text of the instruction
+ * @return a pointer to the cached encoding of the instruction, or NULL if it is not in the cache
+ */
+const EncodingContent *find_cached_encoding(EncodingCache *cache, char *key);
+
+/**
+ * Adds an instruction to an encoding cache. Should only be used after verifying that the instruction is not in the
+ * cache using find_cached_encoding.
+ *
+ * @param cache      a pointer to the cache
+ * @param key        the normalized text of the instruction
+ * @param words      the instruction's memory words
+ * @param word_count the number of the instruction's memory words (at most MAX_INSTRUCTION_WORDS)
+ * @return 0 if the instruction was added successfully, 1 if an allocation failure has occurred
+ */
+int add_cached_encoding(EncodingCache *cache, char *key, unsigned short words[], int word_count);
+
+/**
+ * Frees an encoding cache. The keys are released along with the arena they were allocated from.
+ *
+ * @param cache a pointer to the cache to be freed
+ */
+void free_encoding_cache(EncodingCache *cache);
+
+#endif
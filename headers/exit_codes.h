@@ -12,5 +12,7 @@
 #define MEMORY_ALLOCATION_FAILURE 2
 /* no files were given to the assembler */
 #define NO_FILES_GIVEN 3
+/* the command line options given to the assembler are invalid */
+#define INVALID_OPTIONS 4
 
 #endif
@@ -18,6 +18,11 @@
 
 #define COMMENT_START ';'
 
+/**
+ * The first field of a line is considered a label if it ends with a colon (and is not part of a comment).
+ */
+#define LABEL_END ':'
+
 /**
  * The first field of a line (excluding the label) is considered a directive if it starts with a period.
  */
@@ -52,12 +57,12 @@
 /**
  * The maximum value that a word in the memory can hold.
  */
-#define MAX_WORD_SIZE (short)(pow(2, WORD_SIZE_BITS - 1) - 1)
+#define MAX_WORD_SIZE ((1 << (WORD_SIZE_BITS - 1)) - 1)
 
 /**
  * The minimum value that a word in the memory can hold.
  */
-#define MIN_WORD_SIZE (short)(-(pow(2, WORD_SIZE_BITS - 1)))
+#define MIN_WORD_SIZE (-(1 << (WORD_SIZE_BITS - 1)))
 
 /**
  * The first character of an operand in the immediate address method.
@@ -103,22 +108,6 @@ int legal_label_name(char *name);
  */
 int legal_macro_name(char *name);
 
-/**
- * Determines if a given field is a label.
- * Should be used on the first field of the line.
- * 
- * @param field the field to be checked
- * @return 1 if the field is a label, 0 otherwise
- */
-int is_label(char *field);
-
-/**
- * Transforms a given label (including the colon) into the appropriate symbol it represents (without the colon).
- * 
- * @param label the label to be transformed
- */
-void label_to_symbol(char *label);
-
 /**
  * Checks if a given field is a legal directive. 
  * 
@@ -127,14 +116,6 @@ void label_to_symbol(char *label);
  */
 int is_directive(char *field);
 
-/**
- * Finds the label of a line with a given pointer to it and changes the pointer's value to not include the label.
- * 
- * @param line             a pointer to the line being read
- * @param label_name       a pointer to a string whose value should be the label if there is one, or NULL if there isn't
- */
-void find_label(char **line, char **label_name);
-
 /**
  * Finds the address method of a given operand.
  * 
@@ -1,84 +1,86 @@
 /**
- * Includes prototypes for functions that handle getting the names and opening files in different formats.
+ * Includes prototypes for functions that handle getting the names and opening files in different formats, and writing
+ * the output files.
  */
 #ifndef FILES_H
 #define FILES_H
 
 #include "stdio.h"
 #include "requirements.h"
+#include "util/source_file.h"
 
 /**
  * Gets a file name without an extension and returns the name of the input file with the .as extension.
  * 
  * @param file_name the file name without the extension (as given as command line argument)
+ * @param arena     a pointer to the arena that the name should be allocated from
  * @return the name of the input file with the extension, or NULL if a memory allocation failure occurred
  */
-char *get_input_file_name(char file_name[]);
+char *get_input_file_name(char file_name[], Arena *arena);
 
 /**
- * Gets a file name without an extension and returns the name of the parsed input file with the .am extension.
- * 
- * @param file_name the file name without the extension (as given as command line argument)
- * @return the name of the parsed file with the extension, or NULL if a memory allocation failure occurred
- */
-char *get_parsed_file_name(char file_name[]);
-
-/**
- * Returns a pointer to the input file with a read permission based on the extensionless file name.
- * 
- * @param file_name the name of the input file without the extension
- * @return a pointer to the now-open file, or NULL if the file could not be opened
- */
-FILE *get_input_file(char file_name[]);
-
-/**
- * Returns a pointer to a new file with an append permission based on the extensionless file name, which should act
- * as the parsed macro-less file.
- * Before opening the file, deletes any exsisting parsed file with the same to avoid writing to an existing file,
- * and instead generate a new one.
+ * Returns a pointer to the input file, mapped into the memory, based on the extensionless file name.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return a pointer to the now-open source-file, or NULL if the file could not be opened
  */
-FILE *get_parsed_file_append(char file_name[]);
+SourceFile *get_input_file(char file_name[], Arena *arena);
 
 /**
- * Returns a pointer to the parsed, macro-less file with a read permission based on the extensionless file name.
+ * Creates the parsed macro-less file (.am) based on the extensionless file name, and writes given contents into it.
+ * If a file with this name already exists, its contents are replaced.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_parsed_file_read(char file_name[]);
+int save_parsed_file(char file_name[], char *contents, long length, Arena *arena);
 
 /**
- * Returns a pointer to the object file based on the extensionless file name.
+ * Creates the object file (.ob) based on the extensionless file name, and writes given contents into it.
+ * If a file with this name already exists, its contents are replaced.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_object_file(char file_name[]);
+int save_object_file(char file_name[], char *contents, long length, Arena *arena);
 
 /**
- * Returns a pointer to the extern symbols file (.ext) based on the extensionless file name.
+ * Creates the extern symbols file (.ext) based on the extensionless file name, and writes given contents into it.
+ * If a file with this name already exists, its contents are replaced.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_extern_file(char file_name[]);
+int save_extern_file(char file_name[], char *contents, long length, Arena *arena);
 
 /**
- * Returns a pointer to the entry symbols file (.ent) based on the extensionless file name.
+ * Creates the entry symbols file (.ent) based on the extensionless file name, and writes given contents into it.
+ * If a file with this name already exists, its contents are replaced.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_entry_file(char file_name[]);
+int save_entry_file(char file_name[], char *contents, long length, Arena *arena);
 
 /**
  * Removes all output files (parsed, object, extern and entry) corresponding to a given extensionless file name.
  * 
  * @param file_name the name of the input file without the extension
+ * @param arena     a pointer to the arena that the names of the files should be allocated from
  */
-void remove_output_files(char file_name[]);
+void remove_output_files(char file_name[], Arena *arena);
 
 #endif
@@ -2,11 +2,12 @@
  * Includes the prototype for the first_pass function, which executes the first pass of the assembler over the parsed,
  * macro-less file.
  * The first pass handles the encoding of everything that never depends on the values of any symbol: That includes 
- * the .data, .string and .extern directives and the first word of every instruction.
+ * the .data, .string and .extern directives, the first word of every instruction and every operand that is not
+ * a symbol.
  * In addition, the first pass checks for the legality of everything it encodes, 
- * as well as the legality of the syntax of an instruction (does not check that the content of the operands is legal,
- * but checks everything else in the instruction). It also builds the symbol table for the second pass.
- * Assumes that the input .as file has already been parsed to a macro-less .am file.
+ * as well as the legality of the syntax of an instruction. It also builds the symbol table and leaves fixups for
+ * the second pass.
+ * Assumes that the input .as file has already been parsed into the macro-less parsed source of its requirements.
  * Also assumes that a symbol can be defined as .extern more than once, since it doesn't not interfere with any
  * part of the assembly process.
  */
@@ -19,11 +20,12 @@
 /**
  * Executes the first pass of the assembler over a parsed, macro-less file.
  * Handles the encoding of everything that never depends on the values of any symbol: That includes 
- * the .data, .string and .extern directives and the first word of every instruction.
+ * the .data, .string and .extern directives, the first word of every instruction and every operand that is not
+ * a symbol. Leaves a fixup for every symbol operand and .entry directive, which are handled by the second pass.
  * In addition, the first pass checks for the legality of everything it encodes, 
- * as well as the legality of the syntax of an instruction (does not check that the content of the operands is legal,
- * but checks everything else in the instruction).
- * Assumes that the input .as file has already been parsed to a macro-less .am file.
+ * as well as the legality of the syntax of an instruction. Errors in the content of operands are left for the
+ * second pass, so they are reported in order with the errors of the symbols.
+ * Assumes that the input .as file has already been parsed into the macro-less parsed source of its requirements.
  * 
  * @param file_name    the extension-less file name
  * @param requirements a pointer to the requirements for the assembly of the file
@@ -0,0 +1,48 @@
+/**
+ * Includes definitions which represent fixups - records that the first pass leaves for everything it can't finish
+ * encoding by itself, since it depends on symbols which may only be defined later in the file.
+ * The second pass goes over the fixups in the order in which they were left (the order of the lines) instead of
+ * reading the file again.
+ */
+#ifndef FIXUPS_H
+#define FIXUPS_H
+
+#include "fields.h"
+
+/**
+ * Represents the kind of a fixup - either an operand whose memory word should be filled, or the argument of a .entry
+ * directive, which should be marked as an entry symbol.
+ */
+typedef enum FixupKind {
+    OPERAND_FIXUP, ENTRY_FIXUP
+} FixupKind;
+
+/**
+ * Represents a fixup - a part of a line which can only be handled once the entire file has been read.
+ * Operand fixups are left for operands in the direct address method, as well as for operands whose content was found
+ * to be invalid, so that their errors are reported along with the errors of the symbols, in the order of the lines.
+ */
+typedef struct Fixup {
+    FixupKind kind;
+    /* the number of the line in the input file that the fixup was left for */
+    int line;
+    /* the index of the line of a macro's content that the fixup's line was stamped out from, or -1 if it does not come
+     * from a macro (only used for operand fixups) */
+    int macro_line;
+    /* the operand, or the argument of the .entry directive (allocated from the file's arena) */
+    char *symbol;
+    /* the handle of the symbol in the symbol table, or -1 if the fixup does not refer to a symbol (an operand which is
+     * not in the direct address method, or an empty argument) */
+    int handle;
+    /* the operand's address method (only used for operand fixups) */
+    AddressMethod method;
+    /* the address of the operand's memory word, or -1 if the word could not be inserted (only used for operand
+     * fixups) */
+    int address;
+    /* whether the .entry directive has a label (only used for entry fixups) */
+    unsigned has_label : 1;
+    /* whether the .entry directive has extra characters after its argument (only used for entry fixups) */
+    unsigned has_extra_characters : 1;
+} Fixup;
+
+#endif
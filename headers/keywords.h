@@ -0,0 +1,33 @@
+/**
+ * Includes the Keyword structure, which represents one of the reserved words of the assembly language (the operators,
+ * directives, registers and macro keywords), and a prototype for the function that recognizes them.
+ */
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+/**
+ * Represents the category that a keyword belongs to.
+ */
+typedef enum {
+    OPERATOR_KEYWORD, DIRECTIVE_KEYWORD, REGISTER_KEYWORD, MACRO_KEYWORD
+} KeywordKind;
+
+/**
+ * Represents a keyword - its name, its category and a value whose meaning depends on the category: the opcode for
+ * an operator, the number for a register, and the keyword's index within its category otherwise.
+ */
+typedef struct {
+    char *name;
+    KeywordKind kind;
+    int value;
+} Keyword;
+
+/**
+ * Finds the keyword with a given name.
+ * 
+ * @param name the name to be checked
+ * @return a pointer to the keyword with the given name, or NULL if the name is not a keyword
+ */
+const Keyword *find_keyword(char *name);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * Includes the LexedLine structure, which holds everything the assembler needs to know about a line - its kind, its
+ * label, its operator or directive, and its operands with their address methods - and a prototype for the function
+ * that finds all of it in a single scan over the line.
+ */
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "fields.h"
+#include "operators.h"
+#include "util/general_util.h"
+#include "util/string_ops.h"
+
+/**
+ * Represents the kind of a line. The directive kinds are in the order of the values of the directive keywords.
+ */
+typedef enum LineKind {
+    /* a line made of only whitespace characters */
+    BLANK_LINE,
+    /* a line whose first character is a semicolon */
+    COMMENT_LINE,
+    /* a line with a semicolon after its first character, which is illegal */
+    MISPLACED_COMMENT_LINE,
+    /* a line with a label and nothing after it, which is illegal */
+    LABEL_ONLY_LINE,
+    DATA_LINE, STRING_LINE, ENTRY_LINE, EXTERN_LINE,
+    /* a line whose first field (after the label) starts with a period, but is not a legal directive */
+    ILLEGAL_DIRECTIVE_LINE,
+    /* any other line - an instruction, whose operator may be illegal */
+    INSTRUCTION_LINE
+} LineKind;
+
+/**
+ * Represents the first syntax error in the operands of an instruction, in the order in which they are checked.
+ */
+typedef enum OperandError {
+    NO_OPERAND_ERROR,
+    /* errors of two-operand instructions */
+    LEADING_COMMA, TRAILING_COMMA, CONSECUTIVE_COMMAS, MISSING_SOURCE, MISSING_COMMA,
+    /* errors of one-operand and two-operand instructions */
+    MISSING_DESTINATION, EXTRA_AFTER_DESTINATION,
+    /* errors of one-operand instructions */
+    ILLEGAL_COMMA, TOO_MANY_OPERANDS,
+    /* errors of instructions without operands */
+    EXTRA_AFTER_INSTRUCTION
+} OperandError;
+
+/**
+ * Represents a lexed line of the parsed source.
+ * Its parts are views into the line that was lexed, so they are only valid as long as the line is.
+ */
+typedef struct {
+    LineKind kind;
+    /* whether the line has a label */
+    unsigned has_label : 1;
+    /* the line's label, without the colon (only used if it has one) */
+    StringView label;
+    /* the first field of the line after the label - the operator or directive */
+    StringView field;
+    /* the part of the line after the field */
+    char *rest;
+    /* the instruction's operator, which is the illegal operator if the field is not an operator's name (only used for
+     * instruction lines) */
+    Operator op;
+    /* the first syntax error in the instruction's operands (only used for instruction lines with a legal operator) */
+    OperandError operand_error;
+    /* the source operand and its address method (NO_OPERAND if the instruction has no source operand) */
+    StringView source;
+    AddressMethod source_method;
+    /* the destination operand and its address method (NO_OPERAND if the instruction has no destination operand) */
+    StringView destination;
+    AddressMethod destination_method;
+} LexedLine;
+
+/**
+ * Lexes a line - classifies it and finds its label, its operator or directive, and its operands (if they have no
+ * syntax errors) with their address methods.
+ *
+ * @param line  the line to be lexed, which should be at most MAX_LINE_LENGTH characters long
+ * @param lexed a pointer to the structure that the result should be written into
+ */
+void lex_line(char *line, LexedLine *lexed);
+
+#endif
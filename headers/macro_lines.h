@@ -0,0 +1,56 @@
+/**
+ * Includes definitions which represent the lines of the macros' contents - templates which are made once, when a macro
+ * is defined, and stamped out at every usage of the macro.
+ * A line of a macro's content is lexed once, when the macro is defined, and every usage of the macro copies its parsed
+ * line instead of lexing it again. An instruction is also encoded once, the first time the macro is used, and the
+ * usages after it copy its words and fixups, only rebasing their addresses.
+ */
+#ifndef MACRO_LINES_H
+#define MACRO_LINES_H
+
+#include "parsed_lines.h"
+#include "fixups.h"
+#include "conversions.h"
+
+/**
+ * The maximum number of fixups that an instruction leaves - one for each of its operands.
+ */
+#define MAX_INSTRUCTION_FIXUPS 2
+
+/**
+ * Represents how the first pass has handled a line of a macro's content so far.
+ */
+typedef enum MacroLineState {
+    /* the line has not been used yet, or it is not an instruction, so it is handled from its parsed line */
+    UNENCODED_MACRO_LINE,
+    /* the line is an instruction that was encoded without errors, so it is stamped out from its words and fixups */
+    ENCODED_MACRO_LINE,
+    /* an error was found in the line, so it was reported and the line is not handled again */
+    FAILED_MACRO_LINE
+} MacroLineState;
+
+/**
+ * Represents a line of a macro's content.
+ */
+typedef struct {
+    /* the index in the input file in which the line starts */
+    long offset;
+    /* the number of characters in the line, not including its line break */
+    int length;
+    /* the line, lexed when the macro was defined - its start in the parsed source is set at every usage */
+    ParsedLine parsed;
+    /* how the first pass has handled the line so far (a MacroLineState) */
+    unsigned state : 2;
+    /* whether the second pass has reported an error in one of the line's operands */
+    unsigned operand_error_reported : 1;
+    /* the number of the instruction's memory words and fixups (only used for encoded lines) */
+    unsigned char word_count;
+    unsigned char fixup_count;
+    /* the instruction's memory words (only used for encoded lines) */
+    unsigned short words[MAX_INSTRUCTION_WORDS];
+    /* the instruction's fixups, whose addresses are relative to the instruction's first word (only used for encoded
+     * lines) */
+    Fixup fixups[MAX_INSTRUCTION_FIXUPS];
+} MacroLine;
+
+#endif
@@ -12,8 +12,9 @@
 #include "fields.h"
 
 /**
- * Represents an operator, which has a name, a list of legal source address methods and a a list of legal
- * destination address methods. The opcode is defined externally as the index of the operator in the operators array.
+ * Represents an operator, which has a name, a list of legal source address methods, a a list of legal destination
+ * address methods and an opcode. The opcode is the index of the operator in the operators array, and is kept in the
+ * operator as well so that encoding an instruction doesn't require looking the operator up again.
  */
 typedef struct {
     
@@ -32,16 +33,21 @@ typedef struct {
      * If the operator does not have a destination operand, all bits are off.
      */
     unsigned legal_destination_methods : 4;
+    
+    /**
+     * The operator's opcode, or NUMBER_OF_OPERATORS for the illegal operator.
+     */
+    unsigned opcode : 5;
 } Operator;
 
 /**
- * Returns a static list of the operators, where each operator's index is its opcode.
+ * Returns a static, constant list of the operators, where each operator's index is its opcode.
  * Also includes an additional, illegal operator which is used for default return values of functions that look for an
  * operator on the list.
  * 
  * @return the list described in the function summary
  */
-Operator *operators();
+const Operator *operators();
 
 /**
  * Checks if a given address method is legal as source address method for the given operator.
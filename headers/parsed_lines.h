@@ -0,0 +1,56 @@
+/**
+ * Includes definitions which represent parsed lines - the intermediate representation of the parsed source, which the
+ * pre-assembler produces as it writes each line and the first pass goes over instead of reading and lexing the text
+ * again.
+ * A parsed line refers to the parts of its line by their positions in it, so it is kept small, and it remembers the
+ * line of the input file that it comes from, so errors can be reported in terms of the input file.
+ */
+#ifndef PARSED_LINES_H
+#define PARSED_LINES_H
+
+/**
+ * Represents a part of a line by its position in the line. A line is at most MAX_LINE_LENGTH characters long, so both
+ * the position and the length fit in a single byte.
+ */
+typedef struct {
+    /* the index of the part's first character in the line */
+    unsigned char offset;
+    /* the number of characters in the part */
+    unsigned char length;
+} LinePart;
+
+/**
+ * Represents a lexed line of the parsed source (see lex_line). Blank lines and comments are not represented, since
+ * they have no effect on the assembly.
+ */
+typedef struct ParsedLine {
+    /* the index in the parsed source in which the line starts */
+    int start;
+    /* the number of the line in the input file - for a line that comes from a macro's content, the number of the line
+     * in the macro's definition */
+    int source_line;
+    /* the index of the line of a macro's content that the line was stamped out from, or -1 if it does not come from a
+     * macro */
+    int macro_line;
+    /* the line's label without the colon (only used if it has one), the operator or directive, the operands, and the
+     * part of the line after the operator or directive */
+    LinePart label;
+    LinePart field;
+    LinePart source;
+    LinePart destination;
+    LinePart rest;
+    /* the kind of the line (a LineKind) */
+    unsigned kind : 4;
+    /* whether the line has a label */
+    unsigned has_label : 1;
+    /* the opcode of the instruction's operator, or NUMBER_OF_OPERATORS if it is illegal (only used for instruction
+     * lines) */
+    unsigned opcode : 5;
+    /* the first syntax error in the instruction's operands (an OperandError) */
+    unsigned operand_error : 4;
+    /* the address methods of the operands, which are NO_OPERAND if the instruction does not have them */
+    unsigned source_method : 3;
+    unsigned destination_method : 3;
+} ParsedLine;
+
+#endif
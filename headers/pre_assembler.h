@@ -1,8 +1,8 @@
 /**
  * This file is include a prototype for the function responsible for the pre-assembly process.
- * The function is pre-assemble, which takes in a file name without the .as extension and parses it into a new .am file
- * with the same name. If a .am file with this name already exists, deletes it and  creates a new file. 
- * If any errors are found, the .am file is not created, but the program keeps analyzing the input file in order to find
+ * The function is pre-assemble, which takes in a file name without the .as extension and parses it into the parsed
+ * source buffer of the file's requirements. If asked to, also writes the parsed source into a new .am file with the
+ * same name. If any errors are found, the .am file is not created, but the program keeps analyzing the input file in order to find
  * more errors. Assumes that the definition of every macro comes before its usage, that there are no nested macro
  * definitions, that a macro cannot be defined if a macro with the same name has already been defined, 
  * and that a macro definition and ending cannot have labels.
@@ -14,10 +14,11 @@
 #define PRE_ASSAMBLER_H
 
 #include "requirements.h"
+#include "util/source_file.h"
 
 /**
- * Reads an input file and parses all of its macros. Creates a new parsed file with the same name and a .am extension.
- * If a .am file with the same name already exists, deletes it and creates a new file.
+ * Reads an input file and parses all of its macros into the parsed source buffer of the file's requirements. If asked
+ * to, also creates a new parsed file with the same name and a .am extension which holds the parsed source.
  * If any error is found during the pre-assembling, will not create a parsed file, but will continue parsing the input
  * file and reporting errors, as long as the error does not prevent that.
  * Assumes that the definition of every macro comes before its usage, that there are no nested macro definitions, that
@@ -26,10 +27,13 @@
  * Also, if a macro with a colon at the end is used, it is assumed to be a label (based on a forum answer, I can handle
  * it as I see fit as long as I provide adequate documentation).
  * 
- * @param file_name    the name of the input file without the .as extension
- * @param requirements a pointer to the requirements of the file
+ * @param file_name        the name of the input file without the .as extension
+ * @param input_file       a pointer to the input file if it was already opened, which is closed once it is read, or
+ *                         NULL if it should be opened based on its name
+ * @param requirements     a pointer to the requirements of the file
+ * @param emit_parsed_file whether the parsed source should also be written into a .am file
  * @return 1 if an error was found, 0 if the file was parsed successfully
  */
-int pre_assemble(char file_name[], Requirements *requirements);
+int pre_assemble(char file_name[], SourceFile *input_file, Requirements *requirements, int emit_parsed_file);
 
 #endif
@@ -7,32 +7,128 @@
 #define REQUIREMENTS_H
 
 #include "structures/hash_map.h"
-#include "structures/set.h"
+#include "fixups.h"
+#include "parsed_lines.h"
+#include "macro_lines.h"
+#include "encoding_cache.h"
+#include "structures/text_buffer.h"
+#include "structures/arena.h"
+#include "limits.h"
 
 #define MEMORY_SIZE 4096
+
+/**
+ * The number of bytes in a bitmap that has a bit for every character.
+ */
+#define CHARACTER_BITMAP_SIZE ((UCHAR_MAX + 1) / CHAR_BIT)
 #define IC_START 100
 
+/**
+ * An index of the symbols of a file that appear in one of its output files - either its external symbols or its entry
+ * symbols. It is kept up to date as the symbols are declared, so the output files can be created without going over
+ * the entire symbol table.
+ */
+typedef struct {
+    /* the handles of the symbols in the symbol table, in the order in which they were declared */
+    int *handles;
+    /* the number of symbols in the index */
+    int count;
+    /* the number of symbols that the allocated memory can hold */
+    int capacity;
+    /* the length of the longest name in the index */
+    int max_name_length;
+} SymbolIndex;
+
 /**
  * The requirement data structure. Exactly one of which must be created for the assembly of each file.
  */
 typedef struct {
     
+    /**
+     * The arena that every object which lives as long as the assembly of the file is allocated from - the names of the
+     * macros and symbols and the fixups' symbols. It is not owned by the requirements, so it can be reused for the
+     * next file once it is reset.
+     */
+    Arena *arena;
+    
     /**
      * The table that maps each macro to its content.
      */
     HashMap *macro_table;
     
+    /**
+     * The lines of the macros' contents, in the order in which they were defined. Each macro refers to a range of
+     * them, which is stamped out into the parsed source and parsed lines whenever the macro is used.
+     */
+    MacroLine *macro_lines;
+    
+    /**
+     * The number of lines of the macros' contents.
+     */
+    int macro_line_count;
+    
+    /**
+     * The number of lines of the macros' contents that the allocated memory can hold.
+     */
+    int macro_line_capacity;
+    
+    /**
+     * A bitmap of the first characters of the macros' names. A line whose first field starts with any other character
+     * is not a macro usage, so the macro table does not need to be searched for it.
+     */
+    unsigned char macro_first_chars[CHARACTER_BITMAP_SIZE];
+    
+    /**
+     * The parsed, macro-less source of the file, produced by the pre-assembler. It is kept in the memory, so the .am
+     * file only needs to be written if it was asked for, and the parsed lines refer to the parts of its lines.
+     */
+    TextBuffer *parsed_source;
+    
+    /**
+     * The lines of the parsed source, lexed by the pre-assembler as they are written, in the order of the parsed
+     * source. The first pass goes over them instead of reading the parsed source.
+     */
+    ParsedLine *parsed_lines;
+    
+    /**
+     * The number of parsed lines.
+     */
+    int parsed_line_count;
+    
+    /**
+     * The number of parsed lines that the allocated memory can hold.
+     */
+    int parsed_line_capacity;
+    
     /**
      * The table that maps each symbol to its value and characteristics.
      */
     HashMap *symbol_table;
     
     /**
-     * A set containing the line numbers of instructions that have errors which are found during the first pass.
-     * During the second pass, if the number of the analyzed number appears in the list, then it is skipped. If it
-     * does not, then its syntax must be valid.
+     * The symbols that are declared as external, which are listed in the .ext file (if they are used).
+     */
+    SymbolIndex extern_symbols;
+    
+    /**
+     * The symbols that are declared as entries, which are listed in the .ent file.
+     */
+    SymbolIndex entry_symbols;
+    
+    /**
+     * The fixups left by the first pass for the second pass, in the order of the lines they were left for.
+     */
+    Fixup *fixups;
+    
+    /**
+     * The number of fixups left by the first pass.
+     */
+    int fixup_count;
+    
+    /**
+     * The number of fixups that the allocated memory can hold.
      */
-    Set *faulty_instructions;
+    int fixup_capacity;
     
     /**
      * The file's data portion of the memory image.
@@ -55,23 +151,58 @@ typedef struct {
      */
     int ic;
     
+    /**
+     * The cache of the encodings of the instructions that do not refer to any symbol, which the first pass copies
+     * the words of repeated instructions from.
+     */
+    EncodingCache *encoding_cache;
+    
     /**
      * A boolean value that states whether a use of an external label as an operand was detected, which would mean that
      * a .ext file needs to be created.
      */
     unsigned extern_found : 1;
     
+    /**
+     * The number of threads that the passes over the file may split their work between.
+     */
+    int thread_count;
+    
 } Requirements; 
 
 /**
  * Creates a new instance of Requirements to be used for the assembly of one file.
  * 
+ * @param arena a pointer to an empty arena that the file's objects should be allocated from
  * @return a pointer to new Requirements, or NULL if memory for the Requirements structure could not be allocated
  */
-Requirements *create_requirements();
+Requirements *create_requirements(Arena *arena);
 
 /**
- * Frees a pointer to an instance of Requirements and all of its members.
+ * Creates the requirements for a chunk of a file's parsed lines, which a pass handles separately from the rest of the
+ * file. The chunk shares the file's parsed source, parsed lines and macro table, which are only read, and gets its own
+ * copy of the lines of the macros' contents, as well as its own symbol table, fixups, memory image and encoding cache.
+ * Should only be used if no allocation failure has occurred, and the result should only be used if none has
+ * occurred since.
+ * 
+ * @param requirements a pointer to the requirements of the file
+ * @param arena        a pointer to an empty arena that the chunk's objects should be allocated from
+ * @return a pointer to the chunk's requirements, or NULL if memory for the Requirements structure could not be
+ *         allocated
+ */
+Requirements *create_chunk_requirements(Requirements *requirements, Arena *arena);
+
+/**
+ * Frees the requirements of a chunk of a file, without freeing the members that it shares with the file's
+ * requirements. The chunk's arena is not reset, since the objects allocated from it may still be needed.
+ * 
+ * @param chunk a pointer to the chunk's requirements, which may be NULL
+ */
+void free_chunk_requirements(Requirements *chunk);
+
+/**
+ * Frees a pointer to an instance of Requirements and all of its members, and resets its arena so that everything
+ * allocated from it is released at once.
  * 
  * @param requirements a pointer to the requirements to be freed
  */
@@ -80,25 +211,82 @@ void free_requirements(Requirements *requirements);
 /**
  * Inserts a word into the Requirement's instruction array while advancing its instruction counter.
  * 
- * @param requirements     the requirements of the file
- * @param instruction      the word to be added, padded with a 0 on the left
- * @param line_count       the number of the line in the parsed file whose portion is being inserted to
- *                         the memory (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
+ * @param requirements    the requirements of the file
+ * @param instruction     the word to be added, padded with a 0 on the left
+ * @param line_count      the number of the line in the input file whose portion is being inserted to
+ *                        the memory (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
  * @return 0 if the insertion was successful, 1 otherwise
  */
-int memory_insert_instruction(Requirements *requirements, unsigned short instruction, int line_count, char *parsed_file_name);
+int memory_insert_instruction(Requirements *requirements, unsigned short instruction, int line_count, char *input_file_name);
 
 /**
  * Inserts a word into the Requirement's data array while advancing its data counter.
  * 
- * @param requirements     the requirements of the file
- * @param data             the word to be added, padded with a 0 on the left
- * @param line_count       the number of the line in the parsed file whose portion is being inserted to
- *                         the memory (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
+ * @param requirements    the requirements of the file
+ * @param data            the word to be added, padded with a 0 on the left
+ * @param line_count      the number of the line in the input file whose portion is being inserted to
+ *                        the memory (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
  * @return 0 if the insertion was successful, 1 otherwise
  */
-int memory_insert_data(Requirements *requirements, unsigned short data, int line_count, char *parsed_file_name);
+int memory_insert_data(Requirements *requirements, unsigned short data, int line_count, char *input_file_name);
+
+/**
+ * Returns the address of a symbol in the file's memory image.
+ * Should only be used once the first pass is over, since the address of a data symbol depends on the final
+ * instruction counter.
+ * 
+ * @param requirements the requirements of the file
+ * @param symbol       the symbol whose address should be returned
+ * @return the address of the symbol
+ */
+int get_symbol_address(Requirements *requirements, SymbolContent symbol);
+
+/**
+ * Adds a symbol to the end of a symbol index, and updates the length of the longest name in the index.
+ * 
+ * @param index  a pointer to the index that the symbol should be added to
+ * @param handle the handle of the symbol in the symbol table
+ * @param name   the name of the symbol
+ * @return 0 if the symbol was added successfully, 1 if an allocation failure has occurred
+ */
+int add_to_symbol_index(SymbolIndex *index, int handle, char *name);
+
+/**
+ * Adds an address to the end of an external symbol's appearances.
+ * 
+ * @param symbol  a pointer to the symbol in the symbol table
+ * @param address the address of the memory word in which the symbol appears
+ * @return 0 if the address was added successfully, 1 if an allocation failure has occurred
+ */
+int add_appearance(SymbolContent *symbol, int address);
+
+/**
+ * Adds a parsed line to the end of the Requirement's parsed lines.
+ * 
+ * @param requirements the requirements of the file
+ * @param line         the parsed line to be added
+ * @return 0 if the line was added successfully, 1 if an allocation failure has occurred
+ */
+int add_parsed_line(Requirements *requirements, ParsedLine line);
+
+/**
+ * Adds a line to the end of the Requirement's lines of the macros' contents.
+ * 
+ * @param requirements the requirements of the file
+ * @param line         the line to be added
+ * @return 0 if the line was added successfully, 1 if an allocation failure has occurred
+ */
+int add_macro_line(Requirements *requirements, MacroLine line);
+
+/**
+ * Adds a fixup to the end of the Requirement's fixups. The fixup's symbol should be allocated from the arena.
+ * 
+ * @param requirements the requirements of the file
+ * @param fixup        the fixup to be added
+ * @return 0 if the fixup was added successfully, 1 if an allocation failure has occurred
+ */
+int add_fixup(Requirements *requirements, Fixup fixup);
 
 #endif
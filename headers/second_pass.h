@@ -1,10 +1,13 @@
 /**
- * Includes the prototype for second_pass, which is responsible for encoding the operands of instructions,
- * updating symbols in the symbol table that are declared as .entry, and updating the list of appearances of external
- * symbols as operands. By the end of the second pass, the requirements of the file should be completely filled with
- * the information necessary to create the output files.
+ * Includes the prototype for second_pass, which is responsible for handling the fixups that the first pass left for
+ * everything that depends on symbols: encoding operands in the direct address method, updating symbols in the symbol
+ * table that are declared as .entry, and updating the list of appearances of external symbols as operands.
+ * By the end of the second pass, the requirements of the file should be completely filled with the information
+ * necessary to create the output files.
  * Assumes that a symbol can be defined as .entry more than once, since it doesn't not interfere with any
  * part of the assembly process.
+ * Once the first pass is over, the symbol table no longer changes, so the fixups of a large file may be split into
+ * chunks that are handled at the same time.
  */
 #ifndef SECOND_PASS_H
 #define SECOND_PASS_H
@@ -12,9 +15,10 @@
 #include "requirements.h"
 
 /**
- * Executes the second pass over the parsed .am file, which is responsible for encoding the operands of instructions,
- * updating symbols in the symbol table that are declared as .entry, and updating the list of appearances of external
- * symbols as operands.
+ * Executes the second pass over the fixups left by the first pass, which is responsible for encoding the operands
+ * in the direct address method, updating symbols in the symbol table that are declared as .entry, and updating the
+ * list of appearances of external symbols as operands. It also reports the errors of operands whose content was
+ * found to be invalid by the first pass.
  * 
  * @param file_name the extensionless file name
  * @param requirements a pointer to the requirements of the file
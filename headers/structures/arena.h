@@ -0,0 +1,68 @@
+/**
+ * Includes an arena data structure, which hands out memory for objects that live as long as the assembly of a file
+ * (such as the names of symbols and macros and list nodes) from large blocks, instead of allocating
+ * every object on its own. All of the objects are released at once by resetting the arena, which keeps its blocks so
+ * the assembly of the next file can reuse them.
+ * In addition, includes prototypes for functions that allow for interacting with arenas.
+ * All functions assume that the given pointer to an arena is not null.
+ */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "stddef.h"
+
+/**
+ * A block of memory that an arena hands out objects from. The objects are placed right after the block's header.
+ */
+typedef struct ArenaBlock {
+    /* the next block of the arena */
+    struct ArenaBlock *next;
+    /* the number of bytes that the block can hold, not including its header */
+    size_t size;
+    /* the number of bytes that have been handed out from the block */
+    size_t used;
+} ArenaBlock;
+
+/**
+ * An arena data structure, which consists of a chain of blocks. Objects are handed out from the current block, and
+ * once it is full, from the blocks after it.
+ */
+typedef struct {
+    /* the first block of the arena, or NULL if no block has been allocated yet */
+    ArenaBlock *first;
+    /* the block that objects are currently handed out from */
+    ArenaBlock *current;
+} Arena;
+
+/**
+ * Initializes a new, empty arena. No memory is allocated until the first object is requested.
+ *
+ * @param arena a pointer to the arena to be initialized
+ */
+void init_arena(Arena *arena);
+
+/**
+ * Allocates memory for an object from an arena. The memory is aligned for any type of object, and stays valid until
+ * the arena is reset or released.
+ *
+ * @param arena a pointer to the arena that the memory should be allocated from
+ * @param size  the number of bytes to be allocated
+ * @return a pointer to the allocated memory, or NULL if an allocation failure has occurred
+ */
+void *arena_allocate(Arena *arena, size_t size);
+
+/**
+ * Releases all of the objects allocated from an arena at once, while keeping its blocks so that they can be reused.
+ *
+ * @param arena a pointer to the arena to be reset
+ */
+void reset_arena(Arena *arena);
+
+/**
+ * Frees all of the blocks of an arena (and with them, all of the objects allocated from it) from the memory.
+ *
+ * @param arena a pointer to the arena to be released
+ */
+void release_arena(Arena *arena);
+
+#endif
@@ -1,8 +1,14 @@
 /**
- * Includes a hash-map data structure, which maps a string (name) to its content - either a macro or a symbol.
- * It is based on a hash-table which consists of linked-lists, whose nodes can hold either a macro content or
- * a symbol content, each associated with a certain name.
- * A hash-map should have a defined content type for all of its values in order to guarantee consistent freeing.
+ * Includes a hash-map data structure, which maps a string (name) to its content - either a macro, a symbol or an
+ * encoding.
+ * It is based on an open-addressing hash-table which grows as items are added, so looking up and adding an item takes
+ * constant time regardless of the number of items in the map. Each slot of the table holds the full hash-value of its
+ * name, the beginning of the name itself and the index of its item, and the items themselves are kept in the order
+ * in which they were added.
+ * The index of an item is also its handle - it never changes once the item is added, so it can be kept instead of the
+ * name and used to reach the item again without searching the map.
+ * A hash-map should have a defined content type for all of its values. The names and contents of its items are not
+ * owned by the map, and should be allocated from the arena of the file they belong to.
  * In addition, includes prototypes for functions that allow for interacting with hash-maps.
  * All functions assumes that the given pointer to a map is not null.
  */
@@ -13,19 +19,61 @@
 #include "stdarg.h"
 
 /**
- * The number of slots in the hash-table that the map is based on.
+ * An item in a hash-map - a name and the content associated with it.
  */
-#define MAP_HASH_TABLE_SIZE 101
+typedef struct {
+    char *name;
+    Content content;
+} MapItem;
 
 /**
- * A hash-map data structure, which maps a string (name) to its content - either a macro or a symbol.
- * It is based on a hash-table which consists of linked-lists, whose nodes can hold either a macro content or a symbol
- * content, each associated with a certain name.
+ * The number of characters of every name that are kept inline in its slot. A shorter name is kept whole, followed by
+ * zeros, so it is compared without reaching its item.
+ */
+#define MAP_INLINE_KEY_LENGTH 24
+
+/**
+ * A slot in the hash-table that a hash-map is based on. Holds the full hash-value of the name of the item it points
+ * to, so most mismatching names are skipped without being compared, and the beginning of the name, so a matching name
+ * is compared within the table.
  */
 typedef struct {
-    LinkedList *lists[MAP_HASH_TABLE_SIZE];
+    /* the hash-value of the item's name */
+    unsigned long hash;
+    /* the index of the item in the map's items, or -1 if the slot is empty */
+    int item;
+    /* the first MAP_INLINE_KEY_LENGTH characters of the item's name, padded with zeros if the name is shorter (not a
+     * C string, since a longer name leaves no room for a terminating zero) */
+    char key[MAP_INLINE_KEY_LENGTH];
+} MapSlot;
+
+/**
+ * A hash-map data structure, which maps a string (name) to its content - either a macro, a symbol or an encoding.
+ * It is based on an open-addressing hash-table (with linear probing) whose size is always a power of two, and which
+ * doubles in size whenever it becomes half full.
+ */
+typedef struct {
+    ContentType content_type;
+    /* the hash-table */
+    MapSlot *slots;
+    /* the number of slots in the hash-table */
+    int slot_count;
+    /* the map's items, in the order in which they were added */
+    MapItem *items;
+    /* the number of items in the map */
+    int item_count;
+    /* the number of items that the allocated memory can hold */
+    int item_capacity;
 } HashMap;
 
+/**
+ * Generates a hash-value for a given string, whose lowest bits are evenly spread even for similar strings.
+ * 
+ * @param  string the string to be hashed
+ * @return the hash-value for the given string
+ */
+unsigned long map_hash(char *string);
+
  /**
   * Creates a new, empty hash-map.
   * 
@@ -64,7 +112,45 @@ MacroContent *map_get_macro(HashMap *map, char *name);
 SymbolContent *map_get_symbol(HashMap *map, char *name);
 
 /**
- * Adds a macro with a given name to a hash-map.
+ * Looks for a name in a hash-map and returns the handle of the item with that name, if there is one.
+ * 
+ * @param map   a pointer to the hash-map to be searched
+ * @param name  the name to look for
+ * @return      the handle of the item with the given name, or -1 if the map has no item with the given name
+ */
+int map_find_handle(HashMap *map, char *name);
+
+/**
+ * Retrieves the symbol content of the item with a given handle, without searching the map.
+ * The pointer stays valid until the next item is added to the map.
+ * 
+ * @param map    a pointer to the hash-map that the symbol should be retrieved from
+ * @param handle the handle of the item, as returned when it was found or added
+ * @return       a pointer to the symbol content of the item
+ */
+SymbolContent *map_get_symbol_at(HashMap *map, int handle);
+
+/**
+ * Retrieves the encoding content of the item with a given handle, without searching the map.
+ * The pointer stays valid until the next item is added to the map.
+ * 
+ * @param map    a pointer to the hash-map that the encoding should be retrieved from
+ * @param handle the handle of the item, as returned when it was found or added
+ * @return       a pointer to the encoding content of the item
+ */
+EncodingContent *map_get_encoding_at(HashMap *map, int handle);
+
+/**
+ * Retrieves the name of the item with a given handle, without searching the map.
+ * 
+ * @param map    a pointer to the hash-map that the name should be retrieved from
+ * @param handle the handle of the item, as returned when it was found or added
+ * @return       the name of the item
+ */
+char *map_get_name_at(HashMap *map, int handle);
+
+/**
+ * Adds a macro with a given name to a hash-map. The name and the content should live as long as the map.
  * 
  * @param map           a pointer to the map that the macro should be added to
  * @param name          the name of the macro
@@ -73,42 +159,30 @@ SymbolContent *map_get_symbol(HashMap *map, char *name);
 void map_add_macro(HashMap *map, char *name, MacroContent macro_content);
 
 /**
- * Adds an symbol with a given name to a hash-map.
+ * Adds an symbol with a given name to a hash-map. The name should live as long as the map.
  * 
  * @param map            a pointer to the map that the symbol should be added to
  * @param name           the name of the symbol
  * @param symbol_content the content of the symbol to be added
+ * @return the handle of the new item, or -1 if an allocation failure has occurred
  */
-void map_add_symbol(HashMap *map, char *name, SymbolContent symbol_content);
-
-/**
- * Frees a hash-map and all of its contents from the memory.
- * 
- * @param map a pointer to the map that should be freed
- */
-void free_map(HashMap *map);
+int map_add_symbol(HashMap *map, char *name, SymbolContent symbol_content);
 
 /**
- * Adds a given integer to the value of every symbol in a hash-map that meets a given condition.
- * Assumes that that the content of every item in the map is a symbol.
+ * Adds an encoding with a given name to a hash-map. The name should live as long as the map.
  * 
- * @param map       a pointer to the hash map whose items' values should be changed
- * @param to_add    the integer to add to the values
- * @param condition a pointer to a function that accepts a symbol and returns 1 if it meets the wanted condition and 0
- *                  otherwise
+ * @param map              a pointer to the map that the encoding should be added to
+ * @param name             the name of the encoding
+ * @param encoding_content the content of the encoding to be added
+ * @return the handle of the new item, or -1 if an allocation failure has occurred
  */
-void map_add_to_all_that_apply(HashMap *map, int to_add, int (*condition)(SymbolContent symbol));
+int map_add_encoding(HashMap *map, char *name, EncodingContent encoding_content);
 
 /**
- * Adds every symbol in a hash-map that meets a given condition to a given linked-list.
- * Importantly, copies the symbols are added, rather then references to the same symbols.
- * Assumes every item in the map is a symbol and that the pointer to the list is not null.
+ * Frees a hash-map from the memory, without freeing the names and contents of its items.
  * 
- * @param map       the map whose symbols should be added to the list
- * @param list      the list that the symbols should be added to
- * @param condition a pointer to a function that accepts a symbol and returns 1 if it meets the wanted condition and 0
- *                  otherwise
+ * @param map a pointer to the map that should be freed, which may be NULL
  */
-void map_add_matching_to_list(HashMap *map, LinkedList *list, int (*condition)(SymbolContent symbol));
+void free_map(HashMap *map);
 
 #endif
@@ -1,6 +1,6 @@
 /**
- * Includes a linked-list data structure, which consists of nodes that can hold either a macro content, a symbol content
- * or an integer, each associated with a certain name.
+ * Includes a linked-list data structure, which consists of nodes that can hold either a macro content, a symbol content,
+ * an encoding content or an integer, each associated with a certain name.
  * Items containing integers are treated as having no name, since the integer itself represents the item at every
  * use case in the project.
  * In addition, includes prototype for functions that allow for interacting with linked-lists.
@@ -11,23 +11,44 @@
 
 #include "../fields.h"
 #include "../symbols.h"
+#include "../conversions.h"
+#include "arena.h"
 
 /**
- * Represents a macro's content, which is effectively one string.
+ * Represents a macro's content - the range of its lines in the lines of the macros' contents (see MacroLine).
  */
-typedef char *MacroContent;
+typedef struct {
+    /* the index of the content's first line in the lines of the macros' contents */
+    int first_index;
+    /* the number of lines in the content */
+    int line_count;
+    /* the number of the line in the input file in which the macro's definition starts */
+    int definition_line;
+} MacroContent;
 
 /**
- * Represents the content of an item in a linked list - either a macro content, a symbol content or an integer.
+ * Represents an encoding content - the memory words of an instruction (see EncodingCache).
+ */
+typedef struct {
+    /* the number of the instruction's memory words */
+    unsigned char word_count;
+    /* the instruction's memory words, starting from its first word */
+    unsigned short words[MAX_INSTRUCTION_WORDS];
+} EncodingContent;
+
+/**
+ * Represents the content of an item in a linked list - either a macro content, a symbol content, an encoding content
+ * or an integer.
  */
 typedef union {
     MacroContent macro;
     SymbolContent symbol;
+    EncodingContent encoding;
     int num;
 } Content;
 
 typedef enum {
-    INTEGER, SYMBOL, MACRO
+    INTEGER, SYMBOL, MACRO, ENCODING
 } ContentType;
 
 /**
@@ -41,20 +62,24 @@ typedef struct Node {
 } Node;
 
 /**
- * Represents a linked-list data structure. Includes a pointer to the first item on the list.
+ * Represents a linked-list data structure. Includes a pointer to the first item on the list, and the arena that the
+ * list and its nodes are allocated from (or NULL if they are allocated on the heap).
  */
 typedef struct LinkedList {
     Node *head;
     ContentType content_type;
+    Arena *arena;
 } LinkedList;
 
 /**
  * Creates a new, empty linked-list.
  * 
  * @param content_type the type that the list's items' content should be
+ * @param arena        a pointer to the arena that the list and its nodes should be allocated from, or NULL if they
+ *                     should be allocated on the heap
  * @return a pointer to the new list, or NULL if an allocation failure has occurred
  */
-LinkedList *create_list(ContentType content_type);
+LinkedList *create_list(ContentType content_type, Arena *arena);
 
 /**
  * Checks if a linked-list is empty.
@@ -147,32 +172,14 @@ void list_add_symbol(LinkedList *list, char *name, SymbolContent symbol_content)
  */
 void list_add_int(LinkedList *list, int num);
 
-/**
- * Frees a linked-list and all of its items' names and contents from the memory.
- * Assumes that all of the list's contents are of the same type.
- * 
- * @param list a pointer to the list that should be freed
- */
-void deep_free_list(LinkedList *list);
-
 /**
  * Frees a linked-list and its nodes from the memory, without freeing the nodes' names and contents.
+ * A list allocated from an arena is left as is, since it is released along with the arena.
  * 
  * @param list a pointer to the list that should be freed
  */
 void shallow_free_list(LinkedList *list);
 
-/**
- * Adds a given integer to the value of every symbol in a hash-linked-list that meets a given condition.
- * Assumes that that the content of every item in the list is a symbol.
- * 
- * @param list      a pointer to the list whose items' values should be changed
- * @param to_add    the integer to add to the values
- * @param condition a pointer to a function that accepts a symbol and returns 1 if it meets the wanted condition and 0
- *                  otherwise
- */
-void list_add_to_all_that_apply(LinkedList *list, int to_add, int (*condition)(SymbolContent symbol));
-
 /**
  * Adds every symbol in a given linked-list that meets a given condition to another given linked-list.
  * Importantly, copies of the symbols are added, rather then references to the same symbols, and copies of the pointers
@@ -186,14 +193,5 @@ void list_add_to_all_that_apply(LinkedList *list, int to_add, int (*condition)(S
  */
 void list_add_matching_to_list(LinkedList *list1, LinkedList *list2, int (*condition)(SymbolContent symbol));
 
-/**
- * Gets the length of the longest name of any item in a linked-list.
- * Assumes the list is not empty.
- * 
- * @param list a pointer to the list to be checked
- * @return the longest name of an item in the list
- */
-int get_max_name_length(LinkedList *list);
-
 
 #endif
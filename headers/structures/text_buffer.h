@@ -0,0 +1,74 @@
+/**
+ * Includes a text-buffer data structure, which holds a growing string in the memory. It is used to keep the parsed,
+ * macro-less source of a file in the memory, so the passes can read it without going through the .am file.
+ * In addition, includes prototypes for functions that allow for interacting with text-buffers.
+ * All functions assume that the given pointer to a buffer is not null.
+ */
+#ifndef TEXT_BUFFER_H
+#define TEXT_BUFFER_H
+
+/**
+ * A text-buffer data structure, which holds a string that can be appended to. The string always ends with
+ * a terminating 0.
+ */
+typedef struct {
+    /* the characters of the text, followed by a terminating 0 */
+    char *text;
+    /* the number of characters in the text, not including the terminating 0 */
+    int length;
+    /* the number of characters that the allocated memory can hold, including the terminating 0 */
+    int capacity;
+} TextBuffer;
+
+/**
+ * Creates a new, empty text-buffer.
+ *
+ * @return a pointer to the new buffer, or NULL if an allocation failure has occurred
+ */
+TextBuffer *create_text_buffer();
+
+/**
+ * Appends a string to the end of a text-buffer.
+ *
+ * @param buffer a pointer to the buffer that the string should be appended to
+ * @param string the string to be appended
+ */
+void text_buffer_append(TextBuffer *buffer, char *string);
+
+/**
+ * Appends a given number of characters to the end of a text-buffer. The characters don't need to be followed by a
+ * terminating 0.
+ *
+ * @param buffer     a pointer to the buffer that the characters should be appended to
+ * @param characters a pointer to the first character to be appended
+ * @param length     the number of characters to be appended
+ */
+void text_buffer_append_characters(TextBuffer *buffer, char *characters, int length);
+
+/**
+ * Appends a line to the end of a text-buffer, followed by a line break.
+ *
+ * @param buffer a pointer to the buffer that the line should be appended to
+ * @param line   the line to be appended, without a line break
+ */
+void text_buffer_append_line(TextBuffer *buffer, char *line);
+
+/**
+ * Reads a line from a text-buffer into a given character array, and advances a given position to the start of the
+ * next line. If the line is longer than the given maximum length, only its beginning is copied.
+ *
+ * @param buffer     a pointer to the buffer that should be read from
+ * @param position   a pointer to the index in the buffer's text in which the line starts
+ * @param max_length the maximum number of characters that should be copied to the array
+ * @param s          an array that should contain the output, which can hold at least max_length + 1 characters
+ */
+void text_buffer_read_line(TextBuffer *buffer, int *position, int max_length, char s[]);
+
+/**
+ * Frees a text-buffer and its text from the memory.
+ *
+ * @param buffer a pointer to the buffer that should be freed
+ */
+void free_text_buffer(TextBuffer *buffer);
+
+#endif
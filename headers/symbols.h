@@ -21,21 +21,32 @@ typedef enum SymbolType {
 } SymbolType;
 
 /**
- * Represents a list of an external symbol's appearances in a file.
- * 
- * The additional typedef is used to avoid issues of types being not yet defined when used in structs.
+ * Represents the appearances of an external symbol in a file - the addresses of the memory words in which it appears,
+ * kept in a growable array. Since the operands are filled in the order of their lines, the addresses are added (and
+ * therefore kept) in increasing order.
  */
-typedef struct LinkedList AppearancesList;
+typedef struct Appearances {
+    /* the addresses, or NULL if the symbol has not appeared yet */
+    int *addresses;
+    /* the number of addresses in the array */
+    int count;
+    /* the number of addresses that the allocated memory can hold */
+    int capacity;
+} Appearances;
 
 /**
- * Represents a symbol's content - its value, location, type, and list of appearances (only used for external symbols).
+ * Represents a symbol's content - its value, location, type, and appearances (only used for external symbols).
  */
 typedef struct SymbolContent {
+    /* the symbol's address, relative to the start of its portion of the memory image if it is a data symbol */
     int value;
     SymbolLocation location;
     SymbolType type;
-    /* a list of addresses of memory words in which the symbol appears - only used for external symbols */
-    AppearancesList *appearances;
+    /* whether the symbol is defined (or declared as external) - a symbol that has only been referenced so far is in the
+     * symbol table so that it has a handle, but is not defined */
+    unsigned defined : 1;
+    /* the addresses of memory words in which the symbol appears - only used for external symbols */
+    Appearances appearances;
 } SymbolContent;
 
 #endif 
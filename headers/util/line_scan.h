@@ -0,0 +1,19 @@
+/**
+ * Includes a prototype for the function that finds line breaks in text that is held in the memory.
+ * The search uses the widest vector instructions that the processor supports (AVX2 or SSE2), which are chosen once at
+ * runtime, and falls back to checking one character at a time on other processors.
+ */
+#ifndef LINE_SCAN_H
+#define LINE_SCAN_H
+
+/**
+ * Finds the first line break in a given range of characters.
+ * Never reads characters outside of the range, so it can be used on text that doesn't end with a terminating 0.
+ * 
+ * @param start a pointer to the first character in the range
+ * @param end   a pointer to the character immediately after the range
+ * @return a pointer to the first line break in the range, or end if there is no line break in it
+ */
+char *find_line_break(char *start, char *end);
+
+#endif
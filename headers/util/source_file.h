@@ -0,0 +1,67 @@
+/**
+ * Includes a source-file structure, which gives access to the contents of an input file by mapping the entire file
+ * into the memory, and prototypes for functions that read it line by line.
+ * All functions assume that the given pointer to a source-file is not null.
+ */
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+/**
+ * A source-file structure, which holds the contents of an input file and the position of the next line to be read.
+ */
+typedef struct {
+    /* the contents of the file (not followed by a terminating 0) */
+    char *text;
+    /* the number of characters in the file */
+    long length;
+    /* the index in the text in which the next line starts, or length + 1 if the last line has been read */
+    long position;
+    /* whether the text is mapped from the file, rather than copied into allocated memory */
+    int mapped;
+} SourceFile;
+
+/**
+ * Opens a source-file with a given name and maps its contents into the memory.
+ * 
+ * @param file_name the name of the file, including its extension
+ * @return a pointer to the source-file, or NULL if the file could not be opened or an allocation failure has occurred
+ */
+SourceFile *open_source_file(char *file_name);
+
+/**
+ * Checks if every line of a source-file has been read. Like a file that is read with getc, a source-file whose last
+ * character is a line break has another, empty line after it.
+ * 
+ * @param source a pointer to the source-file
+ * @return 1 if every line has been read, 0 otherwise
+ */
+int source_ended(SourceFile *source);
+
+/**
+ * Asks the system to start loading the contents of a source-file into the memory in the background, so they are
+ * ready by the time the file is read.
+ * 
+ * @param source a pointer to the source-file
+ */
+void prefetch_source_file(SourceFile *source);
+
+/**
+ * Reads the next line from a source-file into a given character array as long as it is at most 80 characters long.
+ * If the line is longer, copies only its beginning and reports an error.
+ * 
+ * @param source      a pointer to the source-file
+ * @param file_name   the name of the file (used for error reporting)
+ * @param line_number the number of the line being read (used for error reporting)
+ * @param s           an array that should contain the output
+ * @return 0 if the line was read successfully, 1 otherwise
+ */
+int source_read_line(SourceFile *source, char *file_name, int line_number, char s[]);
+
+/**
+ * Closes a source-file and frees it from the memory.
+ * 
+ * @param source a pointer to the source-file that should be closed
+ */
+void close_source_file(SourceFile *source);
+
+#endif
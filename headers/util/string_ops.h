@@ -6,6 +6,7 @@
 #define STRING_OPS_H
 
 #include "stdlib.h"
+#include "../structures/arena.h"
 
 /**
  * Checks if two strings are identical.
@@ -26,23 +27,66 @@ int equal(char *s1, char *s2);
 int exists(char *string, char c);
 
 /**
- * Returns the first maximum substring of a given string that doesn't include any of the given separators.
+ * A view of a part of a string - a pointer to the part's first character and the number of characters in it.
+ * A view doesn't own the characters it points to and isn't followed by a terminating 0, so finding and trimming
+ * tokens with views never allocates memory.
+ */
+typedef struct {
+    /* the first character of the part */
+    char *start;
+    /* the number of characters in the part */
+    int length;
+} StringView;
+
+/**
+ * Returns a view of an entire string.
+ * 
+ * @param string the string to be viewed
+ * @return a view of all the characters of the string
+ */
+StringView view_of(char *string);
+
+/**
+ * Returns a view of the first maximum substring of a given string that doesn't include any of the given separators.
  * For example, if the function would be called with a string parameter of "  x Hello  xx World   " and a separators
- * parameter of " x", the string "Hello" would be returned.
- * If there is no such substring, returns an empty string.
- * Returns the output as a new string that has been allocated on the heap.
- * Places the pointer to the character immediately after the token as the value of rest.
- * Does not assume that the string is not null.
+ * parameter of " x", a view of "Hello" would be returned.
+ * If there is no such substring, returns an empty view.
+ * Places the pointer to the character immediately after the token as the value of rest, or the pointer to the
+ * string's terminating 0 if there is no token.
  * 
  * @param string     the string whose first token should be found
  * @param separators a string made of the characters that the token should be split by
  * @param rest       a pointer to a string whose value will be changed to the string that starts immediately after 
  *                   the token (as a pointer to the character in the original string, not as a new string)
- * @return a new string with the first maximum substring of a given string that doesn't include any of the
- *         given separators - essentially the first token when splitting by the separators, an empty string if no
- *         such substring exists, or null if string is null or an allocation failure has occurred
+ * @return a view of the first token when splitting by the separators, or an empty view if no such token exists
+ */
+StringView next_token(char *string, char *separators, char **rest);
+
+/**
+ * Returns a view of the same characters as a given view, without any heading spaces or tabs and trailing whitespaces.
+ * 
+ * @param view the view which should be trimmed
+ * @return the trimmed view
  */
-char *find_token(char *string, char *separators, char **rest);
+StringView trim_view(StringView view);
+
+/**
+ * Copies the characters of a view into a given array, followed by a terminating 0.
+ * 
+ * @param view   the view to be copied
+ * @param buffer an array which can hold at least the view's length plus one characters
+ */
+void view_copy(StringView view, char buffer[]);
+
+/**
+ * Creates a new string (allocated from an arena) with the characters of a given view. Should only be used for strings
+ * that outlive the line they were found in, such as the names of symbols and macros.
+ * 
+ * @param view  the view to be copied
+ * @param arena a pointer to the arena that the string should be allocated from
+ * @return the new string, or null if an allocation failure has occurred
+ */
+char *view_duplicate(StringView view, Arena *arena);
 
 /**
  * Checks if a string is made of only whitespace characters, or if it is empty.
@@ -52,14 +96,6 @@ char *find_token(char *string, char *separators, char **rest);
  */
 char is_line_blank(char *string);
 
-/**
-* Removes any heading and trailing spaces or tabs from a string.
- * 
-* @param string a string which should be trimmed
-* @return a new, trimmed version of the original string, or null if an allocation failure has occurred
-*/
-char *trim(char string[]);
-
 /**
  * Checks if a given string represents an integer (that may start with one + or -).
  * Assumes the string is not empty.
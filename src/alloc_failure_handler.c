@@ -1,28 +1,76 @@
 /**
  * This file acts as an allocation failure handler, and includes a flag that indicates whether an allocation failure has
  * occurred, as well as functions that allow for interacting with the flag.
+ * Each thread may bind the handler to a flag of its own (the flag of the assembly it is working on) using a
+ * thread-specific key. Threads that did not bind a flag use a single process-wide flag.
  */
 
+#include "../headers/alloc_failure_handler.h"
+#include "pthread.h"
+#include "stdlib.h"
+
 /**
- * A global flag which indicates whether an allocation failure has occurred - starts off as 0 and
- * changes to 1 if necessary.
+ * A process-wide flag which indicates whether an allocation failure has occurred - starts off as 0 and
+ * changes to 1 if necessary. Used by threads that are not bound to the flag of a specific assembly.
  */
 static unsigned allocation_failure = 0;
 
+/**
+ * The key through which each thread finds the flag it is bound to.
+ */
+static pthread_key_t flag_key;
+
+/**
+ * Makes sure the key is created exactly once.
+ */
+static pthread_once_t flag_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Creates the thread-specific key that holds the flag each thread is bound to.
+ */
+static void create_flag_key() {
+    pthread_key_create(&flag_key, NULL);
+}
+
+/**
+ * Returns the flag that the calling thread is bound to.
+ * Does so by getting the thread-specific value of the key, and falling back to the process-wide flag if the thread has
+ * not been bound to a flag.
+ *
+ * @return a pointer to the flag of the calling thread
+ */
+static unsigned *current_flag() {
+    unsigned *flag;
+    pthread_once(&flag_key_once, create_flag_key);
+    flag = pthread_getspecific(flag_key);
+    return flag == NULL ? &allocation_failure : flag;
+}
+
+/**
+ * Binds the handler of the calling thread to a given flag, which belongs to the assembly that the thread is working on.
+ * Does so by setting the thread-specific value of the key to the given flag.
+ *
+ * @param flag a pointer to the flag of the current assembly, or NULL to go back to the process-wide flag
+ */
+void bind_alloc_failure_flag(unsigned *flag) {
+    pthread_once(&flag_key_once, create_flag_key);
+    pthread_setspecific(flag_key, flag);
+}
+
 /**
  * Notifies the handler that a memory allocation failure has occurred.
- * Does so by setting the allocation_failure flag on.
+ * Does so by setting the flag that the calling thread is bound to on.
  */
 void set_alloc_failure() {
-    allocation_failure = 1;
+    *current_flag() = 1;
 }
 
 /**
- * Returns whether a memory allocation failure has occurred. 
- * Does so by getting the value of the allocation_failure flag.
- * 
+ * Returns whether a memory allocation failure has occurred.
+ * Does so by getting the value of the flag that the calling thread is bound to.
+ *
  * @return 1 if an allocation failure has occurred, 0 otherwise
  */
 unsigned is_alloc_failure() {
-    return allocation_failure;
+    return *current_flag();
 }
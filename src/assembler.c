@@ -2,15 +2,17 @@
  * This is the main file for an assembler program, which converts a text-base assembly program given in a .as file to
  * machine code which resides in a newly-created .ob file, as well as additional files that are explained later.
  * 
- * The first stage is pre-assembly, which creates a parsed .am file out of the given .as file. The pre-assembly process
- * is responsible for parsing every macro in the .as file, such that the .am file is macro-less.
- * The second stage is a double-pass assembly - the assembler goes over  the .am file twice, and translates it to
- * machine code which is kept in the file's requirements structure. The first pass is responsible for encoding the first
- * word of each instruction and .data and .string directives, as well as giving a value to every symbol. The second pass
- * is responsible for the encoding of operands, as well as listing entry symbols and uses of external symbols.
+ * The first stage is pre-assembly, which creates a parsed source out of the given .as file and keeps it in the memory.
+ * The pre-assembly process is responsible for parsing every macro in the .as file, such that the parsed source is
+ * macro-less.
+ * The second stage is a double-pass assembly, which translates the parsed source to machine code which is kept in the
+ * file's requirements structure. The first pass reads the parsed source once, and is responsible for encoding every
+ * instruction and .data and .string directives, as well as giving a value to every symbol. Whatever depends on symbols
+ * that might be defined later is left as a fixup. The second pass goes over the fixups instead of the source, and is
+ * responsible for the encoding of symbol operands, as well as listing entry symbols and uses of external symbols.
  * Finally, the output files are created based on the encoding that resides in the requirements.
  * 
- * If the assembler identifies an input error in the pre-assembly stage, it will not create the .am file, won't
+ * If the assembler identifies an input error in the pre-assembly stage, it will not create any output file, won't
  * perform the assembly stage, and start the process for the next file. If it identifies an error in the first or second
  * pass stage, the output files will not be created and the assembly process will start for the next file.
  * 
@@ -20,10 +22,28 @@
  * The input for the program is a list of extensionless file names, each corresponding to a .as file. The extensionless
  * file names are given as command line arguments. The output for the program includes several output files for each
  * input files, each with the same name is the input file but a different extension:
- * 1. A .am file, which is the same as the .as file but all the macros are parsed.
+ * 1. A .am file, which is the same as the .as file but all the macros are parsed. It is only created if the --emit-am
+ *    option is given, since the parsed source is otherwise only needed in the memory.
  * 2. A .ob file, which includes the machine code.
  * 3. A .ext file, which includes a list of external symbols and the addresses in which they are used.
  * 4. A .ent file, which includes a list of entry symbols defined in the input file and their values.
+ * 
+ * The files are assembled one by one, unless the -j option is given with a number N (for example "-j 4"), in which case
+ * up to N files are assembled at the same time by a pool of worker threads. The messages of every file are then
+ * buffered and printed in the order in which the files were given, so the output is the same as in a one-by-one
+ * assembly.
+ * 
+ * When several files are assembled one by one, they go through a pipeline of three stages that run at the same time:
+ * the input file of the next files is opened and read ahead, the current file is assembled, and the output files of
+ * the previous files are written. The messages of every file are then printed in order once its output files are
+ * written, so the output is the same as in a one-by-one assembly.
+ * 
+ * In addition, if the -t option is given with a number N, the passes over every file may split their work between up
+ * to N threads. The work is only split where the result (including the messages) is the same as in a single run over
+ * the file.
+ * 
+ * If the --cache-stats option is given, the number of instructions of every file that were copied from the encoding
+ * cache (hits) and that had to be encoded (misses) is printed once its first pass is over.
  */
 
 #include "stdio.h"
@@ -34,130 +54,794 @@
 #include "../headers/output_creator.h"
 #include "../headers/exit_codes.h"
 #include "../headers/alloc_failure_handler.h"
+#include "../headers/console.h"
 #include "stdlib.h"
+#include "string.h"
+#include "pthread.h"
+#include "../headers/util/string_ops.h"
+#include "../headers/util/source_file.h"
 
 /**
- * Executes the entire assembly process for a file.
+ * The option that sets the number of files that may be assembled at the same time.
+ */
+#define JOBS_OPTION "-j"
+
+/**
+ * The option that sets the number of threads that the passes over every file may split their work between.
+ */
+#define THREADS_OPTION "-t"
+
+/**
+ * The option that asks for the parsed source of every file to be written into a .am file.
+ */
+#define EMIT_AM_OPTION "--emit-am"
+
+/**
+ * The option that asks for the hits and misses of the encoding cache of every file to be printed.
+ */
+#define CACHE_STATS_OPTION "--cache-stats"
+
+/**
+ * The number of jobs per worker thread whose messages may be buffered at the same time, when files are assembled at
+ * the same time. Once that many jobs are waiting for their messages to be printed, no more jobs are taken.
+ */
+#define BUFFERED_JOBS_PER_WORKER 2
+
+/**
+ * The number of files whose input files may be opened and read ahead of the file being assembled, when files are
+ * assembled in a pipeline.
+ */
+#define READ_AHEAD 2
+
+/**
+ * The number of assembled files whose output files may still be waiting to be written while the next file is
+ * assembled, when files are assembled in a pipeline.
+ */
+#define WRITE_BEHIND 2
+
+/**
+ * The number of arenas that the assemblies of a pipeline allocate from - one for the file being assembled, and one for
+ * every file whose output files may still be waiting to be written.
+ */
+#define PIPELINE_ARENA_COUNT (WRITE_BEHIND + 1)
+
+/**
+ * Represents the assembly of one file given as a command line argument.
+ */
+typedef struct {
+    /* the name of the file to be assembled without the extension */
+    char *file_name;
+    /* whether the parsed source of the file should be written into a .am file */
+    int emit_parsed_file;
+    /* whether the hits and misses of the file's encoding cache should be printed */
+    int print_cache_stats;
+    /* the number of threads that the passes over the file may split their work between */
+    int thread_count;
+    /* the input file, if it was opened ahead of the assembly, or NULL */
+    SourceFile *input_file;
+    /* the requirements of the assembled file, while its output files are waiting to be written, or NULL */
+    Requirements *requirements;
+    /* the stream that the assembly's messages are written to, or NULL for the standard output */
+    FILE *output;
+    /* the assembly's allocation failure flag */
+    unsigned alloc_failure;
+    /* the result of the assembly - SUCCESS, ASSEMBLY_FAILURE or MEMORY_ALLOCATION_FAILURE */
+    int result;
+    /* whether the assembly has finished */
+    int done;
+} AssemblyJob;
+
+/**
+ * The state that is shared by the worker threads that assemble files at the same time.
+ */
+typedef struct {
+    /* the list of jobs, in the order in which the files were given */
+    AssemblyJob *jobs;
+    int job_count;
+    /* the index of the next job that should be taken by a worker */
+    int next_job;
+    /* the number of jobs whose messages were printed */
+    int flushed_count;
+    /* the number of jobs that may be taken but not yet have their messages printed */
+    int buffer_limit;
+    /* whether a memory allocation failure has occurred, in which case no more jobs are taken */
+    int stopped;
+    /* whether the messages of no more jobs will be printed */
+    int flushing_over;
+    /* protects the fields above and the done and result fields of the jobs */
+    pthread_mutex_t lock;
+    /* signaled whenever a job is done or its messages are printed */
+    pthread_cond_t progress;
+} WorkerPool;
+
+/**
+ * The state that is shared by the stages of a pipeline, which assembles the files one by one while the input files of
+ * the next files are read by a reader thread and the output files of the previous files are written by a writer
+ * thread. The jobs pass from stage to stage in order, so each stage is represented by the number of jobs that it has
+ * finished. The stages wait for each other so that the reader is at most READ_AHEAD jobs ahead of the assembly, and
+ * the assembly is at most WRITE_BEHIND jobs ahead of the writer.
+ */
+typedef struct {
+    /* the list of jobs, in the order in which the files were given */
+    AssemblyJob *jobs;
+    int job_count;
+    /* the number of jobs whose input files were opened by the reader */
+    int read_count;
+    /* the number of jobs that were assembled */
+    int assembled_count;
+    /* the number of jobs whose output files were written and whose messages were printed by the writer */
+    int written_count;
+    /* whether the assembly is over, so no more jobs will be assembled */
+    int assembly_over;
+    /* whether a memory allocation failure has occurred, in which case no more jobs are read or assembled */
+    int stopped;
+    /* the arenas that the assemblies allocate from - every job allocates from the arena at its index modulo their
+     * number, which is reset once the job's output files are written */
+    Arena arenas[PIPELINE_ARENA_COUNT];
+    /* protects the fields above and the input_file, requirements and result fields of the jobs */
+    pthread_mutex_t lock;
+    /* signaled whenever a stage finishes a job */
+    pthread_cond_t progress;
+} Pipeline;
+
+/**
+ * Executes the assembly process for a file, up to the creation of its output files.
  * 
  * Does so by first creating the file's requirements, then pre-assembling the file.
- * Then, assembles it by going over it twice and filling the requirements.
- * Finally, creates the output files using the requirements.
+ * Then, assembles it by going over it twice and filling the requirements, which are kept for the creation of the
+ * output files if no error was found. Otherwise, frees the requirements, which resets the arena, so it is empty
+ * again once the function returns.
  * 
- * @param file_name the name of the file to be assembled without the extension
- * @return 1 if an error has occurred, 0 otherwise
+ * @param job          a pointer to the job of the file - its name, its options and its input file if it was opened
+ *                     ahead of the assembly (which is closed once it is read)
+ * @param arena        a pointer to an empty arena that the file's objects should be allocated from
+ * @param assembled    a pointer to a variable that should hold the requirements of the file, if it was assembled
+ *                     successfully
+ * @return SUCCESS if the file was assembled successfully, ASSEMBLY_FAILURE if an error was found in it, or
+ *         MEMORY_ALLOCATION_FAILURE if a memory allocation failure occurred, in which case the program should stop
  */
-static int assemble(char file_name[]) {
+static int assemble(AssemblyJob *job, Arena *arena, Requirements **assembled) {
     
     /* whether an assembly failure has occurred */
     int failure;
+    char *file_name = job->file_name;
+    SourceFile *input_file = job->input_file;
     
-    /* creates the file's requirements, exits if a memory allocation error has occurred */
-    Requirements *requirements = create_requirements();
-    if (is_alloc_failure()) {
-        free_requirements(requirements);
-        exit(MEMORY_ALLOCATION_FAILURE);
+    /* creates the file's requirements, stops if a memory allocation error has occurred */
+    Requirements *requirements = create_requirements(arena);
+    job->input_file = NULL;
+    if (requirements == NULL || is_alloc_failure()) {
+        if (input_file != NULL) close_source_file(input_file);
+        if (requirements != NULL) free_requirements(requirements);
+        return MEMORY_ALLOCATION_FAILURE;
     }
+    requirements->thread_count = job->thread_count;
     
     /* removes any existing output files for the given file */
-    remove_output_files(file_name);
+    remove_output_files(file_name, arena);
     
     /* pre-assembles the file and updates the failure flag */
-    failure = pre_assemble(file_name, requirements);
+    failure = pre_assemble(file_name, input_file, requirements, job->emit_parsed_file);
     
-    /* if a memory allocation error has occurred, exits the program */
+    /* if a memory allocation error has occurred, stops so that the program can exit */
     if (is_alloc_failure()) {
         free_requirements(requirements);
-        exit(MEMORY_ALLOCATION_FAILURE);
+        return MEMORY_ALLOCATION_FAILURE;
     }
     
     /* if the pre-assembly has been completed successfully, moves to the next stage */
-    if (!failure) printf("%s: Pre-assembly completed successfully\n", file_name);
+    if (!failure) console_printf("%s: Pre-assembly completed successfully\n", file_name);
     
     /* if a non-memory related error has occurred in the pre-assembly, stops the assembly of this file */
     else {
         free_requirements(requirements);
-        return 1;
+        return ASSEMBLY_FAILURE;
     }
     
-    /* executes the first pass over the macro-less .am file. before this, failure is necessarily 0 */
+    /* executes the first pass over the macro-less parsed source. before this, failure is necessarily 0 */
     failure = first_pass(file_name, requirements);
 
-    /* if a memory allocation error has occurred, exits the program */
+    /* if a memory allocation error has occurred, stops so that the program can exit */
     if (is_alloc_failure()) {
         free_requirements(requirements);
-        exit(MEMORY_ALLOCATION_FAILURE);
+        return MEMORY_ALLOCATION_FAILURE;
     }
     
     /* notifies the user about a first-pass success */
-    if (!failure) printf("%s: First pass completed successfully\n", file_name);
+    if (!failure) console_printf("%s: First pass completed successfully\n", file_name);
+    
+    /* prints the hits and misses of the encoding cache if they were asked for */
+    if (job->print_cache_stats) {
+        console_printf("%s: Encoding cache - %ld hits, %ld misses\n", file_name,
+                       requirements->encoding_cache->hits, requirements->encoding_cache->misses);
+    }
     
     /* executes the second pass even if the first pass failed in order to find errors */
     failure |= second_pass(file_name, requirements);
 
-    /* if a memory allocation error has occurred, exits the program */
+    /* if a memory allocation error has occurred, stops so that the program can exit */
     if (is_alloc_failure()) {
         free_requirements(requirements);
-        exit(MEMORY_ALLOCATION_FAILURE);
+        return MEMORY_ALLOCATION_FAILURE;
     }
 
     /* if the first and second pass have been completed successfully, moves to the next stage */
-    if (!failure) printf("%s: Second pass completed successfully\n", file_name);
+    if (!failure) console_printf("%s: Second pass completed successfully\n", file_name);
     
     /* if a non-memory related error has occurred during the first or second pass, stops the assembly of this file */
     else {
         free_requirements(requirements);
-        return 1;
+        return ASSEMBLY_FAILURE;
     }
     
+    *assembled = requirements;
+    return SUCCESS;
+}
+
+/**
+ * Creates the output files of an assembled file using its requirements, and then frees the requirements, which
+ * resets the arena that they were allocated from.
+ * 
+ * @param file_name    the name of the file without the extension
+ * @param requirements a pointer to the requirements of the file
+ * @return SUCCESS if the output files were created successfully, ASSEMBLY_FAILURE if they could not be created, or
+ *         MEMORY_ALLOCATION_FAILURE if a memory allocation failure occurred, in which case the program should stop
+ */
+static int write_output_files(char file_name[], Requirements *requirements) {
+    
+    /* whether a failure has occurred */
+    int failure;
+    
     /* creates the output files */
     failure = create_files(file_name, requirements);
 
-    /* if a memory allocation error has occurred, exits the program */
+    /* if a memory allocation error has occurred, stops so that the program can exit */
     if (is_alloc_failure()) {
         free_requirements(requirements);
-        exit(MEMORY_ALLOCATION_FAILURE);
+        return MEMORY_ALLOCATION_FAILURE;
     }
 
     /* if the file creation was completed successfully, notifies the user and moves to the end of the function */
-    if (!failure) printf("%s: Output files creation completed successfully\n", file_name);
+    if (!failure) console_printf("%s: Output files creation completed successfully\n", file_name);
     
     /* if a non-memory related error has occurred during the file creation, stops the assembly of this file */
     else {
         free_requirements(requirements);
-        return 1;
+        return ASSEMBLY_FAILURE;
     }
     
     free_requirements(requirements);
-    return 0;
+    return SUCCESS;
+}
+
+/**
+ * Runs the assembly of a single job on the calling thread.
+ * Does so by binding the thread's console and allocation failure handler to the job, assembling the job's file, and
+ * printing a line break to make a distinction between messages from different files.
+ *
+ * @param job   a pointer to the job to be run
+ * @param arena a pointer to the arena that the assembly should allocate from
+ */
+static void run_job(AssemblyJob *job, Arena *arena) {
+    Requirements *requirements;
+    bind_console(job->output);
+    bind_alloc_failure_flag(&job->alloc_failure);
+    job->result = assemble(job, arena, &requirements);
+    if (job->result == SUCCESS) job->result = write_output_files(job->file_name, requirements);
+    /* a memory allocation failure ends the program right after the file's messages */
+    if (job->result != MEMORY_ALLOCATION_FAILURE) console_printf("\n");
+    bind_alloc_failure_flag(NULL);
+    bind_console(NULL);
+}
+
+/**
+ * Takes the next job that should be run from a worker pool, and prepares it to be run.
+ * Does so by waiting until the messages of the job may be buffered without going over the pool's limit, then taking
+ * the job at the pool's next index and advancing the index, unless all jobs have been taken or the pool has been
+ * stopped due to a memory allocation failure. Then waits for the last earlier job with the same file name to be done
+ * (so their output files are removed and created again in the same order as in a one-by-one assembly), and creates
+ * the job's message buffer. If the buffer can't be created, waits until the messages of every earlier job are
+ * printed instead, so the job's messages can be printed directly.
+ *
+ * @param pool a pointer to the worker pool
+ * @return a pointer to the next job, or NULL if no more jobs should be run
+ */
+static AssemblyJob *take_job(WorkerPool *pool) {
+    AssemblyJob *job;
+    int index;
+    /* the index of the last earlier job with the same file name, or -1 if there is none */
+    int same_name;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopped && pool->next_job < pool->job_count &&
+           pool->next_job - pool->flushed_count >= pool->buffer_limit) {
+        pthread_cond_wait(&pool->progress, &pool->lock);
+    }
+    if (pool->stopped || pool->next_job == pool->job_count) {
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+    }
+    index = pool->next_job++;
+    pthread_mutex_unlock(&pool->lock);
+    job = &pool->jobs[index];
+    same_name = index - 1;
+    while (same_name >= 0 && !equal(pool->jobs[same_name].file_name, job->file_name)) same_name--;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->flushing_over && same_name >= 0 && !pool->jobs[same_name].done) {
+        pthread_cond_wait(&pool->progress, &pool->lock);
+    }
+    /* if the messages of an earlier job are the last to be printed, the job is not run */
+    if (pool->flushing_over) job = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    if (job == NULL) return NULL;
+    job->output = tmpfile();
+    if (job->output != NULL) return job;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->flushing_over && pool->flushed_count < index) pthread_cond_wait(&pool->progress, &pool->lock);
+    if (pool->flushed_count < index) job = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    return job;
 }
 
 /**
- * Reads a list of extensions file names from the command line and assembles the corresponding .as files one by one.
+ * Marks a job as done and notifies the main thread, which may be waiting to flush the job's messages.
+ * If the job ended with a memory allocation failure, stops the pool so no more assemblies are started.
+ *
+ * @param pool a pointer to the worker pool
+ * @param job  a pointer to the job that has finished
+ */
+static void finish_job(WorkerPool *pool, AssemblyJob *job) {
+    pthread_mutex_lock(&pool->lock);
+    job->done = 1;
+    if (job->result == MEMORY_ALLOCATION_FAILURE) pool->stopped = 1;
+    pthread_cond_broadcast(&pool->progress);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * The routine of every worker thread in the pool: keeps taking jobs and running them until there are no more jobs.
+ * All of the worker's jobs allocate from the same arena, which is reset after every job, so its blocks are reused
+ * instead of being allocated again for every file.
+ *
+ * @param arg a pointer to the worker pool
+ * @return NULL
+ */
+static void *worker(void *arg) {
+    WorkerPool *pool = (WorkerPool *) arg;
+    AssemblyJob *job;
+    Arena arena;
+    init_arena(&arena);
+    while ((job = take_job(pool)) != NULL) {
+        run_job(job, &arena);
+        finish_job(pool, job);
+    }
+    release_arena(&arena);
+    return NULL;
+}
+
+/**
+ * Copies the messages buffered by a job to the standard output, and closes the job's buffer.
+ * Does so by going back to the standard output as the calling thread's console, and flushing the buffer to it.
+ *
+ * @param job a pointer to the job whose messages should be flushed
+ */
+static void flush_job_output(AssemblyJob *job) {
+    /* if no buffer could be created for the job, its messages have already been printed directly */
+    if (job->output == NULL) return;
+    bind_console(NULL);
+    console_flush_buffer(job->output);
+    fclose(job->output);
+    job->output = NULL;
+}
+
+/**
+ * Runs all of the given jobs one by one on the main thread, with their messages printed directly to the standard
+ * output. All of the jobs allocate from the same arena, which is reset after every job.
+ *
+ * @param jobs      the list of jobs
+ * @param job_count the number of jobs
+ * @return SUCCESS if all files were assembled successfully, ASSEMBLY_FAILURE if at least one assembly error occurred,
+ *         or MEMORY_ALLOCATION_FAILURE if a memory allocation failure occurred
+ */
+static int run_jobs_in_order(AssemblyJob *jobs, int job_count) {
+    int result = SUCCESS;
+    int i;
+    Arena arena;
+    init_arena(&arena);
+    for (i = 0; i < job_count; i++) {
+        run_job(&jobs[i], &arena);
+        /* if a memory allocation failure has occurred, the program ends */
+        if (jobs[i].result == MEMORY_ALLOCATION_FAILURE) {
+            result = MEMORY_ALLOCATION_FAILURE;
+            break;
+        }
+        if (jobs[i].result != SUCCESS) result = ASSEMBLY_FAILURE;
+    }
+    release_arena(&arena);
+    return result;
+}
+
+/**
+ * Runs all of the given jobs on a pool of worker threads, and prints the messages of every job in the order of the
+ * jobs, so that the output is the same regardless of the order in which the assemblies finish.
+ * Does so by starting the workers, which give every job they take its own temporary file as a message buffer (see
+ * take_job), and then waiting for each job in order to finish and flushing its messages. At most
+ * BUFFERED_JOBS_PER_WORKER jobs per worker are taken before their messages are flushed, so the number of buffers
+ * stays the same regardless of the number of files. If a job ends with a memory allocation failure, stops after
+ * flushing its messages.
+ * If no worker thread can be created, runs the jobs one by one instead.
+ *
+ * @param jobs      the list of jobs
+ * @param job_count the number of jobs
+ * @param threads   the number of worker threads to use
+ * @return SUCCESS if all files were assembled successfully, ASSEMBLY_FAILURE if at least one assembly error occurred,
+ *         or MEMORY_ALLOCATION_FAILURE if a memory allocation failure occurred
+ */
+static int run_jobs_in_parallel(AssemblyJob *jobs, int job_count, int threads) {
+    WorkerPool pool;
+    pthread_t *workers;
+    /* the number of workers that were started successfully */
+    int started;
+    int i;
+    int result = SUCCESS;
+    workers = malloc(threads * sizeof(pthread_t));
+    if (workers == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating worker threads\n");
+        return MEMORY_ALLOCATION_FAILURE;
+    }
+    pool.jobs = jobs;
+    pool.job_count = job_count;
+    pool.next_job = 0;
+    pool.flushed_count = 0;
+    pool.buffer_limit = threads * BUFFERED_JOBS_PER_WORKER;
+    pool.stopped = 0;
+    pool.flushing_over = 0;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.progress, NULL);
+    for (started = 0; started < threads; started++) {
+        if (pthread_create(&workers[started], NULL, worker, &pool) != 0) break;
+    }
+    if (started == 0) {
+        pthread_mutex_destroy(&pool.lock);
+        pthread_cond_destroy(&pool.progress);
+        free(workers);
+        return run_jobs_in_order(jobs, job_count);
+    }
+    /* flushes the messages of the jobs in order, waiting for every job to finish */
+    for (i = 0; i < job_count; i++) {
+        pthread_mutex_lock(&pool.lock);
+        while (!jobs[i].done) pthread_cond_wait(&pool.progress, &pool.lock);
+        pthread_mutex_unlock(&pool.lock);
+        flush_job_output(&jobs[i]);
+        if (jobs[i].result == MEMORY_ALLOCATION_FAILURE) {
+            result = MEMORY_ALLOCATION_FAILURE;
+            break;
+        }
+        if (jobs[i].result != SUCCESS) result = ASSEMBLY_FAILURE;
+        pthread_mutex_lock(&pool.lock);
+        pool.flushed_count = i + 1;
+        pthread_cond_broadcast(&pool.progress);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    pthread_mutex_lock(&pool.lock);
+    pool.flushing_over = 1;
+    pthread_cond_broadcast(&pool.progress);
+    pthread_mutex_unlock(&pool.lock);
+    for (i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    /* closes the buffers of jobs whose messages were not flushed due to a memory allocation failure */
+    for (i = 0; i < job_count; i++) {
+        if (jobs[i].output != NULL) fclose(jobs[i].output);
+    }
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.progress);
+    free(workers);
+    return result;
+}
+
+/**
+ * The routine of the reader thread of a pipeline: opens the input file of every job in order, and asks the system to
+ * start loading its contents, while staying at most READ_AHEAD jobs ahead of the assembly.
+ * An input file that can't be opened is left for the assembly to open, which reports the error in order with the
+ * rest of the file's messages.
+ *
+ * @param arg a pointer to the pipeline
+ * @return NULL
+ */
+static void *pipeline_reader(void *arg) {
+    Pipeline *pipeline = (Pipeline *) arg;
+    AssemblyJob *job;
+    SourceFile *input_file;
+    char *input_file_name;
+    /* the arena that the names of the input files are allocated from, which is reset after every file */
+    Arena arena;
+    int stopped;
+    int i;
+    init_arena(&arena);
+    for (i = 0; i < pipeline->job_count; i++) {
+        pthread_mutex_lock(&pipeline->lock);
+        while (!pipeline->stopped && i - pipeline->assembled_count > READ_AHEAD) {
+            pthread_cond_wait(&pipeline->progress, &pipeline->lock);
+        }
+        stopped = pipeline->stopped;
+        pthread_mutex_unlock(&pipeline->lock);
+        if (stopped) break;
+        job = &pipeline->jobs[i];
+        bind_alloc_failure_flag(&job->alloc_failure);
+        input_file = NULL;
+        input_file_name = get_input_file_name(job->file_name, &arena);
+        if (input_file_name != NULL) input_file = open_source_file(input_file_name);
+        if (input_file != NULL) prefetch_source_file(input_file);
+        bind_alloc_failure_flag(NULL);
+        reset_arena(&arena);
+        pthread_mutex_lock(&pipeline->lock);
+        job->input_file = input_file;
+        pipeline->read_count = i + 1;
+        pthread_cond_broadcast(&pipeline->progress);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+    release_arena(&arena);
+    return NULL;
+}
+
+/**
+ * The routine of the writer thread of a pipeline: goes over the jobs in order as they are assembled, creates the
+ * output files of every job that was assembled successfully, and prints the job's messages and closes its message
+ * buffer. Stops after the last job that was assembled, or after a job that ended with a memory allocation failure.
+ *
+ * @param arg a pointer to the pipeline
+ * @return NULL
+ */
+static void *pipeline_writer(void *arg) {
+    Pipeline *pipeline = (Pipeline *) arg;
+    AssemblyJob *job;
+    /* whether the job was assembled */
+    int assembled;
+    int i;
+    for (i = 0; i < pipeline->job_count; i++) {
+        pthread_mutex_lock(&pipeline->lock);
+        while (!pipeline->assembly_over && i >= pipeline->assembled_count) {
+            pthread_cond_wait(&pipeline->progress, &pipeline->lock);
+        }
+        assembled = i < pipeline->assembled_count;
+        pthread_mutex_unlock(&pipeline->lock);
+        if (!assembled) break;
+        job = &pipeline->jobs[i];
+        bind_console(job->output);
+        bind_alloc_failure_flag(&job->alloc_failure);
+        if (job->result == SUCCESS) job->result = write_output_files(job->file_name, job->requirements);
+        job->requirements = NULL;
+        /* a memory allocation failure ends the program right after the file's messages */
+        if (job->result != MEMORY_ALLOCATION_FAILURE) console_printf("\n");
+        bind_alloc_failure_flag(NULL);
+        bind_console(NULL);
+        flush_job_output(job);
+        pthread_mutex_lock(&pipeline->lock);
+        pipeline->written_count = i + 1;
+        if (job->result == MEMORY_ALLOCATION_FAILURE) pipeline->stopped = 1;
+        pthread_cond_broadcast(&pipeline->progress);
+        pthread_mutex_unlock(&pipeline->lock);
+        if (job->result == MEMORY_ALLOCATION_FAILURE) break;
+    }
+    return NULL;
+}
+
+/**
+ * Waits until a job of a pipeline may be assembled - its input file was opened, the assembly is at most WRITE_BEHIND
+ * jobs ahead of the writer (so the job's arena is free), and the output files of every earlier job with the same file
+ * name were written (so they are removed and created again in the same order as in a one-by-one assembly).
+ * Then creates the job's message buffer, which the writer closes once it prints the job's messages. If the buffer
+ * can't be created, waits until the messages of every earlier job are printed instead, so the job's messages can be
+ * printed directly.
+ *
+ * @param pipeline a pointer to the pipeline
+ * @param index    the index of the job
+ * @return 1 if the job may be assembled, 0 if the pipeline was stopped
+ */
+static int wait_for_assembly(Pipeline *pipeline, int index) {
+    /* the index of the last earlier job with the same file name, or -1 if there is none */
+    int same_name = index - 1;
+    int stopped;
+    while (same_name >= 0 && !equal(pipeline->jobs[same_name].file_name, pipeline->jobs[index].file_name)) same_name--;
+    pthread_mutex_lock(&pipeline->lock);
+    while (!pipeline->stopped && (index >= pipeline->read_count || index - pipeline->written_count > WRITE_BEHIND ||
+                                  same_name >= pipeline->written_count)) {
+        pthread_cond_wait(&pipeline->progress, &pipeline->lock);
+    }
+    stopped = pipeline->stopped;
+    pthread_mutex_unlock(&pipeline->lock);
+    if (stopped) return 0;
+    pipeline->jobs[index].output = tmpfile();
+    if (pipeline->jobs[index].output != NULL) return 1;
+    pthread_mutex_lock(&pipeline->lock);
+    while (!pipeline->stopped && pipeline->written_count < index) {
+        pthread_cond_wait(&pipeline->progress, &pipeline->lock);
+    }
+    stopped = pipeline->stopped;
+    pthread_mutex_unlock(&pipeline->lock);
+    return !stopped;
+}
+
+/**
+ * Runs all of the given jobs one by one on the main thread, as the middle stage of a pipeline - while a reader thread
+ * opens the input files of the next jobs and a writer thread creates the output files of the previous jobs and prints
+ * their messages in order (see Pipeline). Every job gets its own temporary file as a message buffer once it may be
+ * assembled (see wait_for_assembly), so the messages of the stages are printed together, and at most about
+ * READ_AHEAD + WRITE_BEHIND + 1 buffers are open at once regardless of the number of files. The output is the same as
+ * when the jobs run one by one, and if a job ends with a memory allocation failure, no more jobs are started.
+ * If a thread can't be created, runs the jobs one by one without a pipeline instead.
+ *
+ * @param jobs      the list of jobs
+ * @param job_count the number of jobs
+ * @return SUCCESS if all files were assembled successfully, ASSEMBLY_FAILURE if at least one assembly error occurred,
+ *         or MEMORY_ALLOCATION_FAILURE if a memory allocation failure occurred
+ */
+static int run_jobs_in_pipeline(AssemblyJob *jobs, int job_count) {
+    Pipeline pipeline;
+    pthread_t reader, writer;
+    int result = SUCCESS;
+    int i;
+    pipeline.jobs = jobs;
+    pipeline.job_count = job_count;
+    pipeline.read_count = 0;
+    pipeline.assembled_count = 0;
+    pipeline.written_count = 0;
+    pipeline.assembly_over = 0;
+    pipeline.stopped = 0;
+    pthread_mutex_init(&pipeline.lock, NULL);
+    pthread_cond_init(&pipeline.progress, NULL);
+    if (pthread_create(&reader, NULL, pipeline_reader, &pipeline) == 0) {
+        if (pthread_create(&writer, NULL, pipeline_writer, &pipeline) == 0) {
+            for (i = 0; i < PIPELINE_ARENA_COUNT; i++) init_arena(&pipeline.arenas[i]);
+            for (i = 0; i < job_count && wait_for_assembly(&pipeline, i); i++) {
+                Requirements *requirements = NULL;
+                bind_console(jobs[i].output);
+                bind_alloc_failure_flag(&jobs[i].alloc_failure);
+                jobs[i].result = assemble(&jobs[i], &pipeline.arenas[i % PIPELINE_ARENA_COUNT], &requirements);
+                bind_alloc_failure_flag(NULL);
+                bind_console(NULL);
+                pthread_mutex_lock(&pipeline.lock);
+                jobs[i].requirements = requirements;
+                pipeline.assembled_count = i + 1;
+                if (jobs[i].result == MEMORY_ALLOCATION_FAILURE) pipeline.stopped = 1;
+                pthread_cond_broadcast(&pipeline.progress);
+                pthread_mutex_unlock(&pipeline.lock);
+            }
+            pthread_mutex_lock(&pipeline.lock);
+            pipeline.assembly_over = 1;
+            pthread_cond_broadcast(&pipeline.progress);
+            pthread_mutex_unlock(&pipeline.lock);
+            pthread_join(writer, NULL);
+        }
+        /* if the writer could not be started, stops the reader */
+        else {
+            pthread_mutex_lock(&pipeline.lock);
+            pipeline.stopped = 1;
+            pthread_cond_broadcast(&pipeline.progress);
+            pthread_mutex_unlock(&pipeline.lock);
+        }
+        pthread_join(reader, NULL);
+    }
+    /* if no job was assembled, the jobs run one by one (with the input files that were already opened) */
+    if (pipeline.assembled_count == 0) {
+        for (i = 0; i < job_count; i++) {
+            if (jobs[i].output != NULL) fclose(jobs[i].output);
+            jobs[i].output = NULL;
+        }
+        pthread_mutex_destroy(&pipeline.lock);
+        pthread_cond_destroy(&pipeline.progress);
+        return run_jobs_in_order(jobs, job_count);
+    }
+    for (i = 0; i < pipeline.written_count; i++) {
+        if (jobs[i].result == MEMORY_ALLOCATION_FAILURE) result = MEMORY_ALLOCATION_FAILURE;
+        else if (jobs[i].result != SUCCESS && result == SUCCESS) result = ASSEMBLY_FAILURE;
+    }
+    /* cleans up the jobs that were stopped by a memory allocation failure before they were done */
+    for (i = 0; i < job_count; i++) {
+        if (jobs[i].input_file != NULL) close_source_file(jobs[i].input_file);
+        if (jobs[i].requirements != NULL) free_requirements(jobs[i].requirements);
+        if (jobs[i].output != NULL) fclose(jobs[i].output);
+    }
+    for (i = 0; i < PIPELINE_ARENA_COUNT; i++) release_arena(&pipeline.arenas[i]);
+    pthread_mutex_destroy(&pipeline.lock);
+    pthread_cond_destroy(&pipeline.progress);
+    return result;
+}
+
+/**
+ * Reads the number given to an option such as -j, either in the same argument ("-j4") or in the argument after it
+ * ("-j 4").
+ *
+ * @param argc   the number of command line arguments
+ * @param argv   the list of command line arguments
+ * @param index  a pointer to the index of the argument that holds the option, advanced if the number is given in the
+ *               following argument
+ * @param option the option
+ * @return the number, or 0 if the number is missing or is not a positive integer
+ */
+static int read_number_option(int argc, char **argv, int *index, char *option) {
+    char *value = argv[*index] + strlen(option);
+    if (*value == '\0') {
+        if (*index + 1 == argc) return 0;
+        value = argv[++(*index)];
+    }
+    if (!is_integer(value) || atoi(value) < 1) return 0;
+    return atoi(value);
+}
+
+/**
+ * Reads a list of extensions file names from the command line and assembles the corresponding .as files.
  * See the documentation at the top of the file for more information about the assembly process.
+ * By default the files are assembled one by one, in a pipeline that reads the next files and writes the output files
+ * of the previous ones at the same time. If the -j option is given with a number N, up to N files are assembled at the
+ * same time on a pool of worker threads, and the messages of every file are buffered and printed in the order in
+ * which the files were given. If the --emit-am option is given, the parsed source of every file is also
+ * written into a .am file. If the -t option is given with a number N, the passes over every file may split their
+ * work between up to N threads, and if the --cache-stats option is given, the hits and misses of the encoding cache of
+ * every file are printed.
  * 
- * @param argc the number of command line arguments (one plus the number of files to be assembled)
- * @param argv a list of command line arguments (the ./assembler command and the extensionless file names)
+ * @param argc the number of command line arguments (one plus the number of files to be assembled and options)
+ * @param argv a list of command line arguments (the ./assembler command, options and the extensionless file names)
  * @return 0 if all files were assembled successfully, 1 if at least one assembly error occurred, 2 if a memory
- *         allocation failure occurred (exits with code 2 if necessary in the assemble function), or 3 if no files
- *         were given
+ *         allocation failure occurred, 3 if no files were given, or 4 if the options are invalid
  */
 int main(int argc, char **argv) {
-    /* whether an assembly error has occurred */
-    int failure;
+    /* the assemblies to be run, one for every file name */
+    AssemblyJob *jobs;
+    int job_count = 0;
+    /* the number of files that may be assembled at the same time */
+    int threads = 1;
+    /* whether the parsed source of every file should be written into a .am file */
+    int emit_parsed_file = 0;
+    /* whether the hits and misses of the encoding cache of every file should be printed */
+    int print_cache_stats = 0;
+    /* the number of threads that the passes over every file may split their work between */
+    int thread_count = 1;
+    /* the result of the assemblies */
+    int result;
     /* index for going over the command line arguments */
     int i;
-    /* no arguments were given */
-    if (argc == 1) {
+    jobs = calloc(argc, sizeof(AssemblyJob));
+    if (jobs == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when reading command line arguments\n");
+        return MEMORY_ALLOCATION_FAILURE;
+    }
+    /* separates the options from the file names */
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], JOBS_OPTION, strlen(JOBS_OPTION)) == 0) {
+            threads = read_number_option(argc, argv, &i, JOBS_OPTION);
+            if (threads == 0) {
+                printf("Invalid number of jobs given to assembler\n");
+                free(jobs);
+                return INVALID_OPTIONS;
+            }
+        }
+        else if (strncmp(argv[i], THREADS_OPTION, strlen(THREADS_OPTION)) == 0) {
+            thread_count = read_number_option(argc, argv, &i, THREADS_OPTION);
+            if (thread_count == 0) {
+                printf("Invalid number of threads given to assembler\n");
+                free(jobs);
+                return INVALID_OPTIONS;
+            }
+        }
+        else if (equal(argv[i], EMIT_AM_OPTION)) emit_parsed_file = 1;
+        else if (equal(argv[i], CACHE_STATS_OPTION)) print_cache_stats = 1;
+        else jobs[job_count++].file_name = argv[i];
+    }
+    /* no file names were given */
+    if (job_count == 0) {
         printf("No file names given to assembler\n");
+        free(jobs);
         return NO_FILES_GIVEN;
     }
-    /* assembles every file one by one and updates the failure flag */
-    for (i = 1; i < argc; i++) {
-        failure |= assemble(argv[i]);
-        /* prints a line break to make a distinction between messages from different files */
-        printf("\n");
+    for (i = 0; i < job_count; i++) {
+        jobs[i].emit_parsed_file = emit_parsed_file;
+        jobs[i].print_cache_stats = print_cache_stats;
+        jobs[i].thread_count = thread_count;
     }
-    /* if an assembly error has occurred, exits with exit code 1, otherwise 0 */
-    if (failure) return ASSEMBLY_FAILURE;
-    return SUCCESS;
+    /* there is no need for more workers than files */
+    if (threads > job_count) threads = job_count;
+    if (threads > 1) result = run_jobs_in_parallel(jobs, job_count, threads);
+    else if (job_count > 1) result = run_jobs_in_pipeline(jobs, job_count);
+    else result = run_jobs_in_order(jobs, job_count);
+    free(jobs);
+    return result;
 }
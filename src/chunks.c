@@ -0,0 +1,106 @@
+/**
+ * Includes functions that handle the chunks of a file at the same time, each on its own thread.
+ */
+
+#include "../headers/chunks.h"
+#include "stdlib.h"
+#include "pthread.h"
+#include "../headers/console.h"
+#include "../headers/alloc_failure_handler.h"
+
+/**
+ * The thread that handles a chunk, along with the chunk and the function that handles it.
+ */
+typedef struct {
+    pthread_t thread;
+    Chunk *chunk;
+    int (*handle)(void *chunk);
+} ChunkThread;
+
+/**
+ * Returns the chunk at a given index of a list of chunks.
+ *
+ * @param chunks     the list of chunks
+ * @param index      the index of the chunk
+ * @param chunk_size the size of every chunk in the list
+ * @return a pointer to the chunk
+ */
+static Chunk *chunk_at(void *chunks, int index, size_t chunk_size) {
+    return (Chunk *) ((char *) chunks + index * chunk_size);
+}
+
+/**
+ * The routine of the thread of every chunk: handles the chunk, with the thread's console and allocation failure
+ * handler bound to the chunk.
+ *
+ * @param arg a pointer to the chunk's thread
+ * @return NULL
+ */
+static void *chunk_routine(void *arg) {
+    ChunkThread *chunk_thread = (ChunkThread *) arg;
+    Chunk *chunk = chunk_thread->chunk;
+    bind_console(chunk->output);
+    bind_alloc_failure_flag(&chunk->alloc_failure);
+    chunk->error_found = chunk_thread->handle(chunk);
+    bind_alloc_failure_flag(NULL);
+    bind_console(NULL);
+    return NULL;
+}
+
+/**
+ * Handles a list of chunks at the same time, each on its own thread, and waits for all of them to be done.
+ * Does so by starting the threads in order and stopping at the first one that can't be started, then joining every
+ * thread that was started. If every chunk was handled, an allocation failure in any of them is passed on to the
+ * handler of the calling thread.
+ *
+ * @param chunks      the list of chunks, whose buffers should already be created
+ * @param chunk_count the number of chunks
+ * @param chunk_size  the size of every chunk in the list
+ * @param handle      the function that handles a chunk, given a pointer to it, and returns 1 if an error was found in
+ *                    it, 0 otherwise
+ * @return 1 if every chunk was handled, 0 otherwise (in which case allocation failures in the chunks are ignored)
+ */
+int run_chunks(void *chunks, int chunk_count, size_t chunk_size, int (*handle)(void *chunk)) {
+    ChunkThread *threads = malloc(chunk_count * sizeof(ChunkThread));
+    /* the number of threads that were started */
+    int started;
+    int i;
+    if (threads == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when starting chunk threads\n");
+        set_alloc_failure();
+        return 0;
+    }
+    for (started = 0; started < chunk_count; started++) {
+        threads[started].chunk = chunk_at(chunks, started, chunk_size);
+        threads[started].handle = handle;
+        if (pthread_create(&threads[started].thread, NULL, chunk_routine, &threads[started]) != 0) break;
+    }
+    for (i = 0; i < started; i++) pthread_join(threads[i].thread, NULL);
+    free(threads);
+    if (started < chunk_count) return 0;
+    for (i = 0; i < chunk_count; i++) {
+        if (chunk_at(chunks, i, chunk_size)->alloc_failure) set_alloc_failure();
+    }
+    return 1;
+}
+
+/**
+ * Prints the messages of a list of chunks in order, if the result of the chunks is used, and closes their buffers.
+ * Chunks whose buffers were not created (since the chunks before them could not be prepared) are skipped.
+ *
+ * @param chunks      the list of chunks, some of which may have no buffer
+ * @param chunk_count the number of chunks
+ * @param chunk_size  the size of every chunk in the list
+ * @param used        whether the result of the chunks is used, in which case their messages should be printed
+ */
+void close_chunks(void *chunks, int chunk_count, size_t chunk_size, int used) {
+    Chunk *chunk;
+    int i;
+    for (i = 0; i < chunk_count; i++) {
+        chunk = chunk_at(chunks, i, chunk_size);
+        if (chunk->output == NULL) continue;
+        if (used) console_flush_buffer(chunk->output);
+        fclose(chunk->output);
+        chunk->output = NULL;
+    }
+}
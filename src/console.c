@@ -0,0 +1,78 @@
+/**
+ * Includes functions that print messages to the user, each through the console stream of the calling thread.
+ */
+
+#include "../headers/console.h"
+#include "pthread.h"
+#include "stdarg.h"
+
+/**
+ * The key through which each thread finds the stream it is bound to.
+ */
+static pthread_key_t console_key;
+
+/**
+ * Makes sure the key is created exactly once.
+ */
+static pthread_once_t console_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Creates the thread-specific key that holds the stream each thread is bound to.
+ */
+static void create_console_key() {
+    pthread_key_create(&console_key, NULL);
+}
+
+/**
+ * Binds the console of the calling thread to a given stream.
+ * Does so by setting the thread-specific value of the key to the given stream.
+ *
+ * @param stream the stream that messages should be written to, or NULL to go back to the standard output
+ */
+void bind_console(FILE *stream) {
+    pthread_once(&console_key_once, create_console_key);
+    pthread_setspecific(console_key, stream);
+}
+
+/**
+ * Returns the stream that the calling thread's messages are written to.
+ * Does so by getting the thread-specific value of the key, and falling back to the standard output if the thread
+ * has not been bound to a stream.
+ *
+ * @return the stream the calling thread is bound to, or the standard output if it is not bound to any stream
+ */
+FILE *console() {
+    FILE *stream;
+    pthread_once(&console_key_once, create_console_key);
+    stream = pthread_getspecific(console_key);
+    return stream == NULL ? stdout : stream;
+}
+
+/**
+ * Prints a formatted message to the console of the calling thread, using the same format as printf.
+ *
+ * @param format the format of the message
+ * @param ...    the values that should be formatted into the message
+ */
+void console_printf(char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(console(), format, args);
+    va_end(args);
+}
+
+/**
+ * Prints the messages that were buffered in a stream to the console of the calling thread, from the start of the
+ * stream.
+ * Does so by rewinding the stream and copying its content in blocks.
+ *
+ * @param buffer the stream that the messages were buffered in
+ */
+void console_flush_buffer(FILE *buffer) {
+    char block[BUFSIZ];
+    size_t count;
+    rewind(buffer);
+    while ((count = fread(block, 1, sizeof(block), buffer)) > 0) {
+        fwrite(block, 1, count, console());
+    }
+}
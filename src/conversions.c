@@ -5,7 +5,7 @@
  */
 
 #include "../headers/conversions.h"
-#include "../headers/util/string_ops.h"
+#include "stdlib.h"
 
 #define RIGHTMOST_BIT(x) (x & 1)
 #define OPCODE_SHIFT 11
@@ -13,14 +13,65 @@
 #define DESTINATION_METHOD_SHIFT 3
 #define SOURCE_REGISTER_NUMBER_SHIFT 6
 #define DESTINATION_REGISTER_NUMBER_SHIFT 3
-#define FIRST_WORD_ARE_STRING "100" 
-#define REGISTER_WORD_ARE_STRING "100"
-#define IMMEDIATE_VALUE_WORD_ARE_STRING "100"
+/* the A,R,E values of the different words, where 4 is 100 in binary, 2 is 010 and 1 is 001 */
+#define FIRST_WORD_ARE 4
+#define REGISTER_WORD_ARE 4
+#define IMMEDIATE_VALUE_WORD_ARE 4
 #define IMMEDIATE_VALUE_NUM_SHIFT 3
-#define DIRECT_ADDRESS_WORD_RELOCATABLE_ARE_STRING "010"
-#define DIRECT_ADDRESS_WORD_EXTERNAL_ARE_STRING "001"
+#define DIRECT_ADDRESS_WORD_RELOCATABLE_ARE 2
+#define DIRECT_ADDRESS_WORD_EXTERNAL_ARE 1
 #define DIRECT_ADDRESS_WORD_VALUE_SHIFT 3
 
+/**
+ * The bits of an address method in the first word of an instruction - the 1 representing the address method, shifted
+ * to the left based on which bit should be on, plus the shift of the first bit of the method's portion. If there is
+ * no operand, no bits are on.
+ */
+#define METHOD_BITS(method, shift) ((method) == NO_OPERAND ? 0 : 1 << ((method) + (shift)))
+
+/**
+ * Whether an address method is one of the register address methods.
+ */
+#define IS_REGISTER_METHOD(method) ((method) == DIRECT_REGISTER_ADDRESS || (method) == INDIRECT_REGISTER_ADDRESS)
+
+/**
+ * The encoding of an instruction with a given opcode and address methods.
+ */
+#define ENCODING(opcode, source, destination) \
+        {(opcode) << OPCODE_SHIFT | METHOD_BITS(source, SOURCE_METHOD_SHIFT) | \
+         METHOD_BITS(destination, DESTINATION_METHOD_SHIFT) | FIRST_WORD_ARE, \
+         IS_REGISTER_METHOD(source) && IS_REGISTER_METHOD(destination)}
+
+/**
+ * The encodings of the instructions with a given opcode and source address method, for every destination address
+ * method.
+ */
+#define ENCODINGS_FOR_SOURCE(opcode, source) \
+        {ENCODING(opcode, source, IMMEDIATE_ADDRESS), ENCODING(opcode, source, DIRECT_ADDRESS), \
+         ENCODING(opcode, source, INDIRECT_REGISTER_ADDRESS), ENCODING(opcode, source, DIRECT_REGISTER_ADDRESS), \
+         ENCODING(opcode, source, NO_OPERAND)}
+
+/**
+ * The encodings of the instructions with a given opcode, for every source and destination address method.
+ */
+#define ENCODINGS_FOR_OPERATOR(opcode) \
+        {ENCODINGS_FOR_SOURCE(opcode, IMMEDIATE_ADDRESS), ENCODINGS_FOR_SOURCE(opcode, DIRECT_ADDRESS), \
+         ENCODINGS_FOR_SOURCE(opcode, INDIRECT_REGISTER_ADDRESS), \
+         ENCODINGS_FOR_SOURCE(opcode, DIRECT_REGISTER_ADDRESS), ENCODINGS_FOR_SOURCE(opcode, NO_OPERAND)}
+
+/**
+ * The encodings of all instructions, indexed by the opcode, the source address method and the destination address
+ * method (including illegal combinations, which are never looked up).
+ * The table is constant and initialized at compile time, so it can be shared by several assemblies that run at the
+ * same time.
+ */
+static const InstructionEncoding encodings[NUMBER_OF_OPERATORS][NO_OPERAND + 1][NO_OPERAND + 1] = {
+        ENCODINGS_FOR_OPERATOR(0), ENCODINGS_FOR_OPERATOR(1), ENCODINGS_FOR_OPERATOR(2), ENCODINGS_FOR_OPERATOR(3),
+        ENCODINGS_FOR_OPERATOR(4), ENCODINGS_FOR_OPERATOR(5), ENCODINGS_FOR_OPERATOR(6), ENCODINGS_FOR_OPERATOR(7),
+        ENCODINGS_FOR_OPERATOR(8), ENCODINGS_FOR_OPERATOR(9), ENCODINGS_FOR_OPERATOR(10), ENCODINGS_FOR_OPERATOR(11),
+        ENCODINGS_FOR_OPERATOR(12), ENCODINGS_FOR_OPERATOR(13), ENCODINGS_FOR_OPERATOR(14), ENCODINGS_FOR_OPERATOR(15)
+};
+
 /**
  * Gets the number of a register based on the register's string representation.
  * Does so by finding the numeric value of the the part immediately after the starting 'r'.
@@ -34,54 +85,18 @@ static int get_register_number(char *reg) {
 }
 
 /**
- * Returns the first memory word representing an instruction.
- * Does so by creating 4 unsigned short values, each representing a portion of the word with the rest
- * of its bits being 0, and ORing them all.
- * 
- * @param op                 the instruction's operator
- * @param source_method      the address method for the source operand
- * @param destination_method the address method for the destination operand
- * @return the first word of the instruction's binary value, padded with a zero on the left so it can be returned
- * as an unsigned short.
- */
-short unsigned build_instruction_first_word(Operator op, AddressMethod source_method, 
-                                            AddressMethod destination_method) {
-    /* the bits representing the opcode, with the correct shift from the right */
-    short unsigned opcode_bits =  get_opcode(op.name) << OPCODE_SHIFT;
-    /* the bits representing the source address method, with the correct shift from the right */
-    short unsigned source_method_bits;
-    /* the bits representing the destination address method, with the correct shift from the right */
-    short unsigned destination_method_bits;
-    /* the bits representing the A,R,E (which is always the same in the first word),
-     * with the correct shift from the right */
-    short unsigned are = binary_string_to_number(FIRST_WORD_ARE_STRING);;
-    /* if there is no source, then no bits in the source address method are on */
-    if (source_method == NO_OPERAND) source_method_bits = 0;
-    /* otherwise, the 1 representing the address method is shifted to the left based on which bit should be on, plus the
-     * shift to the left of the first bit of the source address method portion */
-    else source_method_bits = 1 << (source_method + SOURCE_METHOD_SHIFT);
-    /* if there is no destination, then no bits in the destination address method are on */
-    if (destination_method == NO_OPERAND) destination_method_bits = 0;
-    /* otherwise, the 1 representing the address method is shifted to the left based on which bit should be on, plus the
-     * shift to the left of the first bit of the destination address method portion */
-    else destination_method_bits = 1 << (destination_method + DESTINATION_METHOD_SHIFT);
-    /* ORs all the values (with the correct shifting already applied) */
-    return opcode_bits | source_method_bits | destination_method_bits | are;
-}
-
-/**
- * Checks if the second and third words of an instruction should be combined to a single word.
- * Does so by checking if both the source address method and the destination address method are
- * either direct register address or indirect register address.
- * Should only for two-operand instructions.
+ * Returns the encoding of an instruction based on its operator and the address methods of its operands.
+ * Does so by looking it up in the table of encodings, so neither the operator's name nor the bits of the first word
+ * have to be processed again.
  * 
+ * @param op                 the instruction's operator, which should be legal
  * @param source_method      the address method for the source operand
  * @param destination_method the address method for the destination operand
- * @return 1 if the additional words should be combined, 0 otherwise
+ * @return a pointer to the (constant) encoding of the instruction
  */
-int should_combine_additional_words(AddressMethod source_method, AddressMethod destination_method) {
-    return (source_method == DIRECT_REGISTER_ADDRESS || source_method == INDIRECT_REGISTER_ADDRESS) &&
-            (destination_method == DIRECT_REGISTER_ADDRESS || destination_method == INDIRECT_REGISTER_ADDRESS);
+const InstructionEncoding *get_instruction_encoding(Operator op, AddressMethod source_method,
+                                                    AddressMethod destination_method) {
+    return &encodings[op.opcode][source_method][destination_method];
 }
 
 /**
@@ -98,7 +113,7 @@ short unsigned create_source_register_word(char *reg) {
     int reg_number = get_register_number(reg);
     short unsigned source_register_bits = reg_number << SOURCE_REGISTER_NUMBER_SHIFT;
     /* the A,R,E is always the same for a register word */
-    short unsigned are = binary_string_to_number(REGISTER_WORD_ARE_STRING);
+    short unsigned are = REGISTER_WORD_ARE;
     return source_register_bits | are;
 }
 
@@ -116,7 +131,7 @@ short unsigned create_destination_register_word(char *reg) {
     int reg_number = get_register_number(reg);
     short unsigned destination_register_bits = reg_number << DESTINATION_REGISTER_NUMBER_SHIFT;
     /* the A,R,E is always the same for a register word */
-    short unsigned are = binary_string_to_number(REGISTER_WORD_ARE_STRING);
+    short unsigned are = REGISTER_WORD_ARE;
     return destination_register_bits | are;
 }
 
@@ -137,7 +152,7 @@ short unsigned create_combined_register_word(char *source_reg, char *destination
     short unsigned source_register_bits = source_reg_number << SOURCE_REGISTER_NUMBER_SHIFT;
     short unsigned destination_register_bits = destination_reg_number << DESTINATION_REGISTER_NUMBER_SHIFT;
     /* the A,R,E is always the same for a register word */
-    short unsigned are = binary_string_to_number(REGISTER_WORD_ARE_STRING);
+    short unsigned are = REGISTER_WORD_ARE;
     return source_register_bits | destination_register_bits | are;
 }
 /**
@@ -151,10 +166,10 @@ short unsigned create_combined_register_word(char *source_reg, char *destination
  */
 short unsigned create_immediate_address_word(short num) {
     /* 12 bits 2's complement */
-    short unsigned num_bits = (unsigned short)(num >= 0 ? num : (pow(2, IMMEDIATE_VALUE_SIZE_BITS)) + num)
+    short unsigned num_bits = (unsigned short)(num >= 0 ? num : (1 << IMMEDIATE_VALUE_SIZE_BITS) + num)
             << IMMEDIATE_VALUE_NUM_SHIFT;
     /* the A,R,E is always the same for an immediate value word */
-    short unsigned are = binary_string_to_number(IMMEDIATE_VALUE_WORD_ARE_STRING);
+    short unsigned are = IMMEDIATE_VALUE_WORD_ARE;
     return num_bits | are;
 }
 
@@ -172,9 +187,9 @@ short unsigned create_direct_address_word(int symbol_value, SymbolType symbol_ty
     short unsigned are;
     /* the A,R,E depends on whether the symbol is external or relocatable */
     if (symbol_type == EXTERNAL) {
-        are = binary_string_to_number(DIRECT_ADDRESS_WORD_EXTERNAL_ARE_STRING);
+        are = DIRECT_ADDRESS_WORD_EXTERNAL_ARE;
     } else {
-        are = binary_string_to_number(DIRECT_ADDRESS_WORD_RELOCATABLE_ARE_STRING);
+        are = DIRECT_ADDRESS_WORD_RELOCATABLE_ARE;
     }
     return value_bits | are;
 }
@@ -0,0 +1,88 @@
+/**
+ * Includes functions that allow for interacting with the encoding cache.
+ */
+
+#include "../headers/encoding_cache.h"
+#include "stdlib.h"
+#include "stdio.h"
+#include "string.h"
+#include "../headers/alloc_failure_handler.h"
+#include "../headers/util/string_ops.h"
+
+/**
+ * Creates a new, empty encoding cache.
+ * Does so by allocating the cache and its map in the heap, and zeroing its counters.
+ *
+ * @param arena a pointer to the arena that the keys should be allocated from
+ * @return a pointer to the new cache, or NULL if an allocation failure has occurred
+ */
+EncodingCache *create_encoding_cache(Arena *arena) {
+    EncodingCache *cache = malloc(sizeof(EncodingCache));
+    /* if an allocation failure has occurred, updates the handler and returns NULL */
+    if (cache == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating encoding cache\n");
+        set_alloc_failure();
+        return NULL;
+    }
+    /* if an allocation failure has occurred, the map has already updated the handler */
+    cache->map = create_map(ENCODING);
+    if (cache->map == NULL) {
+        free(cache);
+        return NULL;
+    }
+    cache->arena = arena;
+    cache->hits = 0;
+    cache->misses = 0;
+    return cache;
+}
+
+/**
+ * Looks for an instruction in an encoding cache, and counts the lookup as a hit or a miss.
+ * Does so by looking for the handle of the instruction's key in the cache's map.
+ *
+ * @param cache a pointer to the cache
+ * @param key   the normalized text of the instruction
+ * @return a pointer to the cached encoding of the instruction, or NULL if it is not in the cache
+ */
+const EncodingContent *find_cached_encoding(EncodingCache *cache, char *key) {
+    int handle = map_find_handle(cache->map, key);
+    if (handle == -1) {
+        cache->misses++;
+        return NULL;
+    }
+    cache->hits++;
+    return map_get_encoding_at(cache->map, handle);
+}
+
+/**
+ * Adds an instruction to an encoding cache.
+ * Does so by copying the key into the arena, and adding it to the cache's map along with the instruction's words.
+ * Assumes that the cache does not contain the instruction.
+ *
+ * @param cache      a pointer to the cache
+ * @param key        the normalized text of the instruction
+ * @param words      the instruction's memory words
+ * @param word_count the number of the instruction's memory words (at most MAX_INSTRUCTION_WORDS)
+ * @return 0 if the instruction was added successfully, 1 if an allocation failure has occurred
+ */
+int add_cached_encoding(EncodingCache *cache, char *key, unsigned short words[], int word_count) {
+    EncodingContent encoding;
+    /* if an allocation failure has occurred, the arena has already updated the handler */
+    char *stored_key = view_duplicate(view_of(key), cache->arena);
+    if (stored_key == NULL) return 1;
+    encoding.word_count = word_count;
+    memcpy(encoding.words, words, word_count * sizeof(unsigned short));
+    /* if an allocation failure has occurred, the map has already updated the handler */
+    return map_add_encoding(cache->map, stored_key, encoding) == -1;
+}
+
+/**
+ * Frees an encoding cache. The keys are released along with the arena they were allocated from.
+ *
+ * @param cache a pointer to the cache to be freed
+ */
+void free_encoding_cache(EncodingCache *cache) {
+    if (cache == NULL) return;
+    free_map(cache->map);
+    free(cache);
+}
@@ -1,13 +1,17 @@
 /**
  * Includes functions that handle getting the names and opening files in different formats.
  */
- 
+
+/* the low-level file functions are part of POSIX rather than ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
 #include "../headers/files.h"
-#include "../headers/alloc_failure_handler.h"
-#include "../headers/util/general_util.h"
+#include "../headers/console.h"
 #include "stdio.h"
 #include "string.h"
-#include "stdlib.h"
+#include "errno.h"
+#include "fcntl.h"
+#include "unistd.h"
 
 #define INPUT_EXTENSION ".as"
 #define PARSED_EXTENSION ".am"
@@ -18,25 +22,23 @@
 /**
  * Creates a string that corresponds to a given file name with a given extension.
  * 
- * Does so by allocating enough memory for the new string and initializing its characters to 0, and then concatenating
- * the extensionless file name and the extension to it.
+ * Does so by allocating enough memory for the new string from the given arena, and then copying the extensionless file
+ * name and the extension (with its terminating 0) to it.
  * 
  * @param file_name the extensionless file name
  * @param extension the extension (including the period)
- * @return a string (allocated on the heap) which represents the file name with the extension, or NULL
+ * @param arena     a pointer to the arena that the string should be allocated from
+ * @return a string (allocated from the arena) which represents the file name with the extension, or NULL
  *         if an allocation failure has occurred
  */
-static char *get_file_name_with_extension(char file_name[], char extension[]) {
-    char *name_with_extension = calloc(strlen(file_name) + strlen(extension) + 1, 1);
-    /* if an allocation failure has occurred, updates the handler and returns NULL */
-    if (name_with_extension == NULL) {
-        fprintf(stderr, "Memory Error: Memory allocation failure when copying file name\n");
-        set_alloc_failure();
-        return NULL;
-    }
-    /* copies the extensionless file name and the extension to the new string by concatenating them */
-    strcat(name_with_extension, file_name);
-    strcat(name_with_extension, extension);
+static char *get_file_name_with_extension(char file_name[], char extension[], Arena *arena) {
+    size_t name_length = strlen(file_name);
+    /* if an allocation failure has occurred, the arena has already updated the handler */
+    char *name_with_extension = arena_allocate(arena, name_length + strlen(extension) + 1);
+    if (name_with_extension == NULL) return NULL;
+    /* copies the extensionless file name and the extension to the new string one after the other */
+    memcpy(name_with_extension, file_name, name_length);
+    strcpy(name_with_extension + name_length, extension);
     return name_with_extension;
 }
 
@@ -44,172 +46,134 @@ static char *get_file_name_with_extension(char file_name[], char extension[]) {
  * Gets a file name without an extension and returns the name of the input file with the .as extension.
  * 
  * @param file_name the file name without the extension (as given as command line argument)
+ * @param arena     a pointer to the arena that the name should be allocated from
  * @return the name of the input file with the extension, or NULL if a memory allocation failure occurred
  */
-char *get_input_file_name(char file_name[]) {
-    return get_file_name_with_extension(file_name, INPUT_EXTENSION);
-}
-
-/**
- * Gets a file name without an extension and returns the name of the parsed input file with the .am extension.
- * 
- * @param file_name the file name without the extension (as given as command line argument)
- * @return the name of the parsed file with the extension, or NULL if a memory allocation failure occurred
- */
-char *get_parsed_file_name(char file_name[]) {
-    return get_file_name_with_extension(file_name, PARSED_EXTENSION);
+char *get_input_file_name(char file_name[], Arena *arena) {
+    return get_file_name_with_extension(file_name, INPUT_EXTENSION, arena);
 }
 
 /**
- * Returns a pointer to the input file with a read permission based on the extensionless file name.
- * Does so by getting the file name with the extension and opening the file based on the name with a read permission.
+ * Returns a pointer to the input file, mapped into the memory, based on the extensionless file name.
+ * Does so by getting the file name with the extension and opening the source-file based on the name.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the now-open file, or NULL if the file could not be opened
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return a pointer to the now-open source-file, or NULL if the file could not be opened
  */
-FILE *get_input_file(char file_name[]) {
-    FILE *input_file;
-    char *input_file_name = get_input_file_name(file_name);
+SourceFile *get_input_file(char file_name[], Arena *arena) {
+    SourceFile *input_file;
+    char *input_file_name = get_input_file_name(file_name, arena);
     if (input_file_name == NULL) return NULL;
-    input_file = fopen(input_file_name, "r");
-    if (input_file == NULL) {
-        printf("Error: Can't open file %s\n", input_file_name);
-        free(input_file_name);
-        return NULL;
-    }
-    free(input_file_name);
+    input_file = open_source_file(input_file_name);
+    if (input_file == NULL) console_printf("Error: Can't open file %s\n", input_file_name);
     return input_file;
 }
 
 /**
- * Returns a pointer to a new file with an append permission based on the extensionless file name, which should act
- * as the parsed macro-less file.
- * Assumes no file with this name (including the extension) exists in the directory.
- * Does so by getting the file name with the extension and opening the file based on the name with an append permission.
+ * Writes given contents into a new file with a given extension, based on the extensionless file name. If a file with
+ * this name already exists, its contents are replaced.
+ * Does so by getting the file name with the extension, opening the file based on the name while truncating it, writing
+ * the contents to it (normally with a single write call, unless the system writes only a part of them at a time) and
+ * closing it.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param extension the extension of the new file (including the period)
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_parsed_file_append(char file_name[]) {
-    FILE *parsed_file;
-    char *parsed_file_name = get_parsed_file_name(file_name);
-    if (parsed_file_name == NULL) return NULL;
-    /* since no file with the name exists, creates a new file */
-    parsed_file = fopen(parsed_file_name, "a");
-    if (parsed_file == NULL) {
-        printf("Error: Can't create file %s\n", parsed_file_name);
-        free(parsed_file_name);
-        return NULL;
+static int save_file(char file_name[], char extension[], char *contents, long length, Arena *arena) {
+    int descriptor;
+    /* the number of characters that were written so far */
+    long written = 0;
+    char *name_with_extension = get_file_name_with_extension(file_name, extension, arena);
+    if (name_with_extension == NULL) return 1;
+    descriptor = open(name_with_extension, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (descriptor == -1) {
+        console_printf("Error: Can't create file %s\n", name_with_extension);
+        return 1;
     }
-    free(parsed_file_name);
-    return parsed_file;
+    /* writes until all of the contents are written, since a write may be partial or interrupted by a signal */
+    while (written < length) {
+        ssize_t result = write(descriptor, contents + written, length - written);
+        if (result == -1 && errno == EINTR) continue;
+        if (result <= 0) {
+            console_printf("Error: Can't write to file %s\n", name_with_extension);
+            close(descriptor);
+            return 1;
+        }
+        written += result;
+    }
+    close(descriptor);
+    return 0;
 }
 
 /**
- * Returns a pointer to the parsed, macro-less file with a read permission based on the extensionless file name.
- * Does so by getting the file name with the extension and opening the file based on the name with a read permission.
+ * Creates the parsed macro-less file (.am) based on the extensionless file name, and writes given contents into it.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_parsed_file_read(char file_name[]) {
-    FILE *parsed_file;
-    char *parsed_file_name = get_parsed_file_name(file_name);
-    if (parsed_file_name == NULL) return NULL;
-    parsed_file = fopen(parsed_file_name, "r");
-    if (parsed_file == NULL) {
-        printf("Error: Can't open file %s\n", parsed_file_name);
-        free(parsed_file_name);
-        return NULL;
-    }
-    free(parsed_file_name);
-    return parsed_file;
+int save_parsed_file(char file_name[], char *contents, long length, Arena *arena) {
+    return save_file(file_name, PARSED_EXTENSION, contents, length, arena);
 }
 
 /**
- * Returns a pointer to the object file based on the extensionless file name.
- * Assumes no file with this name (including the extension) exists in the directory.
- * Does so by getting the file name with the extension and opening the file based on the name with an append permission.
+ * Creates the object file (.ob) based on the extensionless file name, and writes given contents into it.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_object_file(char file_name[]) {
-    FILE *object_file;
-    char *object_file_name = get_file_name_with_extension(file_name, OBJECT_EXTENSION);
-    if (object_file_name == NULL) return NULL;
-    /* since no file with the name exists, creates a new file */
-    object_file = fopen(object_file_name, "a");
-    if (object_file == NULL) {
-        printf("Error: Can't create file %s\n", object_file_name);
-        free(object_file_name);
-        return NULL;
-    }
-    free(object_file_name);
-    return object_file;
+int save_object_file(char file_name[], char *contents, long length, Arena *arena) {
+    return save_file(file_name, OBJECT_EXTENSION, contents, length, arena);
 }
 
 /**
- * Returns a pointer to the extern symbols file (.ext) based on the extensionless file name.
- * Assumes no file with this name (including the extension) exists in the directory.
- * Does so by getting the file name with the extension and opening the file based on the name with an append permission.
+ * Creates the extern symbols file (.ext) based on the extensionless file name, and writes given contents into it.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_extern_file(char file_name[]) {
-    FILE *extern_file;
-    char *extern_file_name = get_file_name_with_extension(file_name, EXTERN_EXTENSION);
-    if (extern_file_name == NULL) return NULL;
-    /* since no file with the name exists, creates a new file */
-    extern_file = fopen(extern_file_name, "a");
-    if (extern_file == NULL) {
-        printf("Error: Can't create file %s\n", extern_file_name);
-        free(extern_file_name);
-        return NULL;
-    }
-    free(extern_file_name);
-    return extern_file;
+int save_extern_file(char file_name[], char *contents, long length, Arena *arena) {
+    return save_file(file_name, EXTERN_EXTENSION, contents, length, arena);
 }
 
 /**
- * Returns a pointer to the entry symbols file (.ent) based on the extensionless file name.
- * Assumes no file with this name (including the extension) exists in the directory.
- * Does so by getting the file name with the extension and opening the file based on the name with an append permission.
+ * Creates the entry symbols file (.ent) based on the extensionless file name, and writes given contents into it.
  * 
  * @param file_name the name of the input file without the extension
- * @return a pointer to the new file, or NULL if the file could not be created
+ * @param contents  the characters that the file should hold
+ * @param length    the number of characters in contents
+ * @param arena     a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created or written, 0 otherwise
  */
-FILE *get_entry_file(char file_name[]) {
-    FILE *entry_file;
-    char *entry_file_name = get_file_name_with_extension(file_name, ENTRY_EXTENSION);
-    if (entry_file_name == NULL) return NULL;
-    /* since no file with the name exists, creates a new file */
-    entry_file = fopen(entry_file_name, "a");
-    if (entry_file == NULL) {
-        printf("Error: Can't create file %s\n", entry_file_name);
-        free(entry_file_name);
-        return NULL;
-    }
-    free(entry_file_name);
-    return entry_file;
+int save_entry_file(char file_name[], char *contents, long length, Arena *arena) {
+    return save_file(file_name, ENTRY_EXTENSION, contents, length, arena);
 }
 
 /**
  * Removes all output files (parsed, object, extern and entry) corresponding to a given extensionless file name.
- * Does so by getting the name of every every output file, removing the files based on their names, and freeing the
- * names.
+ * Does so by getting the name of every output file and removing the file based on its name.
  * 
  * @param file_name the name of the input file without the extension
+ * @param arena     a pointer to the arena that the names of the files should be allocated from
  */
-void remove_output_files(char file_name[]) {
-    char *parsed_file_name = get_parsed_file_name(file_name);
-    char *object_file_name = get_file_name_with_extension(file_name, OBJECT_EXTENSION);
-    char *extern_file_name = get_file_name_with_extension(file_name, EXTERN_EXTENSION);
-    char *entry_file_name = get_file_name_with_extension(file_name, ENTRY_EXTENSION);
-    remove(parsed_file_name);
-    remove(object_file_name);
-    remove(extern_file_name);
-    remove(entry_file_name);
-    free_all(4, parsed_file_name, object_file_name, extern_file_name, entry_file_name);
+void remove_output_files(char file_name[], Arena *arena) {
+    char *output_extensions[] = {PARSED_EXTENSION, OBJECT_EXTENSION, EXTERN_EXTENSION, ENTRY_EXTENSION};
+    int i;
+    for (i = 0; i < (int) (sizeof(output_extensions) / sizeof(output_extensions[0])); i++) {
+        char *output_file_name = get_file_name_with_extension(file_name, output_extensions[i], arena);
+        if (output_file_name != NULL) remove(output_file_name);
+    }
 }
@@ -1,13 +1,14 @@
 /**
  * Handles the first pass of the assembler over the parsed, macro-less file.
  * The first pass handles the encoding of everything that never depends on the values of any symbol: That includes 
- * the .data, .string and .extern directives and the first word of every instruction.
+ * the .data, .string and .extern directives, the first word of every instruction and every operand that is not
+ * a symbol.
  * In addition, the first pass checks for the legality of everything it encodes, 
- * as well as the legality of the syntax of an instruction (does not check that the content of the operands is legal,
- * but checks everything else in the instruction). It also builds the symbol table, and updates the faulty instructions
- * set - a set of line numbers that represent faulty instructions that shouldn't be encoded in the second pass.
+ * as well as the legality of the syntax of an instruction. It also builds the symbol table, and leaves a fixup for
+ * everything that can only be handled once the entire file has been read (symbol operands and .entry directives), so
+ * the second pass can finish the encoding without reading the file again.
  * The main function in this file is first_pass, which executes the assembler's first pass over a given file.
- * Assumes that the input .as file has already been parsed to a macro-less .am file.
+ * Assumes that the input .as file has already been parsed into the macro-less parsed source of its requirements.
  * Also assumes that a symbol can be defined as .extern more than once, since it doesn't not interfere with any
  * part of the assembly process.
  */
@@ -20,180 +21,489 @@
 #include "../headers/conversions.h"
 #include "../headers/util/string_ops.h"
 #include "../headers/util/general_util.h"
+#include "../headers/console.h"
+#include "../headers/lexer.h"
+#include "../headers/parsed_lines.h"
+#include "../headers/macro_lines.h"
+#include "../headers/encoding_cache.h"
+#include "../headers/alloc_failure_handler.h"
+#include "../headers/chunks.h"
+
+/**
+ * The smallest number of parsed lines that a chunk of a file may have, when the file is split into chunks that are
+ * handled at the same time.
+ */
+#define MIN_CHUNK_LINES 1024
+
+/**
+ * Represents a symbol of a chunk's symbol table while the chunk is merged into the file's requirements.
+ */
+typedef struct {
+    /* the handle of the symbol in the file's symbol table */
+    int handle;
+    /* whether the symbol is defined in the file's symbol table by the chunk (and not by an earlier chunk) */
+    unsigned defined_here : 1;
+} ChunkSymbol;
+
+/**
+ * Represents a chunk of a file's parsed lines, which the first pass handles on its own thread.
+ */
+typedef struct {
+    /* the state that every chunk shares, which the chunk's thread fills */
+    Chunk base;
+    /* the range of the parsed lines - from the first one to the one after the last */
+    int first_line;
+    int end_line;
+    /* the name of the input file that is being assembled (used for error reporting) */
+    char *input_file_name;
+    /* the chunk's requirements and the arena that its objects are allocated from */
+    Requirements *requirements;
+    Arena arena;
+    /* the values that the chunk's instruction and data counters should be rebased by */
+    int ic_offset;
+    int dc_offset;
+    /* the symbols of the chunk's symbol table, in the order of their handles (only used while merging) */
+    ChunkSymbol *symbols;
+} FirstPassChunk;
 
 /** PROTOTYPES FOR FUNCTIONS DEFINED LATER IN THE FILE **/
 /** FOR DOCUMENTATION, SEE DEFINITIONS **/
 
-static void insert_data_numbers(char *rest, char *parsed_file_name, int line_count, Requirements *requirements,
+static int first_pass_lines(int first_line, int end_line, char *input_file_name, Requirements *requirements);
+
+static int first_pass_in_chunks(char *input_file_name, Requirements *requirements);
+
+static int merge_chunks(FirstPassChunk *chunks, int chunk_count, Requirements *requirements);
+
+static int merge_chunk_symbols(FirstPassChunk *chunk, Requirements *requirements);
+
+static int merge_chunk_code(FirstPassChunk *chunk, Requirements *requirements);
+
+static void insert_data_numbers(char *rest, char *input_file_name, int line_count, Requirements *requirements,
                          int *error_found);
 
 static void insert_symbol(char *symbol, SymbolType type, SymbolLocation location, Requirements *requirements,
-                   int *error_found, int line_count, char *parsed_file_name);
+                   int *error_found, int line_count, char *input_file_name);
 
-static int check_and_handle_directive(char *line, char *label_name, int line_count, char *parsed_file_name, int *error_found,
-                               Requirements *requirements);
+static void handle_directive(ParsedLine *line, char *label_name, int line_count, char *input_file_name,
+                             int *error_found, Requirements *requirements);
 
-static void handle_extern(char *rest, char *label_name, int line_count, char *parsed_file_name, int *error_found,
+static void handle_extern(char *rest, char *label_name, int line_count, char *input_file_name, int *error_found,
                    Requirements *requirements);
 
-static void insert_string(char *rest, int line_count, char *parsed_file_name, int *error_found, Requirements *requirements);
+static void insert_string(char *rest, int line_count, char *input_file_name, int *error_found, Requirements *requirements);
+
+static void handle_entry(char *rest, char *label_name, int line_count, int *error_found, Requirements *requirements);
 
-static void first_pass_handle_instruction(char *line, char *label_name, int line_count, char *parsed_file_name, int *error_found,
-                        Requirements *requirements);
+static void first_pass_handle_instruction(ParsedLine *line, char *label_name, int line_count, char *input_file_name,
+                                          int *error_found, Requirements *requirements);
 
-static void first_pass_handle_two_operand_instruction(Operator op, char *rest, int line_count, char *parsed_file_name,
+static void first_pass_handle_two_operand_instruction(ParsedLine *line, int line_count, char *input_file_name,
                                     int *error_found, Requirements *requirements);
 
-static void first_pass_handle_one_operand_instruction(Operator op, char *rest, int line_count, char *parsed_file_name,
+static void first_pass_handle_one_operand_instruction(ParsedLine *line, int line_count, char *input_file_name,
                                     int *error_found, Requirements *requirements);
 
-static void handle_zero_operand_instruction(Operator op, char *rest, int line_count, char *parsed_file_name,
+static void handle_zero_operand_instruction(ParsedLine *line, int line_count, char *input_file_name,
                                      int *error_found, Requirements *requirements);
 
-static int has_comment_start(char *line, int line_count, char *parsed_file_name, int *error_found);
+static int report_operand_error(ParsedLine *line, int line_count, char *input_file_name, int *error_found);
 
-static int blank_after_label(char *line, int line_count, char *parsed_file_name, int *error_found);
+static void record_macro_line(ParsedLine *line, int first_address, int first_fixup, Requirements *requirements);
 
-static int is_data_symbol(SymbolContent symbol);
+static char *build_cache_key(ParsedLine *line, char key[], Requirements *requirements);
 
+static void insert_words(const unsigned short words[], int word_count, int line_count, char *input_file_name,
+                         int *error_found, Requirements *requirements);
+
+static void stamp_macro_line(MacroLine *macro_line, int line_count, char *input_file_name, int *error_found,
+                             Requirements *requirements);
+
+static void insert_operand_word(char *operand, AddressMethod address_method, int is_source, int line_count,
+                                char *input_file_name, int *error_found, Requirements *requirements);
+
+static void insert_combined_operand_word(char *source_operand, char *destination_operand,
+                                         AddressMethod source_method, AddressMethod destination_method,
+                                         int line_count, char *input_file_name, int *error_found,
+                                         Requirements *requirements);
+
+/**
+ * Copies a part of a parsed line from the parsed source into a given array, followed by a terminating 0.
+ * 
+ * @param line         a pointer to the parsed line
+ * @param part         the part to be copied
+ * @param buffer       an array which can hold the part plus one character
+ * @param requirements a pointer to the requirements for the file
+ * @return buffer
+ */
+static char *copy_line_part(ParsedLine *line, LinePart part, char buffer[], Requirements *requirements) {
+    memcpy(buffer, requirements->parsed_source->text + line->start + part.offset, part.length);
+    buffer[part.length] = '\0';
+    return buffer;
+}
 
 /**
  * Executes the first pass of the assembler over a parsed, macro-less file.
  * Handles the encoding of everything that never depends on the values of any symbol: That includes 
- * the .data, .string and .extern directives and the first word of every instruction.
+ * the .data, .string and .extern directives, the first word of every instruction and every operand that is not
+ * a symbol. Leaves a fixup for every symbol operand and .entry directive, which are handled by the second pass.
  * In addition, the first pass checks for the legality of everything it encodes, 
- * as well as the legality of the syntax of an instruction (does not check that the content of the operands is legal,
- * but checks everything else in the instruction).
- * Assumes that the input .as file has already been parsed to a macro-less .am file.
+ * as well as the legality of the syntax of an instruction. Errors in the content of operands are left for the
+ * second pass, so they are reported in order with the errors of the symbols.
+ * Assumes that the input .as file has already been parsed into the macro-less parsed source of its requirements,
+ * along with its parsed lines.
  * 
- * The function reads the file's lines one by one.
- * For each one, skips it if it's blank or a comment and throws an error if it a comment starts mid-line.
- * It then finds the label, and makes sure the part after the label is not empty. Then it checks if the line is a
- * directive, and if so, handles it and inserts its label into the symbol table if necessary.
- * Otherwise, handles it as an instruction and inserts its label into the symbol table if necessary.
- * After reading the entire file, increases the value of every data symbol by IC.
+ * If the file may be handled by several threads and it is long enough, its parsed lines are first split into chunks
+ * that are handled at the same time (see first_pass_in_chunks). If that fails for any reason - including an error in
+ * the file, which should be reported exactly as in a single run over the file - the lines are handled by a single run
+ * over the file instead.
  * 
  * @param file_name    the extension-less file name
  * @param requirements a pointer to the requirements for the assembly of the file
  * @return 1 if any error in the file was found, 0 otherwise
  */
 int first_pass(char file_name[], Requirements *requirements) {
-    char *parsed_file_name = get_parsed_file_name(file_name);
-    FILE *parsed_file = get_parsed_file_read(file_name);
+    char *input_file_name = get_input_file_name(file_name, requirements->arena);
+    /* makes sure the input file name is not null (no allocation failure occurred) */
+    if (input_file_name == NULL) {
+        return 1;
+    }
+    if (requirements->thread_count > 1 && first_pass_in_chunks(input_file_name, requirements)) return 0;
+    /* if a memory allocation failure has occurred while the chunks were handled, stops */
+    if (is_alloc_failure()) return 1;
+    return first_pass_lines(0, requirements->parsed_line_count, input_file_name, requirements);
+}
+
+/**
+ * Executes the first pass over a range of the parsed lines of a file.
+ * 
+ * The function goes over the parsed lines one by one, which were already lexed by the pre-assembler, so the text of a
+ * line is only read for the parts that are handled (see ParsedLine). Blank lines and comments have no parsed lines.
+ * Based on the kind of the line, throws an error if a comment starts mid-line or if the line has nothing but a label.
+ * Otherwise, if the line is a directive, handles it and inserts its label into the symbol table if necessary, and if
+ * it's an instruction, handles it and inserts its label into the symbol table if necessary.
+ * Errors are reported with the number of the line in the input file that the parsed line comes from. A line that was
+ * stamped out from a line of a macro's content is only reported once - if an error is found in it, the same line is
+ * skipped at the macro's later usages.
+ * The values of data symbols are left relative to the start of the data portion, since its start is only known once
+ * the entire file has been read (see get_symbol_address).
+ * 
+ * @param first_line      the index of the first parsed line to be handled
+ * @param end_line        the index of the parsed line after the last one to be handled
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param requirements    a pointer to the requirements that the lines should be encoded into
+ * @return 1 if any error in the lines was found, 0 otherwise
+ */
+static int first_pass_lines(int first_line, int end_line, char *input_file_name, Requirements *requirements) {
     int error_found = 0;
-    /* the number of the line being read */
-    int line_count = 0;
-    /* the line being read */
-    char line_read[MAX_LINE_LENGTH + 1];
+    /* whether an error has been found in the line being handled */
+    int line_error;
+    /* the number of the line being handled in the input file */
+    int line_count;
+    /* the line being handled, and the line of a macro's content that it was stamped out from (if there is one) */
+    ParsedLine *line;
+    MacroLine *macro_line;
+    /* the array that holds the line's label */
+    char label_buffer[MAX_LINE_LENGTH + 1];
     /* the line's label */
     char *label;
-    /* makes sure the parsed file name is not null (no allocation failure occurred) */
-    if (parsed_file_name == NULL) {
-        return 1;
-    }
-    /* makes sure the parsed file is not null, if it is then the file can't be encoded */
-    if (!parsed_file) {
-        free(parsed_file_name);
-        return 1;
-    }
+    int i;
     /* for each line */
-    while (!feof(parsed_file)) {
-        /* a pointer version of line_read that can have a pointer reference it */
-        char *line;
-        line_count++;
-        read_line(parsed_file, parsed_file_name, line_count, line_read);
-        line = line_read;
-        /* if the line is blank, skips to the next line */
-        if (is_line_blank(line)) continue;
-        /* if the line is a comment, skips to the next line */
-        if (line[0] == COMMENT_START) continue;
-        /* if the line has a comment starting mid-line, skips to the next line and throws an error */
-        if (has_comment_start(line, line_count, parsed_file_name, &error_found)) continue;
-        /* default value in case there is no label */
-        label = NULL;
-        /* finds the label and changes line to be the part after the label */
-        find_label(&line, &label);
-        /* makes sure that the line is not a blank line with a label */
-        if (label != NULL && blank_after_label(line, line_count, parsed_file_name, &error_found)) {
-            free(label);
+    for (i = first_line; i < end_line; i++) {
+        line = &requirements->parsed_lines[i];
+        line_count = line->source_line;
+        macro_line = line->macro_line == -1 ? NULL : &requirements->macro_lines[line->macro_line];
+        /* if the line's error was already reported at an earlier usage of its macro, skips to the next line */
+        if (macro_line != NULL && macro_line->state == FAILED_MACRO_LINE) {
+            error_found = 1;
             continue;
         }
-        /* checks if the line is a directive and handles it if it is */
-        if (check_and_handle_directive(line, label, line_count, parsed_file_name, &error_found,
-                                       requirements)) {
-            continue;
+        line_error = 0;
+        /* if the line has a comment starting mid-line, throws an error */
+        if (line->kind == MISPLACED_COMMENT_LINE) {
+            console_printf("Input Error: Semicolon signifying a comment appears after the first character in line %d "
+                           "of file %s\n", line_count, input_file_name);
+            line_error = 1;
         }
-        /* otherwise the line must be an instruction (if it is valid) */
-        first_pass_handle_instruction(line, label, line_count, parsed_file_name, &error_found, requirements);
+        /* if the line has nothing but a label, throws an error */
+        else if (line->kind == LABEL_ONLY_LINE) {
+            console_printf("Input Error: Line %d of file %s is empty but has a label\n", line_count, input_file_name);
+            line_error = 1;
+        }
+        else {
+            label = line->has_label ? copy_line_part(line, line->label, label_buffer, requirements) : NULL;
+            if (line->kind == INSTRUCTION_LINE) {
+                first_pass_handle_instruction(line, label, line_count, input_file_name, &line_error, requirements);
+            }
+            else handle_directive(line, label, line_count, input_file_name, &line_error, requirements);
+        }
+        if (line_error && macro_line != NULL) macro_line->state = FAILED_MACRO_LINE;
+        error_found |= line_error;
     }
-    /* increases the value of every data symbol by IC */
-    map_add_to_all_that_apply(requirements->symbol_table, requirements->ic, is_data_symbol);
-    fclose(parsed_file);
-    free(parsed_file_name);
     /* if no error was found, error_found has not been changed, therefore returns 0. otherwise its value is 1 */
     return error_found;
 }
 
+/**
+ * Handles a chunk on its own thread (see run_chunks): executes the first pass over the chunk's lines into the chunk's
+ * requirements.
+ *
+ * @param arg a pointer to the chunk
+ * @return 1 if any error was found in the chunk's lines, 0 otherwise
+ */
+static int first_pass_chunk(void *arg) {
+    FirstPassChunk *chunk = (FirstPassChunk *) arg;
+    return first_pass_lines(chunk->first_line, chunk->end_line, chunk->input_file_name, chunk->requirements);
+}
+
+/**
+ * Executes the first pass over the parsed lines of a file by splitting them into chunks at line boundaries and
+ * handling the chunks at the same time, each on its own thread and into its own requirements - starting from empty
+ * counters and an empty symbol table. Once all of the chunks are done, the sizes of their memory images are summed
+ * up in order to find the address that every chunk starts from, and the chunks are merged into the file's
+ * requirements in order (see merge_chunks).
+ * The result is only used if no chunk found an error and the chunks could be merged without a conflict between them,
+ * in which case it is the same as the result of a single run over the file, and the messages of the chunks (which can
+ * only be warnings) are printed in order. Otherwise, nothing is changed, so the file can be handled by a single run,
+ * which reports the errors in order.
+ * A file is only split if every chunk would have at least MIN_CHUNK_LINES lines.
+ *
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param requirements    a pointer to the requirements for the file
+ * @return 1 if the lines were handled without errors and merged into the requirements, 0 otherwise
+ */
+static int first_pass_in_chunks(char *input_file_name, Requirements *requirements) {
+    int chunk_count = requirements->parsed_line_count / MIN_CHUNK_LINES;
+    FirstPassChunk *chunks;
+    /* the number of chunks that were prepared */
+    int prepared;
+    int merged = 0;
+    int i;
+    if (chunk_count > requirements->thread_count) chunk_count = requirements->thread_count;
+    if (chunk_count < 2) return 0;
+    chunks = calloc(chunk_count, sizeof(FirstPassChunk));
+    if (chunks == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when splitting file into chunks\n");
+        set_alloc_failure();
+        return 0;
+    }
+    /* splits the lines as evenly as possible */
+    for (prepared = 0; prepared < chunk_count; prepared++) {
+        FirstPassChunk *chunk = &chunks[prepared];
+        chunk->first_line = (int) ((long) requirements->parsed_line_count * prepared / chunk_count);
+        chunk->end_line = (int) ((long) requirements->parsed_line_count * (prepared + 1) / chunk_count);
+        chunk->input_file_name = input_file_name;
+        init_arena(&chunk->arena);
+        chunk->requirements = create_chunk_requirements(requirements, &chunk->arena);
+        chunk->base.output = tmpfile();
+        if (is_alloc_failure() || chunk->base.output == NULL) break;
+    }
+    /* the chunks are only merged if all of them were prepared and handled without errors */
+    if (prepared == chunk_count && run_chunks(chunks, chunk_count, sizeof(FirstPassChunk), first_pass_chunk)) {
+        merged = 1;
+        for (i = 0; i < chunk_count; i++) {
+            if (chunks[i].base.alloc_failure || chunks[i].base.error_found) merged = 0;
+        }
+        if (merged) merged = merge_chunks(chunks, chunk_count, requirements);
+    }
+    close_chunks(chunks, chunk_count, sizeof(FirstPassChunk), merged);
+    /* a chunk that was not prepared holds nothing, so it is freed like the rest */
+    for (i = 0; i < chunk_count; i++) {
+        free(chunks[i].symbols);
+        free_chunk_requirements(chunks[i].requirements);
+        release_arena(&chunks[i].arena);
+    }
+    free(chunks);
+    return merged;
+}
+
+/**
+ * Merges the chunks of a file, which were handled without errors, into the file's requirements.
+ * Does so by first finding the values that every chunk's counters should be rebased by, which are the sums of the
+ * sizes of the instruction and data portions of the chunks before it, and making sure that the memory image of the
+ * entire file fits in the memory. Then merges the chunks' symbol tables in order, which finds any conflict between
+ * the symbols of different chunks, and only if there is none, appends the chunks' memory images and fixups in order.
+ * If the chunks can't be merged, the file's requirements are left as they were before the first pass.
+ *
+ * @param chunks       the list of chunks, in the order of their lines
+ * @param chunk_count  the number of chunks
+ * @param requirements a pointer to the requirements for the file
+ * @return 1 if the chunks were merged, 0 otherwise
+ */
+static int merge_chunks(FirstPassChunk *chunks, int chunk_count, Requirements *requirements) {
+    int ic = requirements->ic;
+    int dc = requirements->dc;
+    int i;
+    for (i = 0; i < chunk_count; i++) {
+        chunks[i].ic_offset = ic - IC_START;
+        chunks[i].dc_offset = dc;
+        ic += chunks[i].requirements->ic - IC_START;
+        dc += chunks[i].requirements->dc;
+    }
+    /* if the memory image does not fit in the memory, a single run reports the words that don't fit */
+    if (ic + dc > MEMORY_SIZE) return 0;
+    for (i = 0; i < chunk_count; i++) {
+        if (merge_chunk_symbols(&chunks[i], requirements)) {
+            /* empties the symbol table, since it might only be filled in part */
+            free_map(requirements->symbol_table);
+            requirements->symbol_table = create_map(SYMBOL);
+            requirements->extern_symbols.count = 0;
+            requirements->extern_symbols.max_name_length = 0;
+            /* if the table could not be created, makes sure that the first pass stops instead of falling back to a
+             * single run over the file, which needs the table */
+            if (requirements->symbol_table == NULL) set_alloc_failure();
+            return 0;
+        }
+    }
+    for (i = 0; i < chunk_count; i++) {
+        if (merge_chunk_code(&chunks[i], requirements)) return 0;
+    }
+    for (i = 0; i < chunk_count; i++) {
+        requirements->encoding_cache->hits += chunks[i].requirements->encoding_cache->hits;
+        requirements->encoding_cache->misses += chunks[i].requirements->encoding_cache->misses;
+    }
+    return 1;
+}
+
+/**
+ * Merges the symbol table of a chunk into the symbol table of the file, after the chunks before it were merged.
+ * Every symbol of the chunk is matched with the symbol of the same name in the file's table, which is added if there
+ * is no such symbol. A symbol that is defined in the chunk is rebased and fills the file's symbol if it is not defined
+ * yet, in which case it is defined by the chunk. If the file's symbol is defined as well, the symbol is defined twice,
+ * which is a conflict, unless both are external symbols (a repeated declaration, which leaves the symbol as it is).
+ * Then, the chunk's external symbols that it defines are added to the index of external symbols, in the order of
+ * their declarations.
+ *
+ * @param chunk        a pointer to the chunk
+ * @param requirements a pointer to the requirements for the file
+ * @return 0 if the symbols were merged, 1 if there is a conflict or an allocation failure has occurred
+ */
+static int merge_chunk_symbols(FirstPassChunk *chunk, Requirements *requirements) {
+    HashMap *chunk_table = chunk->requirements->symbol_table;
+    SymbolIndex *chunk_externs = &chunk->requirements->extern_symbols;
+    SymbolContent content;
+    SymbolContent *existing;
+    char *name;
+    int handle;
+    int i;
+    if (chunk_table->item_count == 0) return 0;
+    chunk->symbols = malloc(chunk_table->item_count * sizeof(ChunkSymbol));
+    if (chunk->symbols == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when merging symbol tables\n");
+        set_alloc_failure();
+        return 1;
+    }
+    for (i = 0; i < chunk_table->item_count; i++) {
+        name = map_get_name_at(chunk_table, i);
+        content = *map_get_symbol_at(chunk_table, i);
+        if (content.location == CODE) content.value += chunk->ic_offset;
+        else if (content.location == DATA) content.value += chunk->dc_offset;
+        handle = map_find_handle(requirements->symbol_table, name);
+        chunk->symbols[i].defined_here = 0;
+        if (handle == -1) {
+            /* the file's table gets its own copy of the name, since the chunk's arena is released */
+            name = view_duplicate(view_of(name), requirements->arena);
+            if (name == NULL || (handle = map_add_symbol(requirements->symbol_table, name, content)) == -1) return 1;
+            chunk->symbols[i].defined_here = content.defined;
+        }
+        else if (content.defined) {
+            existing = map_get_symbol_at(requirements->symbol_table, handle);
+            if (!existing->defined) {
+                *existing = content;
+                chunk->symbols[i].defined_here = 1;
+            }
+            else if (existing->type != EXTERNAL || content.type != EXTERNAL) return 1;
+        }
+        chunk->symbols[i].handle = handle;
+    }
+    for (i = 0; i < chunk_externs->count; i++) {
+        ChunkSymbol *symbol = &chunk->symbols[chunk_externs->handles[i]];
+        if (symbol->defined_here && add_to_symbol_index(&requirements->extern_symbols, symbol->handle,
+                                                        map_get_name_at(requirements->symbol_table, symbol->handle))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Appends the memory image and fixups of a chunk to the ones of the file, after the chunks before it were appended.
+ * The fixups' addresses are rebased, their handles are replaced by the handles of the file's symbols, and their
+ * symbols are copied into the file's arena, since the chunk's arena is released.
+ *
+ * @param chunk        a pointer to the chunk, whose symbols should already be merged
+ * @param requirements a pointer to the requirements for the file
+ * @return 0 if the chunk was appended, 1 if an allocation failure has occurred
+ */
+static int merge_chunk_code(FirstPassChunk *chunk, Requirements *requirements) {
+    Requirements *chunk_requirements = chunk->requirements;
+    int word_count = chunk_requirements->ic - IC_START;
+    Fixup fixup;
+    int i;
+    memcpy(&requirements->instruction_array[requirements->ic], &chunk_requirements->instruction_array[IC_START],
+           word_count * sizeof(unsigned short));
+    requirements->ic += word_count;
+    memcpy(&requirements->data_array[requirements->dc], chunk_requirements->data_array,
+           chunk_requirements->dc * sizeof(unsigned short));
+    requirements->dc += chunk_requirements->dc;
+    for (i = 0; i < chunk_requirements->fixup_count; i++) {
+        fixup = chunk_requirements->fixups[i];
+        fixup.symbol = view_duplicate(view_of(fixup.symbol), requirements->arena);
+        if (fixup.symbol == NULL) return 1;
+        if (fixup.handle != -1) fixup.handle = chunk->symbols[fixup.handle].handle;
+        if (fixup.address != -1) fixup.address += chunk->ic_offset;
+        if (add_fixup(requirements, fixup)) return 1;
+    }
+    return 0;
+}
+
 /**
  * Reads the data values from a .data directive and inserts them into the memory image while finding errors.
  * 
  * Does so by splitting the string based on commas to find the arguments, trimming each one to remove whitespaces at the
  * start and the end, finding the integer value of each one, verifying it, and inserting it to the memory.
  * 
- * @param rest             the part of the line that should contain only the values to insert (the part after .data)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param requirements     a pointer to the requirements for the file
- * @param error_found      a pointer to a value that represents whether an error has been found
+ * @param rest            the part of the line that should contain only the values to insert (the part after .data)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param requirements    a pointer to the requirements for the file
+ * @param error_found     a pointer to a value that represents whether an error has been found
  */
-static void insert_data_numbers(char *rest, char *parsed_file_name, int line_count,
+static void insert_data_numbers(char *rest, char *input_file_name, int line_count,
                          Requirements *requirements, int *error_found) {
-    /* the current argument for the directive */
-    char *arg = NULL;
-    /* the trimmed version of the argument (without whitespaces at the start and the end */
-    char *trimmed_arg;
+    /* the trimmed version of the current argument (without whitespaces at the start and the end) */
+    char trimmed_arg[MAX_LINE_LENGTH + 1];
     /* verifies that the argument list is not empty */
     if (is_line_blank(rest)) {
-        printf("Input Error: .data directive in line %d of file %s has no arguments\n", line_count, parsed_file_name);
+        console_printf("Input Error: .data directive in line %d of file %s has no arguments\n",
+                       line_count, input_file_name);
         *error_found = 1;
         return;
     }
     /* verifies that the argument list does not start with a comma */
     if (first_non_blank(rest) == *DATA_SEPARATOR) {
-        printf("Input Error: .data directive in line %d of file %s starts with an illegal comma\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: .data directive in line %d of file %s starts with an illegal comma\n",
+                       line_count, input_file_name);
         *error_found = 1;
         return;
     }
     /* verifies that the argument list does not end with a comma */
     if (last_non_blank(rest) == *DATA_SEPARATOR) {
-        printf("Input Error: .data directive in line %d of file %s ends with an illegal comma\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: .data directive in line %d of file %s ends with an illegal comma\n",
+                       line_count, input_file_name);
         *error_found = 1;
         return;
     }
     /* verifies that the argument list does not include multiple consecutive commas, including ones with whitespaces
      * between them */
     if (includes_consecutive(rest, *DATA_SEPARATOR)) {
-        printf("Input Error: .data directive in line %d of file %s includes multiple consecutive commas\n",
-               line_count, parsed_file_name);
-        *error_found = 1;
-        return;
-    }
-    /* finds and times the argument */
-    arg = find_token(rest, DATA_SEPARATOR, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (arg == NULL) {
-        *error_found = 1;
-        return;
-    }
-    trimmed_arg = trim(arg);
-    free(arg);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (trimmed_arg == NULL) {
+        console_printf("Input Error: .data directive in line %d of file %s includes multiple consecutive commas\n",
+                       line_count, input_file_name);
         *error_found = 1;
         return;
     }
+    /* finds and trims the argument */
+    view_copy(trim_view(next_token(rest, DATA_SEPARATOR, &rest)), trimmed_arg);
     /* for each argument (until the argument is not empty) */
     while (!is_line_blank(trimmed_arg)) {
         /* the int value of the argument */
@@ -201,50 +511,33 @@ static void insert_data_numbers(char *rest, char *parsed_file_name, int line_cou
         /* if the argument includes whitespaces (which are necessarily not the start or the end), it must be made of
          * two arguments without a comma between them */
         if (strpbrk(trimmed_arg, BLANKS)) {
-            printf("Input Error: Missing comma in .data directive in line %d of file %s\n",
-                   line_count, parsed_file_name);
+            console_printf("Input Error: Missing comma in .data directive in line %d of file %s\n",
+                           line_count, input_file_name);
             *error_found = 1;
-            free(trimmed_arg);
             return;
         }
         /* verifies that the argument is an integer */
         if (!is_integer(trimmed_arg)) {
-            printf("Input Error: argument \"%s\" of .data directive in line %d of file %s is not an integer\n",
-                   trimmed_arg, line_count, parsed_file_name);
+            console_printf("Input Error: argument \"%s\" of .data directive in line %d of file %s is not an integer\n",
+                           trimmed_arg, line_count, input_file_name);
             *error_found = 1;
-            free(trimmed_arg);
             return;
         }
         value = atoi(trimmed_arg);
         /* verifies that the argument's integer value is within the limits of the machine */
         if (value > MAX_WORD_SIZE || value < MIN_WORD_SIZE) {
-            printf("Input Error: argument \"%s\" of .data directive in line %d of file %s is not "
-                   "within the machine's memory cell bounds\n", trimmed_arg, line_count, parsed_file_name);
+            console_printf("Input Error: argument \"%s\" of .data directive in line %d of file %s is not "
+                           "within the machine's memory cell bounds\n", trimmed_arg, line_count, input_file_name);
             *error_found = 1;
-            free(trimmed_arg);
             return;
         }
         value = DATA_NUM_TO_WORD(value);
         /* inserts the data to the memory image while updating the value of error_found to 1 if an error is found
          * in the inserting process */
-        *error_found |= memory_insert_data(requirements, value, line_count, parsed_file_name);
-        free(trimmed_arg);
+        *error_found |= memory_insert_data(requirements, value, line_count, input_file_name);
         /* the next argument */
-        arg = find_token(rest, DATA_SEPARATOR, &rest);
-        /* if a memory allocation failure has occurred, updates the error flag and stops */
-        if (arg == NULL) {
-            *error_found = 1;
-            return;
-        }
-        trimmed_arg = trim(arg);
-        free(arg);
-        /* if a memory allocation failure has occurred, updates the error flag and stops */
-        if (trimmed_arg == NULL) {
-            *error_found = 1;
-            return;
-        }
+        view_copy(trim_view(next_token(rest, DATA_SEPARATOR, &rest)), trimmed_arg);
     }
-    free(trimmed_arg);
 }
 
 /**
@@ -258,65 +551,55 @@ static void insert_data_numbers(char *rest, char *parsed_file_name, int line_cou
  * argument are double quotes, and for every character except for these, inserts the ascii value of the 
  * character to memory.
  * 
- * @param rest             the part of the line after .string
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param rest            the part of the line after .string
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
  */
-static void insert_string(char *rest, int line_count, char *parsed_file_name, int *error_found, Requirements *requirements) {
+static void insert_string(char *rest, int line_count, char *input_file_name, int *error_found, Requirements *requirements) {
     /* the part of the line after .string without heading and trailing whitespaces */
-    char *trimmed_rest;
-    /* the length of the part after .string without heading and trailing whitespaces */
-    int trimmed_rest_length;
+    StringView trimmed_rest;
     /* the index of the character being read in trimmed_rest */
     int i;
     /* verifies that there is an argument */
     if (is_line_blank(rest)) {
-        printf("Input Error: Missing argument for .string directive in line %d of"
-               "file %s\n", line_count, parsed_file_name);
+        console_printf("Input Error: Missing argument for .string directive in line %d of"
+                       "file %s\n", line_count, input_file_name);
         *error_found = 1;
         return;
     }
     /* verifies that the first non-whitespace character of the argument is double quotes */
     if (first_non_blank(rest) != STRING_START_AND_END) {
-        printf("Input Error: Argument for .string directive in line %d of file %s does not start with "
-               "double quotation marks\n", line_count, parsed_file_name);
+        console_printf("Input Error: Argument for .string directive in line %d of file %s does not start with "
+                       "double quotation marks\n", line_count, input_file_name);
         *error_found = 1;
         return;
     }
     /* verifies that the last non-whitespace character of the argument is double quotes */
     if (last_non_blank(rest) != STRING_START_AND_END) {
-        printf("Input Error: Argument for .string directive in line %d of file %s does not end with "
-               "double quotation marks\n", line_count, parsed_file_name);
-        *error_found = 1;
-        return;
-    }
-    /* trims the argument and finds its length */
-    trimmed_rest = trim(rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (trimmed_rest == NULL) {
+        console_printf("Input Error: Argument for .string directive in line %d of file %s does not end with "
+                       "double quotation marks\n", line_count, input_file_name);
         *error_found = 1;
         return;
     }
-    trimmed_rest_length = strlen(trimmed_rest);
+    /* trims the argument */
+    trimmed_rest = trim_view(view_of(rest));
     /* verifies that the argument is not a single set of quotation marks, which would pass the previous checks */
-    if (trimmed_rest_length == 1) {
-        printf("Input Error: Argument for .string directive in line %d of file %s is not wrapped by two "
-               "sets of quotation marks\n", line_count, parsed_file_name);
+    if (trimmed_rest.length == 1) {
+        console_printf("Input Error: Argument for .string directive in line %d of file %s is not wrapped by two "
+                       "sets of quotation marks\n", line_count, input_file_name);
         *error_found = 1;
-        free(trimmed_rest);
         return;
     }
     /* foe every character in the argument besides the first and last (the quotation marks), inserts their
      * unsigned short ascii value to the memory, and changes the value of error_found to 1 if an error is found
      * in the process */
-    for (i = 1; i < trimmed_rest_length - 1; i++) {
-        unsigned short value = DATA_NUM_TO_WORD(trimmed_rest[i]);
-        *error_found |= memory_insert_data(requirements, value, line_count, parsed_file_name);
+    for (i = 1; i < trimmed_rest.length - 1; i++) {
+        unsigned short value = DATA_NUM_TO_WORD(trimmed_rest.start[i]);
+        *error_found |= memory_insert_data(requirements, value, line_count, input_file_name);
     }
-    *error_found |= memory_insert_data(requirements, 0, line_count, parsed_file_name);
-    free(trimmed_rest);
+    *error_found |= memory_insert_data(requirements, 0, line_count, input_file_name);
 }
 
 /**
@@ -325,150 +608,170 @@ static void insert_string(char *rest, int line_count, char *parsed_file_name, in
  * part of the assembly process.
  * 
  * Does so by making sure that the symbol is not already defined, setting its value to either the instruction counter
- * or data counter if the location is known, or 0 if it's external, then adding it to the symbol table with the given
- * parameters.
+ * or data counter if the location is known, or 0 if it's external, then filling its item in the symbol table with the
+ * given parameters - either the item it got when it was first referenced, or a new one. A new item gets its own copy
+ * of the name, so the given name may be a part of the line.
+ * An external symbol is also added to the index of external symbols, unless it has already been declared.
  * 
- * @param symbol           the name of the symbol (without a colon)
- * @param type             the type of the symbol (regular, external or entry)
- * @param location         the location of the symbol (code or data)
- * @param requirements     a pointer to the requirements for the file
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
+ * @param symbol          the name of the symbol (without a colon)
+ * @param type            the type of the symbol (regular, external or entry)
+ * @param location        the location of the symbol (code or data)
+ * @param requirements    a pointer to the requirements for the file
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
  */
 static void insert_symbol(char *symbol, SymbolType type, SymbolLocation location, Requirements *requirements,
-                   int *error_found, int line_count, char *parsed_file_name) {
+                   int *error_found, int line_count, char *input_file_name) {
     /* the content of the symbol to be added */
     SymbolContent content;
+    /* the name of the symbol in the symbol table */
+    char *table_name;
+    /* the handle of the symbol in the symbol table, or -1 if it has not been referenced yet */
+    int handle;
+    /* the symbol already defined with the same name, if there is one */
+    SymbolContent *existing = NULL;
     /* makes sure the symbol's name is legal */
     if (!legal_label_name(symbol)) {
-        printf("Input Error: Label in line %d of file %s has an illegal name\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: Label in line %d of file %s has an illegal name\n",
+                       line_count, input_file_name);
         *error_found = 1;
         return;
     }
     /* makes sure that the symbol is not already defined in the file, unless it's a double-definition of an external
      * symbol, which is assumed to be legal */
-    if (map_contains(requirements->symbol_table, symbol)) {
-        if (type == EXTERNAL && map_get_symbol(requirements->symbol_table, symbol)->type != EXTERNAL) {
-            printf("Input Error: Symbol \"%s\" given as a parameter for .extern in line %d of file %s is "
-                   "already defined in the file\n", symbol, line_count, parsed_file_name);
+    handle = map_find_handle(requirements->symbol_table, symbol);
+    if (handle != -1 && map_get_symbol_at(requirements->symbol_table, handle)->defined) {
+        existing = map_get_symbol_at(requirements->symbol_table, handle);
+        if (type == EXTERNAL && existing->type != EXTERNAL) {
+            console_printf("Input Error: Symbol \"%s\" given as a parameter for .extern in line %d of file %s is "
+                           "already defined in the file\n", symbol, line_count, input_file_name);
             *error_found = 1;
-            free(symbol);
             return;
         } else if (type != EXTERNAL) {
-            printf("Input Error: Label %s in line %d of file %s is already defined\n",
-                   symbol, line_count, parsed_file_name);
+            console_printf("Input Error: Label %s in line %d of file %s is already defined\n",
+                           symbol, line_count, input_file_name);
             *error_found = 1;
-            free(symbol);
             return;
         }
+        /* a repeated declaration of an external symbol leaves the symbol as it is */
+        return;
     }
     /* makes sure the symbol has not already been defined as a macro */
     if (map_contains(requirements->macro_table, symbol)) {
         if (type == EXTERNAL) {
-            printf("Input Error: Symbol \"%s\" given as a parameter for .extern in line %d of file %s was "
-                   "already defined as a macro\n", symbol, line_count, parsed_file_name);
+            console_printf("Input Error: Symbol \"%s\" given as a parameter for .extern in line %d of file %s was "
+                           "already defined as a macro\n", symbol, line_count, input_file_name);
         }
         else {
-            printf("Input Error: Label %s in line %d of file %s was already defined as a macro\n",
-                   symbol, line_count, parsed_file_name);
+            console_printf("Input Error: Label %s in line %d of file %s was already defined as a macro\n",
+                           symbol, line_count, input_file_name);
         }
         *error_found = 1;
-        free(symbol);
         return;
     }
     /* sets the attributes of the symbol based on the given parameters */
     content.type = type;
     content.location = location;
+    content.defined = 1;
     /* sets the value to ic, dc or 0 based on the known or unknown location in the memory image */
     if (location == CODE) content.value = requirements->ic;
     else if (location == DATA) content.value = requirements->dc;
     else content.value = 0;
-    content.appearances = create_list(INTEGER);
-    /* adds the symbol to the symbol table */
-    map_add_symbol(requirements->symbol_table, symbol, content);
-}
-
-/**
- * Checks if the line being read is a directive, and if so, handles it while finding errors (unless it's .entry,
- * which is handled in the second pass). Also inserts the line's label (if it exists) into the symbol table if 
- * it's a .data or .string directive.
- * Considers a line whose first field starts with a period as a directive.
- * 
- * Does so by first checking that the directive itself starts with a period, then checks what directive it is.
- * If it's .data or .string, inserts the line's label (if there is one) to the symbol table, then inserts the
- * directive's data. If it's .extern, handles the directive. If it's .entry, does nothing as it is left for the second
- * pass. Otherwise it's an illegal directive.
- * 
- * @param line             the line being read, not including the label (if there is one)
- * @param label_name       the name of line's label if there is one, or NULL if there isn't
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
- * @return 1 if the line is a directive, 0 otherwise
- */
-static int check_and_handle_directive(char *line, char *label_name, int line_count, char *parsed_file_name, int *error_found,
-                               Requirements *requirements) {
-    /* the part of the line after the directive */
-    char *rest;
-    /* the first field of the line (which is passed without the label) */
-    char *directive = find_token(line, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, frees variables and stops. returns 1 in order to not proceed to
-     * the instruction check */
-    if (directive == NULL) {
-        free(directive);
-        free(label_name);
-        return 1;
-    }
-    /* checks that it is a directive */
-    if (!is_directive(directive)) {
-        free(directive);
-        return 0;
+    /* no memory is allocated for the appearances until the symbol is used as an external symbol */
+    content.appearances.addresses = NULL;
+    content.appearances.count = 0;
+    content.appearances.capacity = 0;
+    /* if the symbol has already been referenced, fills its item, and otherwise adds it to the symbol table */
+    if (handle != -1) {
+        *map_get_symbol_at(requirements->symbol_table, handle) = content;
+        table_name = map_get_name_at(requirements->symbol_table, handle);
     }
-    /* if it's .data */
-    if (equal(directive, DATA_DIRECTIVE)) {
-        /* inserts the label to the symbol table if there is one */
-        if (label_name != NULL) {
-            insert_symbol(label_name, REGULAR, DATA, requirements, error_found,
-                          line_count, parsed_file_name);
-        }
-        insert_data_numbers(rest, parsed_file_name, line_count, requirements, error_found);
-        free(directive);
-        return 1;
-    }
-    /* if it's .string */
-    else if (equal(directive, STRING_DIRECTIVE)) {
-        /* inserts the label to the symbol table if there is one */
-        if (label_name != NULL) {
-            insert_symbol(label_name, REGULAR, DATA, requirements, error_found,
-                          line_count, parsed_file_name);
+    else {
+        /* the symbol table's copy of the name */
+        table_name = view_duplicate(view_of(symbol), requirements->arena);
+        /* if a memory allocation failure has occurred, updates the error flag and stops */
+        if (table_name == NULL || (handle = map_add_symbol(requirements->symbol_table, table_name, content)) == -1) {
+            *error_found = 1;
+            return;
         }
-        insert_string(rest, line_count, parsed_file_name, error_found, requirements);
-        free(directive);
-        return 1;
-    }
-    /* if it's .extern */
-    else if (equal(directive, EXTERN_DIRECTIVE)) {
-        handle_extern(rest, label_name, line_count, parsed_file_name, error_found, requirements);
-        free(directive);
-        return 1;
-    }
-    /* if it's .entry */
-    else if (equal(directive, ENTRY_DIRECTIVE)) {
-        free(directive);
-        free(label_name);
-        return 1;
     }
-    /* any other directive is illegal */
-    else {
-        printf("Input Error: Illegal directive \"%s\" in line %d of file %s\n",
-               directive, line_count, parsed_file_name);
-        *error_found = 1;
-        free(directive);
-        free(label_name);
-        return 1;
+    /* keeps the index of the external symbols up to date */
+    if (type == EXTERNAL && add_to_symbol_index(&requirements->extern_symbols, handle, table_name)) *error_found = 1;
+}
+
+/**
+ * Returns the handle of a symbol that is referenced in the file, so that the second pass can reach it without searching
+ * the symbol table. If the symbol is not in the symbol table yet, adds it as a symbol that is not defined, and its item
+ * is filled once it is defined.
+ * 
+ * @param name         the name of the symbol, which should be allocated from the file's arena
+ * @param requirements a pointer to the requirements for the file
+ * @return the handle of the symbol, or -1 if an allocation failure has occurred
+ */
+static int intern_symbol(char *name, Requirements *requirements) {
+    /* the content of a symbol that is only referenced */
+    SymbolContent content;
+    int handle = map_find_handle(requirements->symbol_table, name);
+    if (handle != -1) return handle;
+    content.value = 0;
+    content.location = UNDEFINED;
+    content.type = REGULAR;
+    content.defined = 0;
+    content.appearances.addresses = NULL;
+    content.appearances.count = 0;
+    content.appearances.capacity = 0;
+    return map_add_symbol(requirements->symbol_table, name, content);
+}
+
+/**
+ * Handles a directive line while finding errors (if it's .entry, leaves a fixup for the second pass). Also inserts the
+ * line's label (if it exists) into the symbol table if it's a .data or .string directive.
+ * Considers a line whose first field (after the label) starts with a period as a directive.
+ * 
+ * Does so based on the kind of the parsed line. If it's .data or .string, inserts the line's label (if there is one)
+ * to the symbol table, then inserts the directive's data. If it's .extern, handles the directive. If it's .entry,
+ * leaves a fixup for it since the symbol might only be defined later. Otherwise it's an illegal directive.
+ * 
+ * @param line            a pointer to the parsed line, which should be a directive
+ * @param label_name      the name of line's label if there is one, or NULL if there isn't
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
+ */
+static void handle_directive(ParsedLine *line, char *label_name, int line_count, char *input_file_name,
+                             int *error_found, Requirements *requirements) {
+    /* the part of the line after the directive, which holds its arguments */
+    char rest[MAX_LINE_LENGTH + 1];
+    /* the directive itself (only used for error reporting) */
+    char directive[MAX_LINE_LENGTH + 1];
+    copy_line_part(line, line->rest, rest, requirements);
+    switch (line->kind) {
+        case DATA_LINE:
+        case STRING_LINE:
+            /* inserts the label to the symbol table if there is one */
+            if (label_name != NULL) {
+                insert_symbol(label_name, REGULAR, DATA, requirements, error_found,
+                              line_count, input_file_name);
+            }
+            if (line->kind == DATA_LINE) {
+                insert_data_numbers(rest, input_file_name, line_count, requirements, error_found);
+            }
+            else insert_string(rest, line_count, input_file_name, error_found, requirements);
+            break;
+        case EXTERN_LINE:
+            handle_extern(rest, label_name, line_count, input_file_name, error_found, requirements);
+            break;
+        case ENTRY_LINE:
+            handle_entry(rest, label_name, line_count, error_found, requirements);
+            break;
+        /* any other directive is illegal */
+        default:
+            console_printf("Input Error: Illegal directive \"%s\" in line %d of file %s\n",
+                           copy_line_part(line, line->field, directive, requirements), line_count,
+                           input_file_name);
+            *error_found = 1;
     }
 }
 
@@ -478,431 +781,623 @@ static int check_and_handle_directive(char *line, char *label_name, int line_cou
  * 
  * Does so by inserting the field after .extern to the symbol table if it's legal.
  * 
- * @param rest             the part of the line after .extern
- * @param label_name       the name of line's label if there is one, or NULL if there isn't
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param rest            the part of the line after .extern
+ * @param label_name      the name of line's label if there is one, or NULL if there isn't
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
  */
-static void handle_extern(char *rest, char *label_name, int line_count, char *parsed_file_name, int *error_found,
+static void handle_extern(char *rest, char *label_name, int line_count, char *input_file_name, int *error_found,
                    Requirements *requirements) {
     /* the symbol given as argument for .extern */
-    char *symbol;
+    char symbol[MAX_LINE_LENGTH + 1];
     /* if the line has a label, issues a warning */
     if (label_name != NULL) {
-        printf("Warning: Label found before .extern directive in line %d of file %s\n",
-               line_count, parsed_file_name);
+        console_printf("Warning: Label found before .extern directive in line %d of file %s\n",
+                       line_count, input_file_name);
     }
     /* the argument is the field directly after .extern */
-    symbol = find_token(rest, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag, frees label_name and stops */
-    if (symbol == NULL) {
-        *error_found = 1;
-        free(label_name);
-        return;
-    }
+    view_copy(next_token(rest, BLANKS, &rest), symbol);
     /* makes sure the argument field is not empty */
     if (is_line_blank(symbol)) {
-        printf("Input Error: No argument given to .extern directive in line %d of file %s\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: No argument given to .extern directive in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
-        free(label_name);
-        free(symbol);
         return;
     }
     /* makes sure the part of the line after the argument is empty */
     if (!is_line_blank(rest)) {
-        printf("Input Error: Extra characters after the argument for .extern directive in line %d of file %s\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: Extra characters after the argument for .extern directive in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
-        free(label_name);
-        free(symbol);
         return;
     }
     /* inserts the symbol to the symbol table */
-    insert_symbol(symbol, EXTERNAL, UNDEFINED, requirements, error_found, line_count, parsed_file_name);
-    free(label_name);
+    insert_symbol(symbol, EXTERNAL, UNDEFINED, requirements, error_found, line_count, input_file_name);
+}
+
+/**
+ * Analyzes a .entry directive and leaves a fixup for it, since the symbol given as its argument might only be defined
+ * later in the file. The directive's errors are reported by the second pass when the fixup is handled.
+ * 
+ * Does so by finding the argument (the field directly after .entry) and whether there are extra characters after it,
+ * and adding a fixup that holds them.
+ * 
+ * @param rest         the part of the line after .entry
+ * @param label_name   the name of line's label if there is one, or NULL if there isn't
+ * @param line_count   the number of the line in the file that is being analyzed
+ * @param error_found  a pointer to a value that represents whether an error has been found
+ * @param requirements a pointer to the requirements for the file
+ */
+static void handle_entry(char *rest, char *label_name, int line_count, int *error_found, Requirements *requirements) {
+    Fixup fixup;
+    /* the argument is the field directly after .entry */
+    fixup.symbol = view_duplicate(next_token(rest, BLANKS, &rest), requirements->arena);
+    /* if a memory allocation failure has occurred, updates the error flag and stops */
+    if (fixup.symbol == NULL) {
+        *error_found = 1;
+        return;
+    }
+    /* an empty argument is reported by the second pass, and does not refer to a symbol */
+    fixup.handle = -1;
+    if (*fixup.symbol != '\0' && (fixup.handle = intern_symbol(fixup.symbol, requirements)) == -1) {
+        *error_found = 1;
+        return;
+    }
+    fixup.kind = ENTRY_FIXUP;
+    fixup.line = line_count;
+    fixup.macro_line = -1;
+    fixup.method = NO_OPERAND;
+    fixup.address = -1;
+    fixup.has_label = label_name != NULL;
+    fixup.has_extra_characters = !is_line_blank(rest);
+    if (add_fixup(requirements, fixup)) *error_found = 1;
 }
 
 
 /**
  * Handles an instruction line while finding errors and inserting the line's label (if it exists) into the symbol table.
- * This function validates the syntax of the line and the operator and inserts the instruction's first word into 
- * the memory image. It does not, however, check the content of the operands and does not insert the additional words
- * into the memory image. These are kept for the second pass.
+ * This function validates the syntax of the line and the operator and inserts the instruction's words into 
+ * the memory image. Operands that are symbols or whose content is invalid are left as fixups for the second pass.
  * Considers "instruction" to be anything that is not a blank line, a comment line or a directive. If it's non of these
  * but also not a valid instruction (as far as the function checks), the problem would be found and reported.
- * If the instruction is legal, enters the line number to the faulty instructions set.
- * 
- * Does so by first inserting the label (if there is one) to the symbol table, finding the operator, verifying it, and
- * find the amount of operands that the operator requires. Then analyzes the rest of the line based on the number
- * of expected operators.
- * 
- * @param line             the part of the line after the label
- * @param label_name       the name of the line's label if there is one, or NULL if there isn't
- * @param line_count       the number of the line in the file that is being analyzed
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
- */
-static void first_pass_handle_instruction(char *line, char *label_name, int line_count, char *parsed_file_name, int *error_found,
-                        Requirements *requirements) {
-    /* the part of the line after the operator */
-    char *rest;
-    /* the name of the operator must be the first field of the line */
-    char *operator_name = find_token(line, BLANKS, &rest);
+ * 
+ * Does so by first inserting the label (if there is one) to the symbol table, verifying the operator that the
+ * pre-assembler found, and handling the rest of the line based on the number of operands that the operator requires.
+ * If the line was stamped out from a line of a macro's content, the instruction is only encoded at the macro's first
+ * usage, and its words and fixups are recorded so the later usages only copy them. Otherwise, an instruction with
+ * operands that does not refer to any symbol is looked up in the encoding cache by its normalized text, and if it was
+ * already encoded, its words are copied without checking its operands again.
+ * 
+ * @param line            a pointer to the parsed line, which should be an instruction
+ * @param label_name      the name of the line's label if there is one, or NULL if there isn't
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
+ */
+static void first_pass_handle_instruction(ParsedLine *line, char *label_name, int line_count, char *input_file_name,
+                                          int *error_found, Requirements *requirements) {
     /* the instruction's operator */
-    Operator op;
+    Operator op = operators()[line->opcode];
+    /* the name of the operator (only used for error reporting) */
+    char operator_name[MAX_LINE_LENGTH + 1];
+    /* the address of the instruction's first word and the index of its first fixup */
+    int first_address = requirements->ic;
+    int first_fixup = requirements->fixup_count;
+    /* whether the instruction may be cached, its normalized text, and its cached encoding if it was found */
+    int cacheable;
+    char key[MAX_LINE_LENGTH + 1];
+    const EncodingContent *cached = NULL;
     /* if there is a label, inserts it to the symbol table */ 
     if (label_name != NULL) {
         insert_symbol(label_name, REGULAR, CODE, requirements,
-                      error_found, line_count, parsed_file_name);
+                      error_found, line_count, input_file_name);
     }
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (operator_name == NULL) {
-        *error_found = 1;
+    /* if the instruction was already encoded at an earlier usage of its macro, copies its words and fixups */
+    if (line->macro_line != -1 && requirements->macro_lines[line->macro_line].state == ENCODED_MACRO_LINE) {
+        stamp_macro_line(&requirements->macro_lines[line->macro_line], line_count, input_file_name, error_found,
+                         requirements);
         return;
     }
     /* makes sure that the operator is legal */
-    if (!is_operator(operator_name)) {
-        printf("Input Error: Illegal instruction name \"%s\" in line %d of file %s\n",
-               operator_name, line_count, parsed_file_name);
+    if (op.opcode == NUMBER_OF_OPERATORS) {
+        console_printf("Input Error: Illegal instruction name \"%s\" in line %d of file %s\n",
+                       copy_line_part(line, line->field, operator_name, requirements), line_count, input_file_name);
         *error_found = 1;
-        set_add(requirements->faulty_instructions, line_count);
-        free(operator_name);
         return;
     }
-    op = get_operator(operator_name);
-    /* handles the instruction based on the expected number of operands */
-    if (has_source(op)) {
-        first_pass_handle_two_operand_instruction(op, rest, line_count, parsed_file_name, error_found, requirements);
+    /* makes sure that the syntax of the operands is legal */
+    if (report_operand_error(line, line_count, input_file_name, error_found)) return;
+    /* if the instruction has operands but no symbol operand, it is encoded the same way wherever it appears, so if it
+     * was already encoded, copies its words */
+    cacheable = has_destination(op) && line->source_method != DIRECT_ADDRESS
+                && line->destination_method != DIRECT_ADDRESS;
+    if (cacheable) {
+        cached = find_cached_encoding(requirements->encoding_cache, build_cache_key(line, key, requirements));
+    }
+    /* copies the cached words, or handles the instruction based on the expected number of operands */
+    if (cached != NULL) {
+        insert_words(cached->words, cached->word_count, line_count, input_file_name, error_found, requirements);
+    } else if (has_source(op)) {
+        first_pass_handle_two_operand_instruction(line, line_count, input_file_name, error_found, requirements);
     } else if (has_destination(op)) {
-        first_pass_handle_one_operand_instruction(op, rest, line_count, parsed_file_name, error_found, requirements);
+        first_pass_handle_one_operand_instruction(line, line_count, input_file_name, error_found, requirements);
     } else {
-        handle_zero_operand_instruction(op, rest, line_count, parsed_file_name, error_found, requirements);
+        handle_zero_operand_instruction(line, line_count, input_file_name, error_found, requirements);
     }
-    free(operator_name);
+    /* an instruction that was encoded without errors or fixups is cached for its later appearances */
+    if (cacheable && cached == NULL && !*error_found && requirements->fixup_count == first_fixup
+        && add_cached_encoding(requirements->encoding_cache, key, &requirements->instruction_array[first_address],
+                               requirements->ic - first_address)) {
+        *error_found = 1;
+    }
+    /* an instruction of a macro's content that was encoded without errors is recorded for the macro's later usages */
+    if (line->macro_line != -1 && !*error_found) record_macro_line(line, first_address, first_fixup, requirements);
 }
 
 /**
- * Handles an instruction line that should have two operands while finding errors.
- * This function validates the syntax of the line and inserts the instruction's first word into 
- * the memory image. It does not, however, check the content of the operands and does not insert the additional words
- * into the memory image. These are kept for the second pass.
- * If the instruction is legal, enters the line number to the faulty instructions set.
+ * Records the words and fixups of an instruction that was stamped out from a line of a macro's content, so the later
+ * usages of the macro can copy them instead of encoding the instruction again.
+ * Does so by copying the words that were inserted since the instruction's first word and the fixups that were left
+ * since its first fixup, with the addresses of the fixups made relative to the first word. The fixups that were
+ * already left are marked with the line of the macro's content as well, so the second pass reports their errors once.
+ * Assumes that the instruction was encoded without errors.
  * 
- * Does so by verifying the syntax (makes sure there are two operands split by a single comma and any amount of
- * whitespaces), then finding the address method of each operand, building the memory word, verifying it, inserting
- * it to the memory image, and advancing the instruction counter to account for the additional words.
- * 
- * @param op               the instruction's operator
- * @param rest             the part of the line after the operator
- * @param line_count       the number of the line in the file that is being analyzed
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param line          a pointer to the parsed line of the instruction
+ * @param first_address the address of the instruction's first word
+ * @param first_fixup   the index of the instruction's first fixup
+ * @param requirements  a pointer to the requirements for the file
  */
-static void first_pass_handle_two_operand_instruction(Operator op, char *rest, int line_count, char *parsed_file_name,
-                                    int *error_found, Requirements *requirements) {
-    char *source_operand;
-    char *destination_operand;
-    /* the source operand without heading or trailing whitespaces */
-    char *trimmed_source_operand;
-    /* the destination operand without heading or trailing whitespaces */
-    char *trimmed_destination_operand;
-    AddressMethod source_address_method;
-    AddressMethod destination_address_method;
-    /* the instruction's first word in the memory */
-    short unsigned first_word;
-    /* makes sure there is no comma before the first operand */
-    if (first_non_blank(rest) == *OPERAND_SEPARATOR) {
-        printf("Input Error: Operand list in line %d of file %s starts with an illegal comma\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        return;
-    }
-    /* makes sure there is no after the last operand */
-    if (last_non_blank(rest) == *OPERAND_SEPARATOR) {
-        printf("Input Error: Operand list in line %d of file %s ends with an illegal comma\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        return;
-    }
-    /* makes sure there are no multiple consecutive commas (including ones with only whitespaces between them) */
-    if (includes_consecutive(rest, *OPERAND_SEPARATOR)) {
-        printf("Input Error: Operand list in line %d of file %s includes multiple consecutive commas\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        return;
-    }
-    /* the source operand is the first field of the part after the operator when separating by commas,
-     * may include whitespaces */
-    source_operand = find_token(rest, OPERAND_SEPARATOR, &rest);
-    /* the source operand is the first field of the part after the source operand when separating by commas,
-     * may include whitespaces */
-    destination_operand = find_token(rest, OPERAND_SEPARATOR, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (source_operand == NULL || destination_operand == NULL) {
-        *error_found = 1;
-        return;
+static void record_macro_line(ParsedLine *line, int first_address, int first_fixup, Requirements *requirements) {
+    MacroLine *macro_line = &requirements->macro_lines[line->macro_line];
+    int i;
+    macro_line->word_count = requirements->ic - first_address;
+    for (i = 0; i < macro_line->word_count; i++) {
+        macro_line->words[i] = requirements->instruction_array[first_address + i];
     }
-    /* removes heading and trailing whitespaces from the operands */
-    trimmed_source_operand = trim(source_operand);
-    trimmed_destination_operand = trim(destination_operand);
-    free_all(2, source_operand, destination_operand);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (trimmed_source_operand == NULL || trimmed_destination_operand == NULL) {
-        *error_found = 1;
-        return;
+    macro_line->fixup_count = requirements->fixup_count - first_fixup;
+    for (i = 0; i < macro_line->fixup_count; i++) {
+        requirements->fixups[first_fixup + i].macro_line = line->macro_line;
+        macro_line->fixups[i] = requirements->fixups[first_fixup + i];
+        macro_line->fixups[i].address -= first_address;
     }
-    /* makes sure there is a source operand */
-    if (is_line_blank(trimmed_source_operand)) {
-        printf("Input Error: Missing source operand in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
-        return;
+    macro_line->state = ENCODED_MACRO_LINE;
+}
+
+/**
+ * Inserts the words of an instruction that was recorded from a line of a macro's content into the memory image, and
+ * leaves its fixups, with their addresses rebased to the address of the instruction's first word.
+ * 
+ * @param macro_line      a pointer to the line of the macro's content, which should be encoded
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
+ */
+static void stamp_macro_line(MacroLine *macro_line, int line_count, char *input_file_name, int *error_found,
+                             Requirements *requirements) {
+    int first_address = requirements->ic;
+    Fixup fixup;
+    int i;
+    insert_words(macro_line->words, macro_line->word_count, line_count, input_file_name, error_found, requirements);
+    for (i = 0; i < macro_line->fixup_count; i++) {
+        fixup = macro_line->fixups[i];
+        fixup.address += first_address;
+        /* if the fixup's word could not be inserted, there is nothing for the second pass to fill */
+        if (fixup.address >= requirements->ic) fixup.address = -1;
+        if (add_fixup(requirements, fixup)) *error_found = 1;
     }
-    /* if the trimmed source operand includes blank spaces, then it must be made of two operands without a 
-     * comma between them */ 
-    if (strpbrk(trimmed_source_operand, BLANKS)) {
-        printf("Input Error: Missing comma between operands in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
-        return;
+}
+
+/**
+ * Builds the normalized text of an instruction, which represents it in the encoding cache - the name of its operator,
+ * then its operands split by a comma, without any whitespaces around them. The text is never longer than the line.
+ * 
+ * @param line         a pointer to the parsed line, which should be an instruction with a legal operator and operands
+ *                     with a legal syntax
+ * @param key          an array which can hold the line plus one character
+ * @param requirements a pointer to the requirements for the file
+ * @return key
+ */
+static char *build_cache_key(ParsedLine *line, char key[], Requirements *requirements) {
+    char *end = key;
+    strcpy(end, operators()[line->opcode].name);
+    end += strlen(end);
+    *end++ = ' ';
+    if (line->source_method != NO_OPERAND) {
+        end += strlen(copy_line_part(line, line->source, end, requirements));
+        *end++ = *OPERAND_SEPARATOR;
     }
-    /* makes sure there is a destination operand */
-    if (is_line_blank(trimmed_destination_operand)) {
-        printf("Input Error: Missing destination operand in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
-        return;
+    copy_line_part(line, line->destination, end, requirements);
+    return key;
+}
+
+/**
+ * Inserts the memory words of an instruction that were already encoded into the memory image.
+ * 
+ * @param words           the instruction's memory words
+ * @param word_count      the number of the instruction's memory words
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
+ */
+static void insert_words(const unsigned short words[], int word_count, int line_count, char *input_file_name,
+                         int *error_found, Requirements *requirements) {
+    int i;
+    for (i = 0; i < word_count; i++) {
+        *error_found |= memory_insert_instruction(requirements, words[i], line_count, input_file_name);
     }
-    /* if the trimmed destination operand includes blank spaces, then it must be made of two operands without a comma
-     * between them, which would classify as extra characters after the second operand (the destination);
-     * if the part after the field which represents the destination operand (when split by commas) is not a blank line,
-     * then there are also extra characters after the destination operand */
-    if (strpbrk(trimmed_destination_operand, BLANKS) || !is_line_blank(rest)) {
-        printf("Input Error: Extra characters after destination operand in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
-        return;
+}
+
+/**
+ * Reports the syntax error in the operands of an instruction that the pre-assembler found, if there is one.
+ * Two-operand instructions must have two operands split by a single comma and any amount of whitespaces, one-operand
+ * instructions must have a single operand without commas, and instructions without operands must have nothing after
+ * the operator.
+ * 
+ * @param line            a pointer to the parsed line, which should be an instruction with a legal operator
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @return 1 if the operands have a syntax error, 0 otherwise
+ */
+static int report_operand_error(ParsedLine *line, int line_count, char *input_file_name, int *error_found) {
+    switch (line->operand_error) {
+        case NO_OPERAND_ERROR:
+            return 0;
+        case LEADING_COMMA:
+            console_printf("Input Error: Operand list in line %d of file %s starts with an illegal comma\n",
+                           line_count, input_file_name);
+            break;
+        case TRAILING_COMMA:
+            console_printf("Input Error: Operand list in line %d of file %s ends with an illegal comma\n",
+                           line_count, input_file_name);
+            break;
+        case CONSECUTIVE_COMMAS:
+            console_printf("Input Error: Operand list in line %d of file %s includes multiple consecutive commas\n",
+                           line_count, input_file_name);
+            break;
+        case MISSING_SOURCE:
+            console_printf("Input Error: Missing source operand in line %d of file %s\n",
+                           line_count, input_file_name);
+            break;
+        /* the source operand includes blank spaces, so it must be made of two operands without a comma between them */
+        case MISSING_COMMA:
+            console_printf("Input Error: Missing comma between operands in line %d of file %s\n",
+                           line_count, input_file_name);
+            break;
+        case MISSING_DESTINATION:
+            console_printf("Input Error: Missing destination operand in line %d of file %s\n",
+                           line_count, input_file_name);
+            break;
+        case EXTRA_AFTER_DESTINATION:
+            console_printf("Input Error: Extra characters after destination operand in line %d of file %s\n",
+                           line_count, input_file_name);
+            break;
+        /* the operand of a one-operand instruction starts or ends with a comma */
+        case ILLEGAL_COMMA:
+            console_printf("Input Error: Illegal comma in line %d of file %s\n",
+                           line_count, input_file_name);
+            break;
+        /* the operand of a one-operand instruction includes a comma, so it is made of two operands */
+        case TOO_MANY_OPERANDS:
+            console_printf("Input Error: Too many operands for operator \"%s\" in line %d of file %s\n",
+                           operators()[line->opcode].name, line_count, input_file_name);
+            break;
+        case EXTRA_AFTER_INSTRUCTION:
+            console_printf("Input Error: Extra characters after instruction in line %d of file %s\n",
+                           line_count, input_file_name);
+            break;
     }
-    /* the address methods of the operands */
-    source_address_method = get_address_method(trimmed_source_operand);
-    destination_address_method = get_address_method(trimmed_destination_operand);
+    *error_found = 1;
+    return 1;
+}
+
+/**
+ * Handles an instruction line that should have two operands, and whose operands have a legal syntax, while finding
+ * errors.
+ * This function inserts the instruction's words into the memory image. Operands that are symbols or whose content is
+ * invalid are left as fixups for the second pass.
+ * 
+ * Does so by verifying the address method of each operand, building the memory word, inserting it to the memory image,
+ * and inserting the additional words (either one combined word or one word per operand).
+ * 
+ * @param line            a pointer to the parsed line
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
+ */
+static void first_pass_handle_two_operand_instruction(ParsedLine *line, int line_count, char *input_file_name,
+                                    int *error_found, Requirements *requirements) {
+    Operator op = operators()[line->opcode];
+    AddressMethod source_method = line->source_method;
+    AddressMethod destination_method = line->destination_method;
+    /* the operands, without heading or trailing whitespaces */
+    char source_operand[MAX_LINE_LENGTH + 1];
+    char destination_operand[MAX_LINE_LENGTH + 1];
+    /* the instruction's first word in the memory and the layout of its additional words */
+    const InstructionEncoding *encoding;
     /* makes sure the source operand's address method is legal */
-    if (!is_legal_source_method(op, source_address_method)) {
-        printf("Input Error: Illegal source address method in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
+    if (!is_legal_source_method(op, source_method)) {
+        console_printf("Input Error: Illegal source address method in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
         return;
     }
     /* makes sure the destination operand's address method is legal */
-    if (!is_legal_destination_method(op, destination_address_method)) {
-        printf("Input Error: Illegal destination address method in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
+    if (!is_legal_destination_method(op, destination_method)) {
+        console_printf("Input Error: Illegal destination address method in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
         return;
     }
-    free_all(2, trimmed_source_operand, trimmed_destination_operand);
-    /* build's the instruction first memory word based on the operator and address methods */
-    first_word = build_instruction_first_word(op, source_address_method,
-                                              destination_address_method);
+    copy_line_part(line, line->source, source_operand, requirements);
+    copy_line_part(line, line->destination, destination_operand, requirements);
+    /* finds the instruction's first memory word and the layout of its additional words based on the operator and
+     * address methods */
+    encoding = get_instruction_encoding(op, source_method, destination_method);
     /* inserts the word into the memory while updating the value of error_found to 1 if there
      * are any errors in the process */
-    *error_found |= memory_insert_instruction(requirements, first_word, line_count, parsed_file_name);
-    /* advances the instruction counter based on the number of additional words */
-    if (should_combine_additional_words(source_address_method, destination_address_method)) {
-        requirements->ic++;
-    } else requirements->ic += 2;
+    *error_found |= memory_insert_instruction(requirements, encoding->first_word, line_count, input_file_name);
+    /* inserts the additional words */
+    if (encoding->combined) {
+        insert_combined_operand_word(source_operand, destination_operand, source_method, destination_method,
+                                     line_count, input_file_name, error_found, requirements);
+    } else {
+        insert_operand_word(source_operand, source_method, 1, line_count, input_file_name,
+                            error_found, requirements);
+        insert_operand_word(destination_operand, destination_method, 0, line_count,
+                            input_file_name, error_found, requirements);
+    }
 }
 
 /**
- * Handles an instruction line that should have one operand while finding errors.
- * This function validates the syntax of the line and inserts the instruction's first word into 
- * the memory image. It does not, however, check the content of the operand and does not insert the additional word
- * into the memory image. These are kept for the second pass.
- * If the instruction is legal, enters the line number to the faulty instructions set.
+ * Handles an instruction line that should have one operand, and whose operand has a legal syntax, while finding errors.
+ * This function inserts the instruction's words into the memory image. If the operand is a symbol or its content is
+ * invalid, it is left as a fixup for the second pass.
  * 
- * Does so by verifying the syntax of the line (only one operand and no commas), then finding the operand's address
- * method, verifying it, building the instruction's first memory word, inserting it to the memory and advancing the
- * instruction counter to account for the additional word.
+ * Does so by verifying the operand's address method, building the instruction's first memory word, inserting it to
+ * the memory and then inserting the operand's word.
  * 
- * @param op               the instruction's operator
- * @param rest             the part of the line after the operator
- * @param line_count       the number of the line in the file that is being analyzed
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param line            a pointer to the parsed line
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
  */
-static void first_pass_handle_one_operand_instruction(Operator op, char *rest, int line_count, char *parsed_file_name,
+static void first_pass_handle_one_operand_instruction(ParsedLine *line, int line_count, char *input_file_name,
                                     int *error_found, Requirements *requirements) {
-    /* the destination operand is the next field after the operator */
-    char *destination_operand = find_token(rest, BLANKS, &rest);
-    /* the destination operand's address method */
-    AddressMethod destination_address_method;
+    Operator op = operators()[line->opcode];
+    AddressMethod destination_method = line->destination_method;
+    /* the operand */
+    char destination_operand[MAX_LINE_LENGTH + 1];
     /* the instruction's first word in the memory */
     short unsigned first_word;
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (destination_operand == NULL) {
-        *error_found = 1;
-        return;
-    }
-    /* makes sure that the destination operand is not empty */
-    if (is_line_blank(destination_operand)) {
-        printf("Input Error: Missing destination operand in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free(destination_operand);
-        return;
-    }
-    /* if the operand starts or ends with a comma, it is illegal */
-    if (first_non_blank(destination_operand) == *OPERAND_SEPARATOR ||
-        last_non_blank(destination_operand) == *OPERAND_SEPARATOR) {
-        printf("Input Error: Illegal comma in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free(destination_operand);
-        return;
-    }
-    /* if the operand includes a comma, then it is made of two operands */
-    if (exists(destination_operand, *OPERAND_SEPARATOR)) {
-        printf("Input Error: Too many operands for operator \"%s\" in line %d of file %s\n",
-               op.name, line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free(destination_operand);
-        return;
-    }
-    /* makes sure the part of the line after the operand is empty */
-    if (!is_line_blank(rest)) {
-        printf("Input Error: Extra characters after destination operand in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        free(destination_operand);
-        return;
-    }
-    destination_address_method = get_address_method(destination_operand);
     /* makes sure the operand's address method is legal based on the operator */
-    if (!is_legal_destination_method(op, destination_address_method)) {
-        printf("Input Error: Illegal destination address method in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
+    if (!is_legal_destination_method(op, destination_method)) {
+        console_printf("Input Error: Illegal destination address method in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
-        free(destination_operand);
         return;
     }
-    free(destination_operand);
     /* builds the instruction's first word in the memory */
-    first_word = build_instruction_first_word(op, NO_OPERAND, destination_address_method);
+    first_word = get_instruction_encoding(op, NO_OPERAND, destination_method)->first_word;
     /* inserts the word into the memory while updating the value of error_found to 1 if there
      * are any errors in the process */
-    *error_found |= memory_insert_instruction(requirements, first_word, line_count, parsed_file_name);
-    /* advances the instruction counter to account for the additional word */
-    requirements->ic++;
+    *error_found |= memory_insert_instruction(requirements, first_word, line_count, input_file_name);
+    /* inserts the operand's word */
+    copy_line_part(line, line->destination, destination_operand, requirements);
+    insert_operand_word(destination_operand, destination_method, 0, line_count, input_file_name,
+                        error_found, requirements);
 }
 
 /**
- * Handles an instruction line that should have no operands while finding errors.
- * This function validates the syntax of the line and inserts the instruction's first word into 
- * the memory image.
- * If the instruction is legal, enters the line number to the faulty instructions set.
- * 
- * Does so by verifying the syntax of the line (only includes the operator), then builds the instruction's first memory
- * word and inserts it to the memory.
+ * Handles an instruction line that should have no operands, and has nothing after the operator, while finding errors.
+ * This function inserts the instruction's first word into the memory image.
  * 
- * @param op               the instruction's operator
- * @param rest             the part of the line after the operator
- * @param line_count       the number of the line in the file that is being analyzed
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param line            a pointer to the parsed line
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
  */
-static void handle_zero_operand_instruction(Operator op, char *rest, int line_count, char *parsed_file_name,
+static void handle_zero_operand_instruction(ParsedLine *line, int line_count, char *input_file_name,
                                      int *error_found, Requirements *requirements) {
     /* the instruction's first word in the memory */
-    unsigned short first_word;
-    /* makes sure there are no extra characters after the operator */
-    if (!is_line_blank(rest)) {
-        printf("Input Error: Extra characters after instruction in line %d of file %s\n",
-               line_count, parsed_file_name);
-        set_add(requirements->faulty_instructions, line_count);
-        *error_found = 1;
-        return;
-    }
-    /* builds the instruction's first word in the memory */
-    first_word = build_instruction_first_word(op, NO_OPERAND, NO_OPERAND);
+    unsigned short first_word = get_instruction_encoding(operators()[line->opcode], NO_OPERAND, NO_OPERAND)->first_word;
     /* inserts the word into the memory while updating the value of error_found to 1 if there
      * are any errors in the process */
-    *error_found |= memory_insert_instruction(requirements, first_word, line_count, parsed_file_name);
+    *error_found |= memory_insert_instruction(requirements, first_word, line_count, input_file_name);
+}
+
+/**
+ * Checks if an operand can be encoded during the first pass - it is not a symbol, and its content is valid.
+ * Invalid operands are reported by the second pass, so does not report any error.
+ * 
+ * @param operand        the operand to be checked
+ * @param address_method the operand's address method
+ * @return 1 if the operand can be encoded, 0 otherwise
+ */
+static int is_encodable_operand(char *operand, AddressMethod address_method) {
+    /* the value represented by an operand in the immediate address method */
+    int value;
+    /* the value of a symbol is only known once the entire file has been read */
+    if (address_method == DIRECT_ADDRESS) return 0;
+    /* the part of the operand after the starting asterisk must be a register */
+    if (address_method == INDIRECT_REGISTER_ADDRESS) return is_register(operand + 1);
+    /* the part of the operand after the starting pound must be an integer within the bounds for signed 12 bit
+     * integer in the 2's complement method */
+    if (address_method == IMMEDIATE_ADDRESS) {
+        if (!is_integer(operand + 1)) return 0;
+        value = atoi(operand + 1);
+        return value <= IMMEDIATE_VALUE_MAX && value >= IMMEDIATE_VALUE_MIN;
+    }
+    /* an operand is considered to be in the direct register address if and only if it is one of eight defined
+     * keywords (the registers), which means it necessarily legal */
+    return 1;
+}
+
+/**
+ * Creates a memory word representing a single operand.
+ * Assumes the operand can be encoded during the first pass.
+ * 
+ * Does so by building the correct type of word based on the operand's address method, as well as whether it is a source
+ * or destination operand if the address method is one of the register address methods.
+ * 
+ * @param operand        the operand to be represented
+ * @param address_method the operand's address method
+ * @param is_source      1 if the operand is a source operand, 0 if it is a destination operand
+ * @return the memory word
+ */
+static short unsigned create_single_operand_word(char *operand, AddressMethod address_method, int is_source) {
+    /* if the address method is immediate address, the immediate value is the part after the starting '#',
+     * builds the word based on this value */
+    if (address_method == IMMEDIATE_ADDRESS) {
+        return create_immediate_address_word(atoi(operand + 1));
+    }
+    /* if the address method is indirect register address, then the register is the part after the starting '*'.
+     * The word is different for source and destination operands */
+    if (address_method == INDIRECT_REGISTER_ADDRESS && is_source) {
+        return create_source_register_word(operand + 1);
+    }
+    /* the address method is indirect register address, but it is necessarily not a source operand */
+    if (address_method == INDIRECT_REGISTER_ADDRESS) {
+        return create_destination_register_word(operand + 1);
+    }
+    /* the address method is necessarily direct register address, so the register is the whole operand.
+     * The word changes based on whether it is a source or destination operand */
+    if (is_source) return create_source_register_word(operand);
+    return create_destination_register_word(operand);
+}
+
+/**
+ * Creates a memory word representing two operands in the either direct or indirect register address method.
+ * Assumes both operands are valid and are given in one of the mentioned methods.
+ * 
+ * Does so by getting the register part of the operands based on their address methods, and creating the memory
+ * word based on the registers.
+ * 
+ * @param source_operand      the source operand
+ * @param destination_operand the destination operand
+ * @param source_method       the source operand's address method
+ * @param destination_method  the destination operand's address method
+ * @return the memory word
+ */
+static short unsigned create_combined_operand_word(char *source_operand, char *destination_operand,
+                                                   AddressMethod source_method, AddressMethod destination_method) {
+    /* if the address method for either of the operands is indirect register address, then the register is the part
+     * immediately after the starting asterisk, so the operand variable changes to it.
+     * Otherwise, it's the whole operand */
+    if (source_method == INDIRECT_REGISTER_ADDRESS) source_operand++;
+    if (destination_method == INDIRECT_REGISTER_ADDRESS) destination_operand++;
+    return create_combined_register_word(source_operand, destination_operand);
 }
 
 /**
- * Checks if a line includes a semicolon. Should be used when knowing that the first character is 
- * not a semicolon and therefore the line is not a comment. If a semicolon is found, throws an error.
+ * Leaves a fixup for an operand that can't be encoded during the first pass. The fixup holds its own copy of the
+ * operand, since the operand is a part of the line being read.
  * 
- * @param line             the line to be checked
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @return 1 if the line includes a semicolon, 0 otherwise
+ * @param operand        the operand
+ * @param address_method the operand's address method
+ * @param address        the address of the operand's memory word, or -1 if it could not be inserted
+ * @param line_count     the number of the line in the file that is being analyzed
+ * @param error_found    a pointer to a value that represents whether an error has been found
+ * @param requirements   a pointer to the requirements for the file
  */
-static int has_comment_start(char *line, int line_count, char *parsed_file_name, int *error_found) {
-    /* makes sure the line (that is known to not be a comment line) doesn't have a semicolon, which would be illegal */
-    if (exists(line, COMMENT_START)) {
-        printf("Input Error: Semicolon signifying a comment appears after the first character in line %d of file "
-               "%s\n", line_count, parsed_file_name);
+static void add_operand_fixup(char *operand, AddressMethod address_method, int address, int line_count,
+                              int *error_found, Requirements *requirements) {
+    Fixup fixup;
+    fixup.kind = OPERAND_FIXUP;
+    fixup.line = line_count;
+    fixup.macro_line = -1;
+    fixup.symbol = view_duplicate(view_of(operand), requirements->arena);
+    /* if a memory allocation failure has occurred, updates the error flag and stops */
+    if (fixup.symbol == NULL) {
         *error_found = 1;
-        return 1;
+        return;
     }
-    return 0;
+    /* only an operand in the direct address method refers to a symbol */
+    fixup.handle = -1;
+    if (address_method == DIRECT_ADDRESS && (fixup.handle = intern_symbol(fixup.symbol, requirements)) == -1) {
+        *error_found = 1;
+        return;
+    }
+    fixup.method = address_method;
+    fixup.address = address;
+    fixup.has_label = 0;
+    fixup.has_extra_characters = 0;
+    if (add_fixup(requirements, fixup)) *error_found = 1;
 }
 
 /**
- * Checks if a line is blank, and should only be used if a label appears before the line, which would cause a blank
- * line to have a label which is illegal. If the line is blank, throws and appropriate error.
+ * Inserts the memory word of a single operand into the memory image.
+ * If the operand can't be encoded yet (it is a symbol or its content is invalid), inserts an empty word in its place
+ * and leaves a fixup for it, which the second pass uses to fill the word or report the error.
  * 
- * @param line             the line to be checked (the part after the label)
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @return 1 if the line is blank, 0 otherwise 
+ * @param operand         the operand
+ * @param address_method  the operand's address method
+ * @param is_source       1 if the operand is a source operand, 0 if it is a destination operand
+ * @param line_count      the number of the line in the file that is being analyzed
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param requirements    a pointer to the requirements for the file
  */
-static int blank_after_label(char *line, int line_count, char *parsed_file_name, int *error_found) {
-    /* checks that the line after the label is not blank, which would be illegal */
-    if (is_line_blank(line)) {
-        printf("Input Error: Line %d of file %s is empty but has a label\n", line_count, parsed_file_name);
+static void insert_operand_word(char *operand, AddressMethod address_method, int is_source, int line_count,
+                                char *input_file_name, int *error_found, Requirements *requirements) {
+    /* the address of the operand's word */
+    int address = requirements->ic;
+    if (is_encodable_operand(operand, address_method)) {
+        short unsigned word = create_single_operand_word(operand, address_method, is_source);
+        *error_found |= memory_insert_instruction(requirements, word, line_count, input_file_name);
+        return;
+    }
+    /* if the word can't be inserted, there is nothing for the second pass to fill */
+    if (memory_insert_instruction(requirements, 0, line_count, input_file_name)) {
         *error_found = 1;
-        return 1;
+        address = -1;
     }
-    return 0;
+    add_operand_fixup(operand, address_method, address, line_count, error_found, requirements);
 }
 
 /**
- * Checks if a given symbol represents a word in the data portion.
- * @param symbol the content of the symbol to be checked
+ * Inserts a memory word representing two register operands into the memory image. If either of the operands is
+ * invalid, inserts an empty word in its place and leaves a fixup for every invalid operand, which the second pass
+ * uses to report the error.
  * 
- * @return 1 if symbol is a data symbol, 0 otherwise
+ * @param source_operand      the source operand
+ * @param destination_operand the destination operand
+ * @param source_method       the source operand's address method
+ * @param destination_method  the destination operand's address method
+ * @param line_count          the number of the line in the file that is being analyzed
+ * @param input_file_name     the name of the input file that is being assembled (used for error reporting)
+ * @param error_found         a pointer to a value that represents whether an error has been found
+ * @param requirements        a pointer to the requirements for the file
  */
-static int is_data_symbol(SymbolContent symbol) {
-    return symbol.location == DATA;
+static void insert_combined_operand_word(char *source_operand, char *destination_operand,
+                                         AddressMethod source_method, AddressMethod destination_method,
+                                         int line_count, char *input_file_name, int *error_found,
+                                         Requirements *requirements) {
+    int source_valid = is_encodable_operand(source_operand, source_method);
+    int destination_valid = is_encodable_operand(destination_operand, destination_method);
+    /* the address of the combined word */
+    int address = requirements->ic;
+    short unsigned word = 0;
+    if (source_valid && destination_valid) {
+        word = create_combined_operand_word(source_operand, destination_operand, source_method,
+                                            destination_method);
+    }
+    if (memory_insert_instruction(requirements, word, line_count, input_file_name)) {
+        *error_found = 1;
+        address = -1;
+    }
+    if (!source_valid) {
+        add_operand_fixup(source_operand, source_method, address, line_count, error_found, requirements);
+    }
+    if (!destination_valid) {
+        add_operand_fixup(destination_operand, destination_method, address, line_count, error_found, requirements);
+    }
 }
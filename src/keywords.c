@@ -0,0 +1,91 @@
+/**
+ * Includes the keyword table and the function that recognizes keywords using a perfect hash over it.
+ */
+
+#include "../headers/keywords.h"
+#include "../headers/fields.h"
+#include "stddef.h"
+#include "string.h"
+
+/**
+ * The length of the longest keyword.
+ */
+#define MAX_KEYWORD_LENGTH 7
+
+/**
+ * The number of slots in the hash-table of the keywords (a power of two).
+ */
+#define KEYWORD_SLOT_COUNT 64
+
+/**
+ * The list of the keywords. The operators come first, in the order of their opcodes.
+ * The list is constant and initialized at compile time, so it can be shared by several assemblies that run at the same
+ * time.
+ */
+static const Keyword keyword_list[] = {
+        {"mov", OPERATOR_KEYWORD, 0},
+        {"cmp", OPERATOR_KEYWORD, 1},
+        {"add", OPERATOR_KEYWORD, 2},
+        {"sub", OPERATOR_KEYWORD, 3},
+        {"lea", OPERATOR_KEYWORD, 4},
+        {"clr", OPERATOR_KEYWORD, 5},
+        {"not", OPERATOR_KEYWORD, 6},
+        {"inc", OPERATOR_KEYWORD, 7},
+        {"dec", OPERATOR_KEYWORD, 8},
+        {"jmp", OPERATOR_KEYWORD, 9},
+        {"bne", OPERATOR_KEYWORD, 10},
+        {"red", OPERATOR_KEYWORD, 11},
+        {"prn", OPERATOR_KEYWORD, 12},
+        {"jsr", OPERATOR_KEYWORD, 13},
+        {"rts", OPERATOR_KEYWORD, 14},
+        {"stop", OPERATOR_KEYWORD, 15},
+        {DATA_DIRECTIVE, DIRECTIVE_KEYWORD, 0},
+        {STRING_DIRECTIVE, DIRECTIVE_KEYWORD, 1},
+        {ENTRY_DIRECTIVE, DIRECTIVE_KEYWORD, 2},
+        {EXTERN_DIRECTIVE, DIRECTIVE_KEYWORD, 3},
+        {"r0", REGISTER_KEYWORD, 0},
+        {"r1", REGISTER_KEYWORD, 1},
+        {"r2", REGISTER_KEYWORD, 2},
+        {"r3", REGISTER_KEYWORD, 3},
+        {"r4", REGISTER_KEYWORD, 4},
+        {"r5", REGISTER_KEYWORD, 5},
+        {"r6", REGISTER_KEYWORD, 6},
+        {"r7", REGISTER_KEYWORD, 7},
+        {MACRO_DEFINITION, MACRO_KEYWORD, 0},
+        {MACRO_END, MACRO_KEYWORD, 1}
+};
+
+/**
+ * The hash-table of the keywords - the slot at the hash-value of every keyword holds its index in the keyword list,
+ * and every other slot holds -1. The hash function was chosen so that no two keywords share a slot, so a name can
+ * only be the keyword in its slot.
+ * If the keyword list changes, a new hash function and table should be found.
+ */
+static const signed char keyword_slots[KEYWORD_SLOT_COUNT] = {
+        17, 28, 24, -1, -1, -1, 20, -1, -1, 16, -1, 7, 6, -1, -1, -1,
+        -1, 25, -1, -1, -1, 21, 11, -1, 13, -1, 0, 29, -1, 10, 15, -1,
+        26, 12, -1, -1, 22, -1, -1, -1, 1, 2, 19, -1, -1, 18, 9, 27,
+        -1, -1, -1, 23, -1, -1, 4, 14, 3, -1, -1, -1, -1, 5, 8, -1
+};
+
+/**
+ * Finds the keyword with a given name.
+ * Does so by finding the name's length (giving up once it is longer than every keyword), and hashing its first,
+ * second and last characters and its length into a slot of the keyword table. The name is a keyword if and only if
+ * it is the name of the keyword in that slot.
+ * 
+ * @param name the name to be checked
+ * @return a pointer to the keyword with the given name, or NULL if the name is not a keyword
+ */
+const Keyword *find_keyword(char *name) {
+    int length = 0;
+    int slot;
+    while (name[length] != '\0') {
+        if (++length > MAX_KEYWORD_LENGTH) return NULL;
+    }
+    if (length == 0) return NULL;
+    slot = keyword_slots[((unsigned char) name[0] * 10 + (unsigned char) name[1] * 3 +
+                          (unsigned char) name[length - 1] * 12 + length) & (KEYWORD_SLOT_COUNT - 1)];
+    if (slot == -1 || strcmp(keyword_list[slot].name, name) != 0) return NULL;
+    return &keyword_list[slot];
+}
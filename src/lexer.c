@@ -0,0 +1,267 @@
+/**
+ * Includes the function that lexes a line, as well as helper functions for it.
+ * The line is scanned once, from left to right, by a state machine whose state is the part of the line that the
+ * current character belongs to. Everything that the assembler checks about the line is recorded on the way, so the
+ * line is classified, split into fields and checked for syntax errors without scanning it again.
+ */
+
+#include "../headers/lexer.h"
+#include "../headers/keywords.h"
+#include "../headers/util/string_ops.h"
+#include "ctype.h"
+#include "string.h"
+
+/**
+ * Checks if a character separates the fields of a line (a space or a tab).
+ */
+#define IS_BLANK(c) ((c) == ' ' || (c) == '\t')
+
+/**
+ * Represents the part of the line that the current character belongs to.
+ */
+typedef enum {
+    /* the blanks before the first field */
+    BEFORE_FIRST_FIELD,
+    /* the first field, which is either a label or the operator or directive */
+    IN_FIRST_FIELD,
+    /* the blanks between the label and the operator or directive */
+    BEFORE_FIELD,
+    /* the operator or directive, after a label */
+    IN_FIELD,
+    /* the part after the operator or directive */
+    IN_REST
+} LexerState;
+
+/**
+ * Represents what the scan found about the part of the line after the operator or directive, which is what the
+ * syntax errors of the operands are based on.
+ */
+typedef struct {
+    /* the first and last non-whitespace characters, or 0 if there are none */
+    char first_char;
+    char last_char;
+    /* the number of commas, and the positions of the first two */
+    int comma_count;
+    char *commas[2];
+    /* whether two commas appear with only whitespaces between them */
+    unsigned consecutive_commas : 1;
+    /* the first blank-separated token, or NULL if there is none */
+    char *token_start;
+    char *token_end;
+    /* whether a non-whitespace character appears after the first token */
+    unsigned extra_after_token : 1;
+} RestScan;
+
+/**
+ * Returns a view of the characters between two positions of a line.
+ *
+ * @param start a pointer to the first character of the view
+ * @param end   a pointer to the character immediately after the last one of the view
+ * @return the view
+ */
+static StringView view_between(char *start, char *end) {
+    StringView view;
+    view.start = start;
+    view.length = end - start;
+    return view;
+}
+
+/**
+ * Finds the operands of a two-operand instruction and the first syntax error in them, based on the scan of the part
+ * of the line after the operator.
+ * The operands are the parts before the first comma and between the first and second commas without heading spaces or
+ * tabs and trailing whitespaces, so the errors are checked in this order: a comma before the first operand, a comma
+ * after the last operand, consecutive commas, a missing source operand, a missing comma (the source operand is made of
+ * two fields), a missing destination operand and extra characters after the destination operand (another field or
+ * another comma).
+ *
+ * @param lexed      a pointer to the lexed line
+ * @param rest       a pointer to the scan of the part after the operator
+ * @param rest_start a pointer to the first character after the operator
+ * @param line_end   a pointer to the terminating 0 of the line
+ * @return the first syntax error in the operands, or NO_OPERAND_ERROR if there is none
+ */
+static OperandError lex_two_operands(LexedLine *lexed, RestScan *rest, char *rest_start, char *line_end) {
+    /* copies of the operands, which the checks and the address methods are based on */
+    char source[MAX_LINE_LENGTH + 1];
+    char destination[MAX_LINE_LENGTH + 1];
+    if (rest->first_char == *OPERAND_SEPARATOR) return LEADING_COMMA;
+    if (rest->last_char == *OPERAND_SEPARATOR) return TRAILING_COMMA;
+    if (rest->consecutive_commas) return CONSECUTIVE_COMMAS;
+    lexed->source = trim_view(view_between(rest_start, rest->comma_count > 0 ? rest->commas[0] : line_end));
+    if (rest->comma_count > 0) {
+        lexed->destination = trim_view(view_between(rest->commas[0] + 1,
+                                                     rest->comma_count > 1 ? rest->commas[1] : line_end));
+    }
+    else lexed->destination = view_between(line_end, line_end);
+    view_copy(lexed->source, source);
+    view_copy(lexed->destination, destination);
+    if (is_line_blank(source)) return MISSING_SOURCE;
+    if (strpbrk(source, BLANKS)) return MISSING_COMMA;
+    if (is_line_blank(destination)) return MISSING_DESTINATION;
+    if (strpbrk(destination, BLANKS) || rest->comma_count > 1) return EXTRA_AFTER_DESTINATION;
+    lexed->source_method = get_address_method(source);
+    lexed->destination_method = get_address_method(destination);
+    return NO_OPERAND_ERROR;
+}
+
+/**
+ * Finds the operand of a one-operand instruction and the first syntax error in it, based on the scan of the part of
+ * the line after the operator.
+ * The operand is the first blank-separated token, so the errors are checked in this order: a missing operand, a comma
+ * at the start or end of the operand, a comma in the middle of the operand (which means there are too many operands)
+ * and extra characters after the operand.
+ *
+ * @param lexed    a pointer to the lexed line
+ * @param rest     a pointer to the scan of the part after the operator
+ * @param line_end a pointer to the terminating 0 of the line
+ * @return the first syntax error in the operand, or NO_OPERAND_ERROR if there is none
+ */
+static OperandError lex_one_operand(LexedLine *lexed, RestScan *rest, char *line_end) {
+    /* a copy of the operand, which the checks and the address method are based on */
+    char destination[MAX_LINE_LENGTH + 1];
+    if (rest->token_start != NULL) lexed->destination = view_between(rest->token_start, rest->token_end);
+    else lexed->destination = view_between(line_end, line_end);
+    view_copy(lexed->destination, destination);
+    if (is_line_blank(destination)) return MISSING_DESTINATION;
+    if (first_non_blank(destination) == *OPERAND_SEPARATOR || last_non_blank(destination) == *OPERAND_SEPARATOR) {
+        return ILLEGAL_COMMA;
+    }
+    if (exists(destination, *OPERAND_SEPARATOR)) return TOO_MANY_OPERANDS;
+    if (rest->extra_after_token) return EXTRA_AFTER_DESTINATION;
+    lexed->destination_method = get_address_method(destination);
+    return NO_OPERAND_ERROR;
+}
+
+/**
+ * Records a character of the part of the line after the operator or directive in the scan of that part.
+ *
+ * @param rest      a pointer to the scan of the part after the operator or directive
+ * @param character a pointer to the character, which should not be the terminating 0
+ */
+static void scan_rest_character(RestScan *rest, char *character) {
+    char c = *character;
+    /* finds the first blank-separated token, and whether anything other than whitespaces comes after it */
+    if (IS_BLANK(c)) {
+        if (rest->token_start != NULL && rest->token_end == NULL) rest->token_end = character;
+    }
+    else if (rest->token_start == NULL) rest->token_start = character;
+    else if (rest->token_end != NULL && !isspace((unsigned char) c)) rest->extra_after_token = 1;
+    /* finds the first and last non-whitespace characters and the commas between them */
+    if (isspace((unsigned char) c)) return;
+    if (rest->first_char == '\0') rest->first_char = c;
+    if (c == *OPERAND_SEPARATOR) {
+        /* if the last non-whitespace character was a comma too, the commas are consecutive */
+        if (rest->last_char == *OPERAND_SEPARATOR) rest->consecutive_commas = 1;
+        if (rest->comma_count < 2) rest->commas[rest->comma_count] = character;
+        rest->comma_count++;
+    }
+    rest->last_char = c;
+}
+
+/**
+ * Lexes a line - classifies it and finds its label, its operator or directive, and its operands (if they have no
+ * syntax errors) with their address methods.
+ *
+ * Does so by going over the characters of the line once. On the way, keeps track of whether the line has any
+ * non-whitespace character or a semicolon, finds the first field and (if it is a label) the field after it, and scans
+ * the part after the field for the commas and tokens that the operands are made of.
+ * Then, classifies the line in the order in which the first pass checks it: a blank line, a comment, a misplaced
+ * semicolon, a label without anything after it, a directive, or an instruction - whose operands are taken from the
+ * scan based on the number of operands that its operator requires.
+ *
+ * @param line  the line to be lexed, which should be at most MAX_LINE_LENGTH characters long
+ * @param lexed a pointer to the structure that the result should be written into
+ */
+void lex_line(char *line, LexedLine *lexed) {
+    LexerState state = BEFORE_FIRST_FIELD;
+    RestScan rest;
+    /* the current character */
+    char *p;
+    /* the bounds of the first field, and of the operator or directive */
+    char *first_start = NULL, *first_end = NULL, *field_start = NULL, *field_end = NULL;
+    /* whether the line has a non-whitespace character at all, and after the first field */
+    int non_blank = 0, non_blank_after_first = 0;
+    int semicolon_found = 0;
+    /* a copy of the operator or directive */
+    char field[MAX_LINE_LENGTH + 1];
+    const Keyword *keyword;
+    memset(&rest, 0, sizeof(rest));
+    rest.token_start = rest.token_end = NULL;
+    lexed->has_label = 0;
+    lexed->op = operators()[NUMBER_OF_OPERATORS];
+    lexed->operand_error = NO_OPERAND_ERROR;
+    lexed->source = lexed->destination = view_between(line, line);
+    lexed->source_method = NO_OPERAND;
+    lexed->destination_method = NO_OPERAND;
+    for (p = line; ; p++) {
+        if (*p != '\0' && !isspace((unsigned char) *p)) {
+            non_blank = 1;
+            if (*p == COMMENT_START) semicolon_found = 1;
+            if (first_end != NULL) non_blank_after_first = 1;
+        }
+        switch (state) {
+            case BEFORE_FIRST_FIELD:
+                if (IS_BLANK(*p)) break;
+                first_start = p;
+                state = IN_FIRST_FIELD;
+                /* falls through, since the character is the first one of the field */
+            case IN_FIRST_FIELD:
+                if (*p != '\0' && !IS_BLANK(*p)) break;
+                first_end = p;
+                /* if the first field is a label, the operator or directive is the field after it. A field that starts
+                 * with a semicolon is part of a comment, so it is never a label */
+                if (first_end > first_start && first_end[-1] == LABEL_END && *first_start != COMMENT_START) {
+                    lexed->has_label = 1;
+                    state = BEFORE_FIELD;
+                }
+                else {
+                    field_start = first_start;
+                    field_end = p;
+                    state = IN_REST;
+                }
+                break;
+            case BEFORE_FIELD:
+                if (IS_BLANK(*p)) break;
+                field_start = p;
+                state = IN_FIELD;
+                /* falls through, since the character is the first one of the field */
+            case IN_FIELD:
+                if (*p != '\0' && !IS_BLANK(*p)) break;
+                field_end = p;
+                state = IN_REST;
+                break;
+            case IN_REST:
+                if (*p != '\0') scan_rest_character(&rest, p);
+                break;
+        }
+        if (*p == '\0') break;
+    }
+    if (rest.token_start != NULL && rest.token_end == NULL) rest.token_end = p;
+    if (lexed->has_label) lexed->label = view_between(first_start, first_end - 1);
+    /* a label without anything after it is followed by an empty field */
+    if (field_start == NULL) field_start = field_end = p;
+    lexed->field = view_between(field_start, field_end);
+    lexed->rest = field_end;
+    /* classifies the line in the order in which it is checked */
+    if (!non_blank) lexed->kind = BLANK_LINE;
+    else if (line[0] == COMMENT_START) lexed->kind = COMMENT_LINE;
+    else if (semicolon_found) lexed->kind = MISPLACED_COMMENT_LINE;
+    else if (lexed->has_label && !non_blank_after_first) lexed->kind = LABEL_ONLY_LINE;
+    else lexed->kind = INSTRUCTION_LINE;
+    if (lexed->kind != INSTRUCTION_LINE) return;
+    view_copy(lexed->field, field);
+    /* if the field starts with a period it is a directive, which is only legal if it is a directive keyword */
+    if (is_directive(field)) {
+        keyword = find_keyword(field);
+        if (keyword != NULL && keyword->kind == DIRECTIVE_KEYWORD) lexed->kind = DATA_LINE + keyword->value;
+        else lexed->kind = ILLEGAL_DIRECTIVE_LINE;
+        return;
+    }
+    lexed->op = get_operator(field);
+    if (lexed->op.opcode == NUMBER_OF_OPERATORS) return;
+    /* finds the operands based on the number of operands that the operator requires */
+    if (has_source(lexed->op)) lexed->operand_error = lex_two_operands(lexed, &rest, field_end, p);
+    else if (has_destination(lexed->op)) lexed->operand_error = lex_one_operand(lexed, &rest, p);
+    else if (rest.first_char != '\0') lexed->operand_error = EXTRA_AFTER_INSTRUCTION;
+}
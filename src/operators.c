@@ -3,7 +3,8 @@
  */
 
 #include "../headers/operators.h"
-#include "../headers/util/string_ops.h"
+#include "../headers/keywords.h"
+#include "stddef.h"
 
 /**
  * Checks if a given address method is legal as source address method for the given operator.
@@ -55,95 +56,87 @@ int has_destination(Operator op) {
     return op.legal_destination_methods;
 }
 
+/* The sets of legal address methods used by the operators, where the nth bit from the right (starting at 0) is on if
+ * and only if address method n is included in the set */
+#define NO_METHODS 0
+#define DIRECT_ADDRESS_ONLY (1 << DIRECT_ADDRESS)
+#define JUMP_METHODS ((1 << DIRECT_ADDRESS) | (1 << INDIRECT_REGISTER_ADDRESS))
+#define NON_IMMEDIATE_METHODS ((1 << DIRECT_ADDRESS) | (1 << INDIRECT_REGISTER_ADDRESS) | \
+                               (1 << DIRECT_REGISTER_ADDRESS))
+#define ALL_METHODS ((1 << IMMEDIATE_ADDRESS) | NON_IMMEDIATE_METHODS)
+
 /**
- * Creates an operator based on the given values.
- * 
- * @param name                      the name of the operator
- * @param legal_source_methods      a string of 4 characters, where the nth character from the right is '1' if address
- *                                  method n is a legal source address method for the operator and '0' otherwise.
- * @param legal_destination_methods a string of 4 characters, where the nth character from the right is '1' if address
- *                                  method n is a legal destination address method for the operator and '0' otherwise.
- * @return the newly created operator
+ * The list of the operators, where each operator's index is its opcode, based on the task definition.
+ * Also includes an additional, illegal operator which is used for default return values of functions that look for an
+ * operator on the list.
+ * The list is constant and initialized at compile time, so it can be shared by several assemblies that run at the same
+ * time.
  */
-static Operator create_operator(char *name, char *legal_source_methods, char *legal_destination_methods) {
-    Operator op;
-    op.name = name;
-    op.legal_source_methods = binary_string_to_number(legal_source_methods);
-    op.legal_destination_methods = binary_string_to_number(legal_destination_methods);
-    return op;
-}
+static const Operator operator_list[NUMBER_OF_OPERATORS + 1] = {
+        {"mov", ALL_METHODS, NON_IMMEDIATE_METHODS, 0},
+        {"cmp", ALL_METHODS, ALL_METHODS, 1},
+        {"add", ALL_METHODS, NON_IMMEDIATE_METHODS, 2},
+        {"sub", ALL_METHODS, NON_IMMEDIATE_METHODS, 3},
+        {"lea", DIRECT_ADDRESS_ONLY, NON_IMMEDIATE_METHODS, 4},
+        {"clr", NO_METHODS, NON_IMMEDIATE_METHODS, 5},
+        {"not", NO_METHODS, NON_IMMEDIATE_METHODS, 6},
+        {"inc", NO_METHODS, NON_IMMEDIATE_METHODS, 7},
+        {"dec", NO_METHODS, NON_IMMEDIATE_METHODS, 8},
+        {"jmp", NO_METHODS, JUMP_METHODS, 9},
+        {"bne", NO_METHODS, JUMP_METHODS, 10},
+        {"red", NO_METHODS, NON_IMMEDIATE_METHODS, 11},
+        {"prn", NO_METHODS, ALL_METHODS, 12},
+        {"jsr", NO_METHODS, JUMP_METHODS, 13},
+        {"rts", NO_METHODS, NO_METHODS, 14},
+        {"stop", NO_METHODS, NO_METHODS, 15},
+        /* Illegal operator */
+        {ILLEGAL_OPERATOR_NAME, NO_METHODS, NO_METHODS, NUMBER_OF_OPERATORS}
+};
 
 /**
  * Returns a static list of the operators, where each operator's index is its opcode.
- * Does so by creating an operator for every index based on the task definition.
  * Also includes an additional, illegal operator which is used for default return values of functions that look for an
  * operator on the list.
  * 
  * @return the list described in the function summary
  */
-Operator *operators() {
-    static Operator operators[NUMBER_OF_OPERATORS + 1];
-    operators[0] = create_operator("mov", "1111", "1110");
-    operators[1] = create_operator("cmp", "1111", "1111");
-    operators[2] = create_operator("add", "1111", "1110");
-    operators[3] = create_operator("sub", "1111", "1110");
-    operators[4] = create_operator("lea", "0010", "1110");
-    operators[5] = create_operator("clr", "0000", "1110");
-    operators[6] = create_operator("not", "0000", "1110");
-    operators[7] = create_operator("inc", "0000", "1110");
-    operators[8] = create_operator("dec", "0000", "1110");
-    operators[9] = create_operator("jmp", "0000", "0110");
-    operators[10] = create_operator("bne", "0000", "0110");
-    operators[11] = create_operator("red", "0000", "1110");
-    operators[12] = create_operator("prn", "0000", "1111");
-    operators[13] = create_operator("jsr", "0000", "0110");
-    operators[14] = create_operator("rts", "0000", "0000");
-    operators[15] = create_operator("stop", "0000", "0000");
-    /* Illegal operator */
-    operators[16] = create_operator(ILLEGAL_OPERATOR_NAME, "0000", "0000");
-    return operators;
+const Operator *operators() {
+    return operator_list;
 }
 
 /**
  * Returns the opcode of an operator based on its name.
- * Does so by going over every index of the operator list (every opcode), and if the operator with a certain opcode has
- * the given name, returns the opcode. If no operator with the given name was found, returns 16.
+ * Does so by looking the name up as a keyword - if it is an operator, the keyword's value is its opcode. Otherwise,
+ * returns 16.
  * 
  * @param operator_name the name of the operator
  * @return the operator's opcode, or 16 if there is no operator with the given name
  */
 int get_opcode(char *operator_name) {
-    int i;
-    for (i = 0; i < NUMBER_OF_OPERATORS; i++) {
-        if (equal(operators()[i].name, operator_name)) return i;
-    }
-    return NUMBER_OF_OPERATORS;
+    const Keyword *keyword = find_keyword(operator_name);
+    if (keyword == NULL || keyword->kind != OPERATOR_KEYWORD) return NUMBER_OF_OPERATORS;
+    return keyword->value;
 }
 
 /**
  * Returns an operator based on its name.
- * Does so by going every operator in the operator list, and if there is an operator with the given name, returns it.
- * If no operator with the given name was found, returns the illegal operator.
+ * Does so by finding its opcode and returning the operator at that index of the operator list, which is the illegal
+ * operator if no operator with the given name exists.
  * 
  * @param operator_name the name of the operator
  * @return the operator, or the illegal operator if no such operator exists
  */
 Operator get_operator(char *operator_name) {
-    int i;
-    for (i = 0; i < NUMBER_OF_OPERATORS; i++) {
-        if (equal(operators()[i].name, operator_name)) return operators()[i];
-    }
-    return operators()[NUMBER_OF_OPERATORS];
+    return operator_list[get_opcode(operator_name)];
 }
 
 /**
  * Checks if a given name is a valid operator name.
- * Does so by checking that the operator with the given name retrieved from the operator list is not the illegal
- * operator (checks that their names are different).
+ * Does so by checking that the name's opcode is not the one that represents the illegal operator.
  * 
  * @param name the name to be checked
  * @return 1 if the name is the name of a legal operator, 0 otherwise
  */
 int is_operator(char *name) {
-    return !equal((get_operator(name)).name, ILLEGAL_OPERATOR_NAME);
+    return get_opcode(name) != NUMBER_OF_OPERATORS;
 }
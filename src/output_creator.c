@@ -6,6 +6,10 @@
 #include "../headers/requirements.h"
 #include "../headers/files.h"
 #include "../headers/output_creator.h"
+#include "../headers/alloc_failure_handler.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
 
 /**
  * The number of digits that a printing of an address should take.
@@ -17,28 +21,57 @@
  */
 #define ENCODING_LENGTH 5
 
+/**
+ * The number of characters in a line of the object file - an address, a space, an encoding and a line break, plus
+ * one more character for an encoding that does not fit in ENCODING_LENGTH octal digits.
+ */
+#define OBJECT_LINE_LENGTH (ADDRESS_LENGTH + ENCODING_LENGTH + 3)
+
+/**
+ * The maximum number of characters in the first line of the object file, which holds two integers.
+ */
+#define OBJECT_HEADER_LENGTH 32
+
+/**
+ * The two decimal digits of every number from 0 to 99, one pair after the other.
+ */
+static const char decimal_pairs[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+/**
+ * The two octal digits of every number from 0 to 63, one pair after the other.
+ */
+static const char octal_pairs[] =
+    "0001020304050607101112131415161720212223242526273031323334353637"
+    "4041424344454647505152535455565760616263646566677071727374757677";
+
 /** PROTOTYPES FOR FUNCTIONS DEFINED LATER IN THE FILE **/
 /** FOR DOCUMENTATION, SEE DEFINITIONS **/
 
-static int is_extern(SymbolContent symbol);
+static int write_object_file(char file_name[], Requirements *requirements);
 
-static int is_entry(SymbolContent symbol);
+static int write_extern_file(char file_name[], Requirements *requirements);
 
-static int write_object_file(char file_name[], Requirements *requirements);
+static int write_entry_file(char file_name[], Requirements *requirements);
+
+static char *allocate_output(long length);
 
-static int write_extern_file(char file_name[], LinkedList *extern_list);
+static char *format_address(char *output, int address);
 
-static int write_entry_file(char file_name[], LinkedList *entry_list);
+static char *format_encoding(char *output, unsigned short word);
+
+static char *format_symbol_line(char *output, char *name, int max_symbol_length, int address);
 
 /**
  * Creates the output files for an assembly file based on its filled requirements.
  * Will only create .ext and .ent files if they will not be empty.
  * 
  * Does so by first creating the object file based on the requirements.
- * Next, fills two linked-lists with symbols - one with the external symbols and one with the entry symbols.
  * If the extern_found field in the requirements is on, then an extern symbol is used, so a .ext file is created.
- * If the entry list is not empty, then a symbol is defined as entry, and therefore a .ent file is created.
- * Finally, frees the lists without freeing their contents, since it is freed later when freeing the requirements.
+ * If the index of entry symbols is not empty, then a symbol is defined as entry, and therefore a .ent file is created.
+ * Both files are written from the symbol indexes in the requirements, which are filled while the passes run, so the
+ * symbol table is not searched for them.
  * 
  * @param file_name    the extensionless file name
  * @param requirements a pointer to the requirements of the file
@@ -47,156 +80,195 @@ static int write_entry_file(char file_name[], LinkedList *entry_list);
 int create_files(char file_name[], Requirements *requirements) {
     /* whether an error has occurred */
     int error_found = 0;
-    /* list of external symbols */
-    LinkedList *extern_list = create_list(SYMBOL);
-    /* list of entry symbols */
-    LinkedList *entry_list = create_list(SYMBOL);
-    
-    /* if a memory allocation failure has occurred, stops and returns 1 to signify error */
-    if (extern_list == NULL || entry_list == NULL) return 1;
-    
-    /* fills the symbol lists based on the symbol table */
-    map_add_matching_to_list(requirements->symbol_table, extern_list, is_extern);
-    map_add_matching_to_list(requirements->symbol_table, entry_list, is_entry);
     
     /* writes the object file and updates error_found */
     error_found |= write_object_file(file_name, requirements);
     
     /* creates a .ext file if an external symbol is used */
-    if (requirements->extern_found) error_found |= write_extern_file(file_name, extern_list);
+    if (requirements->extern_found) error_found |= write_extern_file(file_name, requirements);
     /* creates a .ent file if an entry symbol is defined */
-    if (!list_empty(entry_list)) error_found |= write_entry_file(file_name, entry_list);
-    
-    /* shallow-frees the lists since their contents are freed later */
-    shallow_free_list(extern_list);
-    shallow_free_list(entry_list);
+    if (requirements->entry_symbols.count > 0) error_found |= write_entry_file(file_name, requirements);
     return error_found;
 }
 
 /**
  * Creates and writes the object file based on the file's requirements.
  * 
- * Does so by first creating the file and printing the instruction count (minus its start value) and the data count to
- * its first line.
- * Then, prints the instructions and their addresses one by one, and then the data and its addresses one by one,
- * based on the memory image in the requirements.
+ * Does so by first allocating a buffer that can hold the entire file, whose size is known from the instruction and data
+ * counts, and printing the instruction count (minus its start value) and the data count to its first line.
+ * Then, formats the instructions and their addresses one by one, and then the data and its addresses one by one,
+ * based on the memory image in the requirements. Finally, writes the buffer to the file all at once.
  * 
  * @param file_name the extensionless file name
  * @param requirements the file's requirements
  * @return 1 if an error has occurred, 0 otherwise
  */
 static int write_object_file(char file_name[], Requirements *requirements) {
-    FILE *file = get_object_file(file_name);
-    int i;
-    if (file == NULL) return 1;
+    int i, error_found;
+    /* the number of words in the memory image */
+    long word_count = (long) (requirements->ic - IC_START) + requirements->dc;
+    char *contents = allocate_output(OBJECT_HEADER_LENGTH + word_count * OBJECT_LINE_LENGTH);
+    /* the position in the buffer that the next character should be formatted into */
+    char *output;
+    if (contents == NULL) return 1;
     /* prints the instruction count (minus its start value) and the data count to its first line */
-    fprintf(file, "  %d %d\n", requirements->ic - IC_START, requirements->dc);
-    /* prints the instructions and their addresses one by one */
+    output = contents + sprintf(contents, "  %d %d\n", requirements->ic - IC_START, requirements->dc);
+    /* formats the instructions and their addresses one by one */
     for (i = IC_START; i < requirements->ic; i++) {
-        /* the address always takes 4 digits, the instruction is printed in octal and always takes 5 digits */
-        fprintf(file, "%0*d %0*o\n", ADDRESS_LENGTH, i, ENCODING_LENGTH, requirements->instruction_array[i]);
+        output = format_address(output, i);
+        *output++ = ' ';
+        output = format_encoding(output, requirements->instruction_array[i]);
+        *output++ = '\n';
     }
-    /* prints the data and its addresses one by one */
+    /* formats the data and its addresses one by one */
     for (i = 0; i < requirements->dc; i++) {
-        /* the address always takes 4 digits, the data is printed in octal and always takes 5 digits */
-        fprintf(file, "%0*d %0*o\n", ADDRESS_LENGTH, i + requirements->ic, ENCODING_LENGTH, 
-                requirements->data_array[i]);
+        output = format_address(output, i + requirements->ic);
+        *output++ = ' ';
+        output = format_encoding(output, requirements->data_array[i]);
+        *output++ = '\n';
     }
-    fclose(file);
-    return 0;
+    error_found = save_object_file(file_name, contents, output - contents, requirements->arena);
+    free(contents);
+    return error_found;
 }
 
 /**
- * Creates and writes the extern file based on the external symbol list.
+ * Creates and writes the extern file based on the index of external symbols.
  * 
- * Does so by first finding the length of the longest symbol name, then going over every item on the list.
- * For each item, prints the name of the symbol with enough padding to the right, and prints the address of every
- * instruction in the symbol's appearances list. The padding to the right is exactly enough to make all address start in
- * the same column, based on the longest name of any symbol on the list.
- * (All prints are to the .ext file)
+ * Does so by first reaching every symbol on the index through its handle and counting the appearances of all of them,
+ * and allocating a buffer that can hold the entire file. Then, goes over the symbols in the order in which they were
+ * declared. For each symbol, formats its name with enough padding to the right, and the address of every instruction
+ * in the symbol's appearances array. The padding to the right is exactly enough to make all address start in the same
+ * column, based on the longest name of any symbol on the index (which is kept up to date as symbols are declared).
+ * Finally, writes the buffer to the .ext file all at once.
  * 
- * @param file_name the extensionless file name
+ * @param file_name    the extensionless file name
  * @param requirements the file's requirements
  * @return 1 if an error has occurred, 0 otherwise
  */
-static int write_extern_file(char file_name[], LinkedList *extern_list) {
-    FILE *file = get_extern_file(file_name);
-    /* the item on the external symbol list */
-    Node *node;
-    /* the length of the longest name of any symbol in the list */
-    int max_symbol_length;
-    if (file == NULL) return 1;
-    max_symbol_length = get_max_name_length(extern_list);
-    node = extern_list->head;
-    /* for every item on the external symbol list */
-    while (node != NULL) {
-        /* an item on the symbol's appearances list */
-        Node *appearance = node->content.symbol.appearances->head;
-        /* for every appearance */
-        while (appearance != NULL) {
-            /* prints the symbol's name and the appearance to the file, with right padding for the names and 
-             * left padding for the addresses */
-            fprintf(file, "%-*s %0*d\n", max_symbol_length, node->name, 
-                    ADDRESS_LENGTH, appearance->content.num);
-            appearance = appearance->next;
-        }
-        node = node->next;
+static int write_extern_file(char file_name[], Requirements *requirements) {
+    SymbolIndex *index = &requirements->extern_symbols;
+    /* the number of lines in the file */
+    long line_count = 0;
+    int i, j, error_found;
+    char *contents, *output;
+    /* counts the appearances of all symbols, each of which takes a line */
+    for (i = 0; i < index->count; i++)
+        line_count += map_get_symbol_at(requirements->symbol_table, index->handles[i])->appearances.count;
+    contents = allocate_output(line_count * (index->max_name_length + ADDRESS_LENGTH + 2));
+    if (contents == NULL) return 1;
+    output = contents;
+    /* for every external symbol */
+    for (i = 0; i < index->count; i++) {
+        Appearances *appearances = &map_get_symbol_at(requirements->symbol_table, index->handles[i])->appearances;
+        char *name = map_get_name_at(requirements->symbol_table, index->handles[i]);
+        /* for every appearance, formats the symbol's name and the appearance, with right padding for the names and 
+         * left padding for the addresses */
+        for (j = 0; j < appearances->count; j++)
+            output = format_symbol_line(output, name, index->max_name_length, appearances->addresses[j]);
     }
-    fclose(file);
-    return 0;
+    error_found = save_extern_file(file_name, contents, output - contents, requirements->arena);
+    free(contents);
+    return error_found;
 }
 
 
 /**
- * Creates and writes the entry file based on the entry symbol list.
- * Does so by first finding the length of the longest symbol name on the list, then going over every item on the list.
- * For each item, and prints its name and value to the file. The name is padded to the right exactly enough to make sure
- * all values start at the same column, based on the length of the longest symbol name on the list. The value is padded
- * to the left to make sure it is 4 digits long.
+ * Creates and writes the entry file based on the index of entry symbols.
+ * Does so by allocating a buffer that can hold the entire file, whose size is known from the number of symbols on the
+ * index and the length of the longest name on it. Then, goes over the symbols in the order in which they were marked
+ * as entries, and for each one, reaches it through its handle and formats its name and value. The name is padded to
+ * the right exactly enough to make sure all values start at the same column. The value is padded to the left to make
+ * sure it is 4 digits long.
+ * Finally, writes the buffer to the .ent file all at once.
  * 
- * @param file_name the extensionless file name
+ * @param file_name    the extensionless file name
  * @param requirements the file's requirements
  * @return 1 if an error has occurred, 0 otherwise
  */
-static int write_entry_file(char file_name[], LinkedList *entry_list) {
-    FILE *file = get_entry_file(file_name);
-    /* the item on the entry symbol list */
-    Node *node;
-    /* the length of the longest name of any symbol in the list */
-    int max_symbol_length;
-    if (file == NULL) return 1;
-    node = entry_list->head;
-    max_symbol_length = get_max_name_length(entry_list);
-    /* for every item on the entry list */
-    while (node != NULL) {
-        /* prints the symbol's name and value to the file, the value is always 4 digits long and the symbol
-         * is padded to the right if necessary */
-        fprintf(file, "%-*s %0*d\n", max_symbol_length, node->name, ADDRESS_LENGTH, 
-                node->content.symbol.value);
-        node = node->next;
+static int write_entry_file(char file_name[], Requirements *requirements) {
+    SymbolIndex *index = &requirements->entry_symbols;
+    int i, error_found;
+    char *contents = allocate_output((long) index->count * (index->max_name_length + ADDRESS_LENGTH + 2));
+    char *output = contents;
+    if (contents == NULL) return 1;
+    /* for every entry symbol, formats its name and value - the value is always 4 digits long and the symbol is padded
+     * to the right if necessary */
+    for (i = 0; i < index->count; i++) {
+        SymbolContent *symbol = map_get_symbol_at(requirements->symbol_table, index->handles[i]);
+        output = format_symbol_line(output, map_get_name_at(requirements->symbol_table, index->handles[i]),
+                                    index->max_name_length, get_symbol_address(requirements, *symbol));
+    }
+    error_found = save_entry_file(file_name, contents, output - contents, requirements->arena);
+    free(contents);
+    return error_found;
+}
+
+/**
+ * Allocates a buffer that an output file is formatted into before it is written.
+ * 
+ * @param length the maximum number of characters that the file may hold
+ * @return a pointer to the buffer (allocated on the heap), or NULL if an allocation failure has occurred
+ */
+static char *allocate_output(long length) {
+    /* allocates at least one character, so an empty file doesn't look like an allocation failure */
+    char *buffer = malloc(length > 0 ? length : 1);
+    if (buffer == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating output file\n");
+        set_alloc_failure();
     }
-    fclose(file);
-    return 0;
+    return buffer;
+}
+
+/**
+ * Formats an address in decimal, padded to the left with zeros, into a given position in an output buffer.
+ * Since every address is lower than the memory size, it always takes exactly 4 digits.
+ * Does so by looking up the two pairs of digits (the hundreds and the rest) in a table of digit pairs.
+ * 
+ * @param output  the position in the buffer that the address should be formatted into
+ * @param address the address to be formatted
+ * @return the position in the buffer right after the address
+ */
+static char *format_address(char *output, int address) {
+    memcpy(output, decimal_pairs + 2 * (address / 100), 2);
+    memcpy(output + 2, decimal_pairs + 2 * (address % 100), 2);
+    return output + ADDRESS_LENGTH;
 }
 
 /**
- * Checks if a given symbol is external.
- * Used as a condition to copy symbols to the external symbol list.
+ * Formats a word in octal, padded to the left with zeros to at least 5 digits, into a given position in an output
+ * buffer.
+ * Does so by writing the digits above the lowest 12 bits directly, and looking up the two pairs of digits for the
+ * lowest 12 bits (6 bits each) in a table of octal digit pairs.
  * 
- * @param symbol the symbol to be checked
- * @return 1 if the symbol is external, 0 otherwise
+ * @param output the position in the buffer that the word should be formatted into
+ * @param word   the word to be formatted
+ * @return the position in the buffer right after the word
  */
-static int is_extern(SymbolContent symbol) {
-    return symbol.type == EXTERNAL;
+static char *format_encoding(char *output, unsigned short word) {
+    /* a word wider than 15 bits takes an extra digit */
+    if (word >> 15) *output++ = (char) ('0' + (word >> 15));
+    *output++ = (char) ('0' + ((word >> 12) & 07));
+    memcpy(output, octal_pairs + 2 * ((word >> 6) & 077), 2);
+    memcpy(output + 2, octal_pairs + 2 * (word & 077), 2);
+    return output + 4;
 }
 
 /**
- * Checks if a given symbol is an entry.
- * Used as a condition to copy symbols to the entry symbol list.
+ * Formats a line of the extern or entry file - a symbol name padded to the right, a space and an address - into a
+ * given position in an output buffer.
  * 
- * @param symbol the symbol to be checked
- * @return 1 if the symbol is an entry, 0 otherwise
+ * @param output            the position in the buffer that the line should be formatted into
+ * @param name              the name of the symbol
+ * @param max_symbol_length the length that the name should be padded to
+ * @param address           the address to be formatted after the name
+ * @return the position in the buffer right after the line
  */
-static int is_entry(SymbolContent symbol) {
-    return symbol.type == ENTRY;
+static char *format_symbol_line(char *output, char *name, int max_symbol_length, int address) {
+    int name_length = strlen(name);
+    memcpy(output, name, name_length);
+    memset(output + name_length, ' ', max_symbol_length - name_length + 1);
+    output = format_address(output + max_symbol_length + 1, address);
+    *output++ = '\n';
+    return output;
 }
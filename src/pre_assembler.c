@@ -3,19 +3,23 @@
  * all of its macros using a hash-map that includes each macro's name and content (the macro table). The table is 
  * updated as the file is being read.
  * The main function in the file is pre-assemble, which takes in a file name without the .as extension and parses it
- * into a new .am file with the same name. If a .am file with this name already exists, deletes it and 
- * creates a new file. If any errors are found, the .am file is not created, but the program keeps analyzing the 
- * input file in order to find more errors.
+ * into the parsed source buffer of the file's requirements. Each line that is written into the parsed source is also
+ * kept as a parsed line (lexed, and with the number of the line in the input file it comes from), which is what the
+ * first pass goes over. If asked to, also writes the
+ * parsed source into a new .am file with the same name. If any errors are found, the .am file is not created, but the
+ * program keeps analyzing the input file in order to find more errors.
  * The function does so by reading the input file line by line. For each line, if a macro usage is detected (the first field
- * appears in the macro table) writes its content into the parsed file. Else, if a macro definition keyword is found as
+ * appears in the macro table) writes its content into the parsed source. Else, if a macro definition keyword is found as
  * the first field of the line, sees the second field of the line as the macro's name, and updates the macro's content
  * line by line until a macro end keyword is found, at which point the macro table is updated with the new macro.
- * If neither of these criteria is met, copies the file from the input file to the parsed file.
+ * If neither of these criteria is met, copies the line from the input file to the parsed source.
  * Assumes that the definition of every macro comes before its usage, that there are no nested macro definitions, that
  * a macro cannot be defined if a macro with the same name has already been defined, and that a macro definition and
  * ending cannot have labels.
  * Also, if a macro with a colon at the end is used, it is assumed to be a label (based on a forum answer, I can handle
  * it as I see fit as long as I provide adequate documentation).
+ * If the file may be handled by several threads, the macro table is first built by a scan over the definitions alone,
+ * and the rest of the file is then expanded in chunks that are handled at the same time (see pre_assemble_in_chunks).
  */
 
 #include "stdio.h"
@@ -26,190 +30,328 @@
 #include "../headers/util/general_util.h"
 #include "../headers/files.h"
 #include "../headers/alloc_failure_handler.h"
+#include "../headers/console.h"
+#include "../headers/lexer.h"
+#include "../headers/chunks.h"
 
 /**
- * Writes a macro's content into a file (should be the parsed file).
+ * The smallest number of lines that a chunk of an input file may have, when the file is split into chunks that are
+ * expanded at the same time.
+ */
+#define MIN_CHUNK_LINES 1024
+
+/**
+ * The number of split points that the memory of a file's split points can hold once the first one is found.
+ */
+#define INITIAL_SPLIT_POINT_CAPACITY 16
+
+/**
+ * A line of an input file that a chunk may start from - a line that is not a part of a macro definition.
+ */
+typedef struct {
+    /* the index in the input file in which the line starts */
+    long offset;
+    /* the number of the line in the input file */
+    int line;
+} SplitPoint;
+
+/**
+ * Represents a chunk of an input file's lines, which the pre-assembler expands on its own thread once the macro table
+ * has been built.
+ */
+typedef struct {
+    /* the state that every chunk shares, which the chunk's thread fills */
+    Chunk base;
+    /* the index in the input file in which the chunk's first line starts */
+    long first_offset;
+    /* the range of the numbers of the chunk's lines - from the first one to the one after the last */
+    int first_line;
+    int end_line;
+    /* the name of the input file (used for error reporting) */
+    char *input_file_name;
+    /* the input file, which the chunk reads from its own position */
+    SourceFile *input_file;
+    /* the requirements of the file, with the chunk's own parsed source and parsed lines (the rest is only read) */
+    Requirements requirements;
+} PreAssemblyChunk;
+
+/**
+ * Returns the position of a part of a line, given as a view into the line.
+ * 
+ * @param line the line
+ * @param view a view of the part, which should be inside the line
+ * @return the position of the part in the line
+ */
+static LinePart line_part(char *line, StringView view) {
+    LinePart part;
+    part.offset = view.start - line;
+    part.length = view.length;
+    return part;
+}
+
+/**
+ * Converts a lexed line into a parsed line, which does not depend on where the line is kept.
+ * Does so by converting the views of the lexed line into positions in the line, which stay valid wherever the line is
+ * copied to. The start of the line in the parsed source is left for the caller to set.
+ * 
+ * @param line        the line, which should be at most MAX_LINE_LENGTH characters long
+ * @param lexed       a pointer to the lexed line
+ * @param source_line the number of the line in the input file that the line comes from
+ * @return the parsed line
+ */
+static ParsedLine parse_line(char *line, LexedLine *lexed, int source_line) {
+    ParsedLine parsed_line;
+    parsed_line.start = 0;
+    parsed_line.source_line = source_line;
+    parsed_line.macro_line = -1;
+    parsed_line.label = line_part(line, lexed->label);
+    parsed_line.field = line_part(line, lexed->field);
+    parsed_line.source = line_part(line, lexed->source);
+    parsed_line.destination = line_part(line, lexed->destination);
+    parsed_line.rest.offset = lexed->rest - line;
+    parsed_line.rest.length = strlen(lexed->rest);
+    parsed_line.kind = lexed->kind;
+    parsed_line.has_label = lexed->has_label;
+    parsed_line.opcode = lexed->op.opcode;
+    parsed_line.operand_error = lexed->operand_error;
+    parsed_line.source_method = lexed->source_method;
+    parsed_line.destination_method = lexed->destination_method;
+    return parsed_line;
+}
+
+/**
+ * Appends a line to the parsed source, and adds its parsed line to the requirements. Blank lines and comments are only
+ * appended to the parsed source, since they have no effect on the assembly.
+ * 
+ * @param requirements a pointer to the requirements of the file
+ * @param line         the line to be appended, which should be at most MAX_LINE_LENGTH characters long
+ * @param lexed        a pointer to the lexed line
+ * @param source_line  the number of the line in the input file that the line comes from
+ */
+static void append_line(Requirements *requirements, char *line, LexedLine *lexed, int source_line) {
+    ParsedLine parsed_line;
+    int start = requirements->parsed_source->length;
+    text_buffer_append_line(requirements->parsed_source, line);
+    if (lexed->kind == BLANK_LINE || lexed->kind == COMMENT_LINE) return;
+    parsed_line = parse_line(line, lexed, source_line);
+    parsed_line.start = start;
+    add_parsed_line(requirements, parsed_line);
+}
+
+/**
+ * Checks if a character is the first character of the name of any macro in the macro table.
+ * 
+ * @param requirements a pointer to the requirements of the file
+ * @param c            the character to be checked
+ * @return 1 if a macro's name starts with the character, 0 otherwise
+ */
+static int is_macro_first_char(Requirements *requirements, char c) {
+    unsigned char bit = (unsigned char) c;
+    return (requirements->macro_first_chars[bit / CHAR_BIT] >> (bit % CHAR_BIT)) & 1;
+}
+
+/**
+ * Adds a character to the bitmap of the first characters of the macros' names.
+ * 
+ * @param requirements a pointer to the requirements of the file
+ * @param c            the first character of a macro's name
+ */
+static void add_macro_first_char(Requirements *requirements, char c) {
+    unsigned char bit = (unsigned char) c;
+    requirements->macro_first_chars[bit / CHAR_BIT] |= 1 << (bit % CHAR_BIT);
+}
+
+/**
+ * Writes a macro's content into the parsed source.
+ * Does so by stamping out the lines of the content one by one - copying each line from the input file to the parsed
+ * source, and copying its parsed line (which was made when the macro was defined) with its new start in the parsed
+ * source. The lines are not lexed again, and each one keeps the number of its line in the macro's definition.
  * Assumes that the macro exists in the macro table.
  * 
- * @param macro       the name of the macro
- * @param macro_table a pointer to the macro table
- * @param parsed_file a pointer to the parsed file that the macro content should be written to.
+ * @param macro        the name of the macro
+ * @param requirements a pointer to the requirements of the file
+ * @param input_file   a pointer to the input file that the macro was defined in
  */
-static void handle_macro_usage(char *macro, HashMap *macro_table, FILE *parsed_file) {
-    MacroContent macro_content = *map_get_macro(macro_table, macro);
-    fprintf(parsed_file, "%s", macro_content);
+static void handle_macro_usage(char *macro, Requirements *requirements, SourceFile *input_file) {
+    MacroContent macro_content = *map_get_macro(requirements->macro_table, macro);
+    TextBuffer *parsed_source = requirements->parsed_source;
+    MacroLine *macro_line;
+    ParsedLine parsed_line;
+    int i;
+    for (i = macro_content.first_index; i < macro_content.first_index + macro_content.line_count; i++) {
+        macro_line = &requirements->macro_lines[i];
+        parsed_line = macro_line->parsed;
+        parsed_line.start = parsed_source->length;
+        parsed_line.macro_line = i;
+        /* an empty line may start after the end of the input file, so nothing is copied for it */
+        if (macro_line->length > 0) {
+            text_buffer_append_characters(parsed_source, input_file->text + macro_line->offset, macro_line->length);
+        }
+        text_buffer_append(parsed_source, "\n");
+        if (parsed_line.kind != BLANK_LINE && parsed_line.kind != COMMENT_LINE) {
+            add_parsed_line(requirements, parsed_line);
+        }
+    }
 }
 
 /**
  * Checks if a line in the input file includes a macro usage (must be the first field of the line), and if it does, 
- * writes the macro content into the parsed file. Also makes sure that there is no label before the macro usage, and
+ * writes the macro content into the parsed source. Also makes sure that there is no label before the macro usage, and
  * if there is, reports an error.
  * If a macro with a colon at the end is used, it is assumed to be a label (based on a forum answer, I can handle
  * it as I see fit as long as I provide adequate documentation).
  * 
- * @param macro_table     a pointer to the macro table
- * @param line            the line being analyzed (not including a potential label)
- * @param label           the line's label (or null if there isn't one)
- * @param parsed_file     a pointer to the parsed file
+ * Most lines are not macro usages, so the macro table is only searched if the first field starts with the first
+ * character of a macro's name.
+ * 
+ * @param requirements    a pointer to the requirements of the file
+ * @param input_file      a pointer to the input file
+ * @param lexed           a pointer to the lexed line being analyzed
  * @param line_count      the number of the line being checked in the input file (used for error reporting)
  * @param input_file_name the name of the input file (used for error reporting)
  * @param error_found     a pointer to an integer value that should hold whether an error has occurred
  * @return 1 if a macro usage was found, 0 otherwise
  */
-static int check_and_handle_macro_usage(HashMap *macro_table, char *line, char *label,
-                                 FILE *parsed_file, int line_count, char *input_file_name, int *error_found) {
-    /* the part of the line after the first field (excluding a potential label) */
-    char *rest;
+static int check_and_handle_macro_usage(Requirements *requirements, SourceFile *input_file, LexedLine *lexed,
+                                        int line_count, char *input_file_name, int *error_found) {
     /* the first field of the line (excluding a potential label), which is checked to be a macro usage */
-    char *first_field = find_token(line, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (first_field == NULL) {
-        *error_found = 1;
-        return 0;
-    }
-    /* checks if the first field is a known macro, if it isn't, returns 0, otherwise the first field is 
-     * known to be a macro usage */
-    if (!map_contains(macro_table, first_field)) {
-        free(first_field);
+    char first_field[MAX_LINE_LENGTH + 1];
+    if (lexed->field.length == 0 || !is_macro_first_char(requirements, lexed->field.start[0])) return 0;
+    view_copy(lexed->field, first_field);
+    /* checks if the first field is a macro that was defined before the line, if it isn't, returns 0, otherwise the
+     * first field is known to be a macro usage (the table may also hold the macros that are defined later in the
+     * file, if it was built before the file was expanded) */
+    if (!map_contains(requirements->macro_table, first_field) ||
+        map_get_macro(requirements->macro_table, first_field)->definition_line > line_count) {
         return 0;
     }
     /* checks if there is a label before the macro usage */
-    if (label != NULL) {
-        printf("Input Error: Label used before macro usage in line %d of file %s\n", line_count, input_file_name);
+    if (lexed->has_label) {
+        console_printf("Input Error: Label used before macro usage in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
     }
-    free(label);
     /* makes sure the macro usage is the only field in the line */
-    if (!is_line_blank(rest)) {
-        printf("Input Error: Extra characters after macro usage in line %d of file %s\n",
-               line_count, input_file_name);
+    if (!is_line_blank(lexed->rest)) {
+        console_printf("Input Error: Extra characters after macro usage in line %d of file %s\n",
+                       line_count, input_file_name);
         *error_found = 1;
     }
-    /* if no error was found, copies the macro content to the parsed file */
-    if (!(*error_found)) {
-        handle_macro_usage(first_field, macro_table, parsed_file);
-        free(first_field);
-        return 1;
-    }
-    /* a macro was found but was not copied due to a previous error */
-    free(first_field);
+    /* if no error was found, copies the macro content to the parsed source (otherwise, a macro was found but was not
+     * copied due to a previous error) */
+    if (!(*error_found)) handle_macro_usage(first_field, requirements, input_file);
     return 1;
 }
 
 /**
  * Checks if a currently-read macro definition has ended, and if it has, inserts it into the macro table.
  * Does so by checking if the first field of the line is the macro end keyword, and making sure that it is the
- * only field (there is no label and there are no characters after the keyword). If so, inserts the macro name and
- * content to the table.
+ * only field (there is no label and there are no characters after the keyword). If so, inserts the macro to the
+ * table with a copy of its name that is allocated from the file's arena, and with the lines of the macros' contents
+ * that were added since its definition started as its content.
  * 
- * @param macro_table     a pointer to the macro table
- * @param macro_name      the name of the macro whose definition is being read
- * @param line            the current line being analyzed (including a potential label)
+ * @param requirements    a pointer to the requirements of the file
+ * @param macro_name      a view of the name of the macro whose definition is being read
+ * @param lexed           a pointer to the current line being analyzed, after it has been lexed
  * @param error_found     a pointer to an integer value that should hold whether an error has occurred
  * @param line_count      the number of the line being checked in the input file (used for error reporting)
  * @param input_file_name the name of the input file (used for error reporting)
- * @param macro_content   the content of the macro being defined
+ * @param first_index     the index of the content's first line in the lines of the macros' contents
+ * @param definition_line the number of the line in the input file in which the macro's definition starts
  * @return 1 if the macro end has been found or an error has occurred, 0 otherwise
  */
-static int check_and_handle_macro_end(HashMap *macro_table, char *macro_name, char *line, int *error_found,
-                               int line_count, char *input_file_name, MacroContent macro_content) {
-    /* a potential label of the line */
-    char *label;
+static int check_and_handle_macro_end(Requirements *requirements, StringView macro_name, LexedLine *lexed,
+                                      int *error_found, int line_count, char *input_file_name, int first_index,
+                                      int definition_line) {
     /* the first field of the line which is checked to be a macro end declaration */
-    char *first_field;
-    /* the part of the line after the first field */
-    char *rest;
-    find_label(&line, &label);
-    first_field = find_token(line, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops. returns 1 in order to stop looking
-     * for the end of the macro since it might never be found */
-    if (first_field == NULL) {
-        free(label);
-        *error_found = 1;
-        return 1;
-    }
+    char first_field[MAX_LINE_LENGTH + 1];
+    /* the copy of the macro's name that is inserted to the macro table */
+    char *table_name;
+    /* the content that is inserted to the macro table */
+    MacroContent table_content;
+    view_copy(lexed->field, first_field);
     /* checks if the macro end keyword has been found */
-    if (!equal(first_field, MACRO_END)) {
-        free(first_field);
-        free(label);
-        return 0;
-    }
+    if (!equal(first_field, MACRO_END)) return 0;
     /* checks if the macro end includes a label, reports an error if yes */
-    if (label != NULL) {
-        printf("Input error: Line %d in file %s includes a label before macro end declaration\n",
-               line_count, input_file_name);
+    if (lexed->has_label) {
+        console_printf("Input error: Line %d in file %s includes a label before macro end declaration\n",
+                       line_count, input_file_name);
         *error_found = 1;
     }
     /* makes sure there are no extra characters after the macro end keyword */
-    if (!is_line_blank(rest)) {
-        printf("Input error: Line %d in file %s includes extra characters after macro end declaration\n",
-               line_count, input_file_name);
+    if (!is_line_blank(lexed->rest)) {
+        console_printf("Input error: Line %d in file %s includes extra characters after macro end declaration\n",
+                       line_count, input_file_name);
+        *error_found = 1;
+    }
+    table_name = view_duplicate(macro_name, requirements->arena);
+    /* if a memory allocation failure has occurred, updates the error flag and stops */
+    if (table_name == NULL) {
         *error_found = 1;
+        return 1;
     }
+    table_content.first_index = first_index;
+    table_content.line_count = requirements->macro_line_count - first_index;
+    table_content.definition_line = definition_line;
     /* adds the macro whose definition just ended to the macro table */
-    map_add_macro(macro_table, macro_name, macro_content);
-    free(first_field);
-    free(label);
+    map_add_macro(requirements->macro_table, table_name, table_content);
+    add_macro_first_char(requirements, table_name[0]);
     return 1;
 }
     
 
 /**
  * Reads a macro definition and inserts it to the macro table.
- * Does so by reading the lines after the definition title one by one and updating the macro's content accordingly
- * until the macro's end is found, and then inserting the macro to the macro table.
+ * Does so by reading the lines after the definition title one by one and adding them to the lines of the macros'
+ * contents until the macro's end is found, and then inserting the macro to the macro table. Each line is kept as its
+ * position in the input file, which stays in the memory until the pre-assembly is over, and its parsed line, so it is
+ * neither copied nor lexed again when the macro is used.
  * Assumes that the definition's first line has already been read.
  * 
- * @param macro_table     a pointer to the macro table
- * @param macro_name      the name of the macro whose definition is being read
+ * @param requirements    a pointer to the requirements of the file
+ * @param macro_name      a view of the name of the macro whose definition is being read, which should stay valid
+ *                        until the definition ends
  * @param input_file_name the name of the input file (used for error reporting)
  * @param input_file      a pointer to the input file
  * @param line_count      a pointer to a variable representing the number of the line being checked in the 
  *                        input file (used for error reporting)
  * @param error_found a pointer to an integer value that should hold whether an error has occurred
  */
-static void handle_macro_definition(HashMap *macro_table, char *macro_name, char *input_file_name,
-                             FILE *input_file, int *line_count, int *error_found) {
+static void handle_macro_definition(Requirements *requirements, StringView macro_name, char *input_file_name,
+                                    SourceFile *input_file, int *line_count, int *error_found) {
     /* the line being read */
     char line[MAX_LINE_LENGTH + 1];
-    /* the macro's content */
-    MacroContent macro_content = (MacroContent) calloc(1, 1);
-    /* if an allocation failure has occurred, updates the handler and stops trying to read the macro */
-    if (macro_content == NULL) {
-        fprintf(stderr, "Memory Error: Memory allocation failure when copying macro content\n");
-        set_alloc_failure();
-        return;
-    }
+    LexedLine lexed;
+    /* the line of the macro's content being read */
+    MacroLine macro_line;
+    /* the index of the content's first line in the lines of the macros' contents */
+    int first_index = requirements->macro_line_count;
+    /* the number of the line in which the definition starts */
+    int definition_line = *line_count;
+    memset(&macro_line, 0, sizeof(macro_line));
+    macro_line.state = UNENCODED_MACRO_LINE;
 
     /* reads the lines from the input one by one until a macro end is found */
     (*line_count)++;
-    if (read_line(input_file, input_file_name, *line_count, line)) *error_found = 1;
+    macro_line.offset = input_file->position;
+    if (source_read_line(input_file, input_file_name, *line_count, line)) *error_found = 1;
     while (1) {
+        lex_line(line, &lexed);
         /* if a macro end is found, inserts it to the macro table and quits reading the definition */
-        if (check_and_handle_macro_end(macro_table, macro_name, line, error_found, *line_count,
-                                       input_file_name, macro_content)) {
+        if (check_and_handle_macro_end(requirements, macro_name, &lexed, error_found, *line_count, input_file_name,
+                                       first_index, definition_line)) {
             break;
         }
-        /* if a macro end is not found, updates the macro's content */
-        else {
-            /* reallocates the macro content to a new string that has enough spaces for the next line */
-            MacroContent new_macro_content = 
-                    (MacroContent)realloc(macro_content, strlen(macro_content) + strlen(line) + 2);
-            /* if an allocation failure has occurred, updates the handler and stops trying to read the macro */
-            if (new_macro_content == NULL) {
-                fprintf(stderr, "Memory Error: Memory allocation failure when copying macro content\n");
-                free(macro_content);
-                set_alloc_failure();
-                return;
-            }
-            macro_content = new_macro_content;
-            /* adds the next line (with a line break) to the macro's content */
-            strcat(macro_content, line);
-            strcat(macro_content, "\n");
-        }
+        /* if a macro end is not found, adds the line to the macro's content - its length as it was read (so a line
+         * that is too long is cut in the same place) and its parsed line */
+        macro_line.length = strlen(line);
+        macro_line.parsed = parse_line(line, &lexed, *line_count);
+        /* if an allocation failure has occurred, the handler is updated, so stops trying to read the macro */
+        if (add_macro_line(requirements, macro_line)) break;
         /* reads the next line */
         (*line_count)++;
-        if (read_line(input_file, input_file_name, *line_count, line)) *error_found = 1;
+        macro_line.offset = input_file->position;
+        if (source_read_line(input_file, input_file_name, *line_count, line)) *error_found = 1;
     }
 }
 
@@ -219,9 +361,8 @@ static void handle_macro_definition(HashMap *macro_table, char *macro_name, char
  * Does so by checking if the first field of the line is the macro definition keyword, and that it has no label. If it
  * is, sees the second field as the macro name, and handles the macro definition using handle_macro_definition.
  * 
- * @param macro_table     a pointer to the macro table
- * @param line            the current line being analyzed (excluding a potential label)
- * @param label           the line's label (or null if there isn't one)
+ * @param requirements    a pointer to the requirements of the file
+ * @param lexed           a pointer to the current line being analyzed, after it has been lexed
  * @param input_file_name the name of the input file (used for error reporting)
  * @param input_file      a pointer to the input file
  * @param line_count      a pointer to a variable representing the number of the line being checked in the 
@@ -229,160 +370,472 @@ static void handle_macro_definition(HashMap *macro_table, char *macro_name, char
  * @param error_found     a pointer to an integer value that should hold whether an error has occurred
  * @return 1 if a macro definition was found, 0 otherwise
  */
-static int check_and_handle_macro_definition(HashMap *macro_table, char *line, char *label, char *input_file_name,
-                                      FILE *input_file, int *line_count, int *error_found) {
+static int check_and_handle_macro_definition(Requirements *requirements, LexedLine *lexed, char *input_file_name,
+                                             SourceFile *input_file, int *line_count, int *error_found) {
     /* the first field of the line, which is checked to be a macro definition */
-    char *first_field;
+    char first_field[MAX_LINE_LENGTH + 1];
+    /* a view of the name of the macro potentially being defined (inside the line) */
+    StringView macro_name_view;
     /* the name of the macro potentially being defined */
-    char *macro_name;
+    char macro_name[MAX_LINE_LENGTH + 1];
     /* the part of the line after the macro name */
     char *rest;
-    first_field = find_token(line, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (first_field == NULL) {
-        *error_found = 1;
-        return 0;
-    }
-    if (!equal(first_field, MACRO_DEFINITION)) {
-        free(first_field);
-        return 0;
-    }
-    macro_name = find_token(rest, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (macro_name == NULL) {
-        *error_found = 1;
-        free(first_field);
-        free(label);
-        return 1;
-    }
+    view_copy(lexed->field, first_field);
+    if (!equal(first_field, MACRO_DEFINITION)) return 0;
+    macro_name_view = next_token(lexed->rest, BLANKS, &rest);
+    view_copy(macro_name_view, macro_name);
     /* if a macro definition keyword exists and has a label, reports an error */
-    if (label != NULL) {
-        printf("Input Error: Label used before macro definition in line %d of file %s\n", *line_count,
-               input_file_name);
+    if (lexed->has_label) {
+        console_printf("Input Error: Label used before macro definition in line %d of file %s\n", *line_count,
+                       input_file_name);
         *error_found = 1;
     }
-    free(label);
     /* makes sure no macro with the same name has already been defined */
-    if (map_contains(macro_table, macro_name)) {
-        printf("Input error: Macro defined in line %d in file %s has already been defined\n", *line_count,
-               input_file_name);
+    if (map_contains(requirements->macro_table, macro_name)) {
+        console_printf("Input error: Macro defined in line %d in file %s has already been defined\n", *line_count,
+                       input_file_name);
         *error_found = 1;
     }
     /* makes sure the macro name is not empty */
     if (is_line_blank(macro_name)) {
-        printf("Input error: Macro defined in line %d in file %s has no name\n", *line_count, input_file_name);
+        console_printf("Input error: Macro defined in line %d in file %s has no name\n", *line_count, input_file_name);
         *error_found = 1;
-        free(first_field);
         return 1;
     }
     /* makes sure the macro name is legal */
     if (!legal_macro_name(macro_name)) {
-        printf("Input error: Macro defined in line %d in file %s has an illegal name\n",
-               *line_count, input_file_name);
+        console_printf("Input error: Macro defined in line %d in file %s has an illegal name\n",
+                       *line_count, input_file_name);
         *error_found = 1;
     }
     /* makes sure there are no extra characters after the macro name */
     if (!is_line_blank(rest)) {
-        printf("Input error: Line %d in file %s includes extra characters after macro name\n",
-               *line_count, input_file_name);
+        console_printf("Input error: Line %d in file %s includes extra characters after macro name\n",
+                       *line_count, input_file_name);
+        *error_found = 1;
+    }
+    handle_macro_definition(requirements, macro_name_view, input_file_name, input_file, line_count, error_found);
+    return 1;
+}
+
+/**
+ * Writes the parsed source of a file into a new .am file with the same name, with a single write.
+ *
+ * @param file_name     the name of the input file without the .as extension
+ * @param parsed_source a pointer to the parsed source
+ * @param arena         a pointer to the arena that the name of the file should be allocated from
+ * @return 1 if the file could not be created, 0 otherwise
+ */
+static int write_parsed_file(char file_name[], TextBuffer *parsed_source, Arena *arena) {
+    return save_parsed_file(file_name, parsed_source->text, parsed_source->length, arena);
+}
+
+/**
+ * Checks if a macro definition starts in the given line, and if it does, skips the lines of the definition.
+ * Should only be used once every macro of the file has been inserted to the macro table by scan_macro_definitions
+ * without errors, so the definition is known to end right after the macro's content.
+ * 
+ * @param requirements    a pointer to the requirements of the file
+ * @param lexed           a pointer to the current line being analyzed, after it has been lexed
+ * @param input_file_name the name of the input file (used for error reporting)
+ * @param input_file      a pointer to the input file
+ * @param line_count      a pointer to a variable representing the number of the line being checked in the
+ *                        input file (used for error reporting)
+ * @param error_found     a pointer to an integer value that should hold whether an error has occurred
+ * @return 1 if a macro definition was found, 0 otherwise
+ */
+static int skip_macro_definition(Requirements *requirements, LexedLine *lexed, char *input_file_name,
+                                 SourceFile *input_file, int *line_count, int *error_found) {
+    /* the first field of the line, which is checked to be a macro definition */
+    char first_field[MAX_LINE_LENGTH + 1];
+    /* the name of the macro being defined */
+    char macro_name[MAX_LINE_LENGTH + 1];
+    /* the line being skipped */
+    char line[MAX_LINE_LENGTH + 1];
+    char *rest;
+    int skipped_lines;
+    int i;
+    view_copy(lexed->field, first_field);
+    if (!equal(first_field, MACRO_DEFINITION)) return 0;
+    view_copy(next_token(lexed->rest, BLANKS, &rest), macro_name);
+    /* every definition was inserted to the macro table when it was scanned, unless the scan was wrong */
+    if (!map_contains(requirements->macro_table, macro_name)) {
+        *error_found = 1;
+        return 1;
+    }
+    /* skips the lines of the macro's content and the line of the macro end */
+    skipped_lines = map_get_macro(requirements->macro_table, macro_name)->line_count + 1;
+    for (i = 0; i < skipped_lines; i++) {
+        (*line_count)++;
+        source_read_line(input_file, input_file_name, *line_count, line);
+    }
+    return 1;
+}
+
+/**
+ * Parses a range of the lines of an input file into the parsed source buffer of the file's requirements.
+ * Does so by reading the lines one by one. For each line, if a macro usage is detected (the first field is a macro
+ * that was defined before the line) writes its content into the parsed source. Else, if a macro definition keyword is
+ * found as the first field of the line, reads the definition and inserts the macro to the macro table - or, if the
+ * macro table was already built by scan_macro_definitions, skips the definition. If neither of these criteria is met,
+ * copies the line to the parsed source.
+ * 
+ * @param input_file      a pointer to the input file, whose position should be the start of the first line
+ * @param input_file_name the name of the input file (used for error reporting)
+ * @param first_line      the number of the first line in the input file
+ * @param end_line        the number of the line after the last one, or INT_MAX to read up to the end of the file
+ * @param table_built     whether the macro table already holds every macro of the file
+ * @param requirements    a pointer to the requirements of the file
+ * @return 1 if an error was found, 0 otherwise
+ */
+static int pre_assemble_lines(SourceFile *input_file, char *input_file_name, int first_line, int end_line,
+                              int table_built, Requirements *requirements) {
+    /* the number of the line being read */
+    int line_count = first_line - 1;
+    /* the line being read */
+    char line_read[MAX_LINE_LENGTH + 1];
+    /* the line being read, after it has been lexed */
+    LexedLine lexed;
+    /* whether an error has occurred */
+    int error_found = 0;
+    while (!source_ended(input_file) && line_count + 1 < end_line) {
+        line_count++;
+        /* if an error has occurred while reading the line, the error_found flag is set to 1 */
+        if (source_read_line(input_file, input_file_name, line_count, line_read)) error_found = 1;
+        /* lexes the line once - its label and first field are used to detect macros, and the rest of it is kept as
+         * its parsed line */
+        lex_line(line_read, &lexed);
+        /* if a macro usage is detected, its content are written to the parsed source, and the loop moves to the
+         * next line */
+        if (check_and_handle_macro_usage(requirements, input_file, &lexed, line_count, input_file_name, &error_found)) {
+            continue;
+        }
+        /* if a macro definition is detected, it is inserted to the macro table (or skipped, if it already has been),
+         * and the loop moves to the line after the macro's end */
+        if (table_built ? skip_macro_definition(requirements, &lexed, input_file_name, input_file, &line_count,
+                                                &error_found)
+                        : check_and_handle_macro_definition(requirements, &lexed, input_file_name, input_file,
+                                                           &line_count, &error_found)) {
+            continue;
+        }
+        /* if no special case is detected and no error has occurred so far, copies the line to the parsed source
+         * along with its parsed line */
+        if (!error_found) append_line(requirements, line_read, &lexed, line_count);
+    }
+    return error_found;
+}
+
+/**
+ * Adds a split point to the end of a list of split points.
+ * If there is no more space for the split point, doubles the capacity of the list.
+ * 
+ * @param split_points      a pointer to the list
+ * @param split_point_count a pointer to the number of split points in the list
+ * @param capacity          a pointer to the number of split points that the allocated memory can hold
+ * @param offset            the index in the input file in which the line starts
+ * @param line              the number of the line in the input file
+ * @return 0 if the split point was added successfully, 1 if an allocation failure has occurred
+ */
+static int add_split_point(SplitPoint **split_points, int *split_point_count, int *capacity, long offset, int line) {
+    if (*split_point_count == *capacity) {
+        int new_capacity = *capacity == 0 ? INITIAL_SPLIT_POINT_CAPACITY : 2 * *capacity;
+        SplitPoint *new_points = realloc(*split_points, new_capacity * sizeof(SplitPoint));
+        /* if an allocation failure occurred, updates the handler and leaves the list unchanged */
+        if (new_points == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when adding split point\n");
+            set_alloc_failure();
+            return 1;
+        }
+        *split_points = new_points;
+        *capacity = new_capacity;
+    }
+    (*split_points)[*split_point_count].offset = offset;
+    (*split_points)[*split_point_count].line = line;
+    (*split_point_count)++;
+    return 0;
+}
+
+/**
+ * Builds the macro table of an input file by scanning its macro definitions alone, and finds the lines that the file
+ * may be split at - the first line that is not a part of a macro definition out of about every MIN_CHUNK_LINES lines.
+ * Does so by reading the lines one by one, and only lexing the ones that include the macro definition keyword. Every
+ * definition found is read and inserted to the macro table just like it is by pre_assemble_lines, which can't tell a
+ * definition apart from a macro usage in any other way, since no macro can be named after the keyword.
+ * Leaves the position of the input file at its end.
+ * 
+ * @param input_file        a pointer to the input file, whose position should be its start
+ * @param input_file_name   the name of the input file (used for error reporting)
+ * @param split_points      a pointer to an empty list that the split points should be added to, which should be
+ *                          freed by the caller
+ * @param split_point_count a pointer to the number of split points in the list
+ * @param line_total        a pointer to a variable that should hold the number of lines in the input file
+ * @param requirements      a pointer to the requirements of the file
+ * @return 1 if an error was found, 0 otherwise
+ */
+static int scan_macro_definitions(SourceFile *input_file, char *input_file_name, SplitPoint **split_points,
+                                  int *split_point_count, int *line_total, Requirements *requirements) {
+    char line_read[MAX_LINE_LENGTH + 1];
+    LexedLine lexed;
+    int line_count = 0;
+    /* the number of split points that the allocated memory can hold */
+    int capacity = 0;
+    /* the number of the first line that may be the next split point */
+    int next_split_line = 1;
+    long offset;
+    int error_found = 0;
+    while (!source_ended(input_file)) {
+        offset = input_file->position;
+        line_count++;
+        if (line_count >= next_split_line) {
+            if (add_split_point(split_points, split_point_count, &capacity, offset, line_count)) return 1;
+            next_split_line = line_count + MIN_CHUNK_LINES;
+        }
+        if (source_read_line(input_file, input_file_name, line_count, line_read)) error_found = 1;
+        /* a line without the keyword can't start a macro definition, so it is not lexed */
+        if (strstr(line_read, MACRO_DEFINITION) == NULL) continue;
+        lex_line(line_read, &lexed);
+        check_and_handle_macro_definition(requirements, &lexed, input_file_name, input_file, &line_count,
+                                          &error_found);
+    }
+    *line_total = line_count;
+    return error_found;
+}
+
+/**
+ * Empties the macro table of a file, along with the lines of the macros' contents and the bitmap of the first
+ * characters of the macros' names.
+ * 
+ * @param requirements a pointer to the requirements of the file
+ * @return 1 if an allocation failure has occurred, 0 otherwise
+ */
+static int reset_macro_table(Requirements *requirements) {
+    free_map(requirements->macro_table);
+    requirements->macro_table = create_map(MACRO);
+    requirements->macro_line_count = 0;
+    memset(requirements->macro_first_chars, 0, CHARACTER_BITMAP_SIZE);
+    return requirements->macro_table == NULL;
+}
+
+/**
+ * Handles a chunk on its own thread (see run_chunks): parses the chunk's lines into the chunk's parsed source, reading
+ * the input file from the chunk's own position.
+ * 
+ * @param arg a pointer to the chunk
+ * @return 1 if an error was found in the chunk's lines, 0 otherwise
+ */
+static int pre_assemble_chunk(void *arg) {
+    PreAssemblyChunk *chunk = (PreAssemblyChunk *) arg;
+    SourceFile input_file = *chunk->input_file;
+    input_file.position = chunk->first_offset;
+    return pre_assemble_lines(&input_file, chunk->input_file_name, chunk->first_line, chunk->end_line, 1,
+                              &chunk->requirements);
+}
+
+/**
+ * Appends the parsed source of a chunk to the parsed source of the file, along with the chunk's parsed lines, whose
+ * starts are moved by the length of the parsed source before the chunk.
+ * 
+ * @param chunk        a pointer to the chunk
+ * @param requirements a pointer to the requirements of the file
+ */
+static void append_chunk(PreAssemblyChunk *chunk, Requirements *requirements) {
+    TextBuffer *chunk_source = chunk->requirements.parsed_source;
+    int start = requirements->parsed_source->length;
+    ParsedLine parsed_line;
+    int i;
+    text_buffer_append_characters(requirements->parsed_source, chunk_source->text, chunk_source->length);
+    for (i = 0; i < chunk->requirements.parsed_line_count; i++) {
+        parsed_line = chunk->requirements.parsed_lines[i];
+        parsed_line.start += start;
+        /* if an allocation failure has occurred, the handler is updated, so stops appending */
+        if (add_parsed_line(requirements, parsed_line)) return;
+    }
+}
+
+/**
+ * Parses the lines of an input file in chunks that are handled at the same time, each on its own thread and into its
+ * own parsed source and parsed lines, once the file's macro table has been built by scan_macro_definitions. Every
+ * chunk starts from a split point, and the chunks are split as evenly as possible. Once all of the chunks are done,
+ * they are appended to the file's parsed source in order, and their messages are printed in order.
+ * 
+ * @param split_points      the list of the split points of the file
+ * @param split_point_count the number of split points
+ * @param chunk_count       the number of chunks, which should be at most the number of split points
+ * @param input_file        a pointer to the input file
+ * @param input_file_name   the name of the input file (used for error reporting)
+ * @param error_found       a pointer to an integer value that should hold whether an error has occurred
+ * @param requirements      a pointer to the requirements of the file
+ * @return 1 if the chunks were handled, 0 if they could not be (and the file's parsed source was left unchanged)
+ */
+static int expand_chunks(SplitPoint *split_points, int split_point_count, int chunk_count, SourceFile *input_file,
+                         char *input_file_name, int *error_found, Requirements *requirements) {
+    PreAssemblyChunk *chunks = calloc(chunk_count, sizeof(PreAssemblyChunk));
+    /* the number of chunks that were prepared */
+    int prepared;
+    /* whether every chunk was handled */
+    int handled = 0;
+    int i;
+    if (chunks == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when splitting file into chunks\n");
+        set_alloc_failure();
+        return 0;
+    }
+    for (prepared = 0; prepared < chunk_count; prepared++) {
+        PreAssemblyChunk *chunk = &chunks[prepared];
+        SplitPoint *first = &split_points[(long) split_point_count * prepared / chunk_count];
+        chunk->first_offset = first->offset;
+        chunk->first_line = first->line;
+        chunk->end_line = prepared == chunk_count - 1
+                          ? INT_MAX : split_points[(long) split_point_count * (prepared + 1) / chunk_count].line;
+        chunk->input_file_name = input_file_name;
+        chunk->input_file = input_file;
+        chunk->requirements = *requirements;
+        chunk->requirements.parsed_source = create_text_buffer();
+        chunk->requirements.parsed_lines = NULL;
+        chunk->requirements.parsed_line_count = 0;
+        chunk->requirements.parsed_line_capacity = 0;
+        chunk->base.output = tmpfile();
+        if (chunk->requirements.parsed_source == NULL || chunk->base.output == NULL) break;
+    }
+    if (prepared == chunk_count) {
+        handled = run_chunks(chunks, chunk_count, sizeof(PreAssemblyChunk), pre_assemble_chunk);
+    }
+    if (handled) {
+        for (i = 0; i < chunk_count; i++) {
+            if (chunks[i].base.error_found) *error_found = 1;
+        }
+        /* the parsed source is only needed if no error was found */
+        for (i = 0; i < chunk_count && !*error_found && !is_alloc_failure(); i++) {
+            append_chunk(&chunks[i], requirements);
+        }
+    }
+    close_chunks(chunks, chunk_count, sizeof(PreAssemblyChunk), handled);
+    for (i = 0; i < chunk_count; i++) {
+        if (chunks[i].requirements.parsed_source != NULL) free_text_buffer(chunks[i].requirements.parsed_source);
+        free(chunks[i].requirements.parsed_lines);
+    }
+    free(chunks);
+    return handled;
+}
+
+/**
+ * Parses the lines of an input file by first building its macro table with a scan over its macro definitions alone,
+ * and then parsing the rest of the file in chunks that are handled at the same time (see expand_chunks). Once the
+ * table is built, the line of every macro usage is known to come after the macro's definition, and the definitions
+ * can be skipped, so each chunk is parsed just like it would be by a single run over the file. The messages of the
+ * chunks are printed in order, so they are the same as the messages of a single run.
+ * The messages of the scan, however, are only errors in the macro definitions and in the lengths of the lines, which a
+ * single run reports in order with the errors in the macro usages. So if the scan finds any error, its messages are
+ * dropped and the macro table is emptied, so the file can be handled by a single run instead.
+ * A file is only split if every chunk would have at least MIN_CHUNK_LINES lines. Otherwise, once the table is built,
+ * the file is parsed as a single chunk, on the calling thread.
+ * 
+ * @param input_file      a pointer to the input file, whose position should be its start
+ * @param input_file_name the name of the input file (used for error reporting)
+ * @param error_found     a pointer to an integer value that should hold whether an error has occurred
+ * @param requirements    a pointer to the requirements of the file
+ * @return 1 if the file was handled, 0 if it should be handled by a single run (and its position was moved back to
+ *         its start)
+ */
+static int pre_assemble_in_chunks(SourceFile *input_file, char *input_file_name, int *error_found,
+                                  Requirements *requirements) {
+    SplitPoint *split_points = NULL;
+    int split_point_count = 0;
+    int line_total = 0;
+    int chunk_count;
+    int scan_error;
+    /* the stream that the calling thread's messages are written to */
+    FILE *console_stream = console();
+    /* the stream that the scan's messages are buffered in */
+    FILE *scan_output = tmpfile();
+    if (scan_output == NULL) return 0;
+    bind_console(scan_output);
+    scan_error = scan_macro_definitions(input_file, input_file_name, &split_points, &split_point_count, &line_total,
+                                        requirements);
+    bind_console(console_stream);
+    fclose(scan_output);
+    /* if a memory allocation failure has occurred, the file can't be handled by a single run either */
+    if (is_alloc_failure()) {
+        free(split_points);
         *error_found = 1;
+        return 1;
+    }
+    if (scan_error) {
+        free(split_points);
+        input_file->position = 0;
+        /* if a memory allocation failure has occurred while emptying the table, stops */
+        if (reset_macro_table(requirements)) {
+            *error_found = 1;
+            return 1;
+        }
+        return 0;
     }
-    handle_macro_definition(macro_table, macro_name, input_file_name, input_file, line_count, error_found);
-    free(first_field);
+    chunk_count = line_total / MIN_CHUNK_LINES;
+    if (chunk_count > requirements->thread_count) chunk_count = requirements->thread_count;
+    if (chunk_count > split_point_count) chunk_count = split_point_count;
+    if (chunk_count < 2 || !expand_chunks(split_points, split_point_count, chunk_count, input_file, input_file_name,
+                                          error_found, requirements)) {
+        input_file->position = 0;
+        if (!is_alloc_failure()) *error_found = pre_assemble_lines(input_file, input_file_name, 1, INT_MAX, 1,
+                                                                   requirements);
+    }
+    free(split_points);
     return 1;
 }
 
 /**
- * Reads an input file and parses all of its macros. Creates a new parsed file with the same name and a .am extension.
- * If a .am file with the same name already exists, deletes it and creates a new file.
+ * Reads an input file and parses all of its macros into the parsed source buffer of the file's requirements. If asked
+ * to, also creates a new parsed file with the same name and a .am extension which holds the parsed source.
  * If any error is found during the pre-assembling, will not create a parsed file, but will continue parsing the input
  * file and reporting errors, as long as the error does not prevent that.
  * Does so by reading the input file line by line. For each line, if a macro usage is detected (the first field
- * appears in the macro table) writes its content into the parsed file. Else, if a macro definition keyword is found as
- * the first field of the line, sees the second field of the line as the macro's name, and updates the macro's content
- * line by line until a macro end keyword is found, at which point the macro table is updated with the new macro.
- * If neither of these criteria is met, copies the file from the input file to the parsed file.
+ * appears in the macro table) writes its content into the parsed source. Else, if a macro definition keyword is found
+ * as the first field of the line, sees the second field of the line as the macro's name, and updates the macro's
+ * content line by line until a macro end keyword is found, at which point the macro table is updated with the new
+ * macro. If neither of these criteria is met, copies the line from the input file to the parsed source.
  * Assumes that the definition of every macro comes before its usage, that there are no nested macro definitions, that
  * a macro cannot be defined if a macro with the same name has already been defined, and that a macro definition and
  * ending cannot have labels.
  * Also, if a macro with a colon at the end is used, it is assumed to be a label (based on a forum answer, I can handle
  * it as I see fit as long as I provide adequate documentation).
  * 
- * @param file_name    the name of the input file without the .as extension
- * @param requirements a pointer to the requirements of the file
+ * @param file_name        the name of the input file without the .as extension
+ * @param input_file       a pointer to the input file if it was already opened, which is closed once it is read, or
+ *                         NULL if it should be opened based on its name
+ * @param requirements     a pointer to the requirements of the file
+ * @param emit_parsed_file whether the parsed source should also be written into a .am file
  * @return 1 if an error was found, 0 if the file was parsed successfully
  */
-int pre_assemble(char file_name[], Requirements *requirements) {
-    /* a pointer to the input .as file */
-    FILE *input_file;
-    /* a pointer to the parsed .am file */
-    FILE *parsed_file;
+int pre_assemble(char file_name[], SourceFile *input_file, Requirements *requirements, int emit_parsed_file) {
     /* the name of the input file (including the extension) */
     char *input_file_name;
-    /* the name of the parsed file (including the extension) */
-    char *parsed_file_name;
-    /* the number of the line being read */
-    int line_count;
-    /* the line being read */
-    char line_read[MAX_LINE_LENGTH + 1];
-    /* a pointer version of line_read, that can have a char-pointer-pointer assigned to it, will later change to not
-     * include a potential label */
-    char *line;
-    /* the line's label, or null if there isn't one */
-    char *label;
     /* whether an error has occurred */
     int error_found = 0;
 
     /* gets the name of the input file and a pointer to the file, if the file can't be read
      * the pre-assembly process is stopped for the file */
-    input_file_name = get_input_file_name(file_name);
+    input_file_name = get_input_file_name(file_name, requirements->arena);
     /* if the input file name is null */
-    if (!input_file_name) return 1;
-    input_file = get_input_file(file_name);
-    /* if the input file is null */
-    if (!input_file) {
-        free(input_file_name);
+    if (!input_file_name) {
+        if (input_file) close_source_file(input_file);
         return 1;
     }
+    /* an input file that was not opened yet, or that could not be opened, is opened now (which reports the error) */
+    if (!input_file) input_file = get_input_file(file_name, requirements->arena);
+    /* if the input file is null */
+    if (!input_file) return 1;
 
-    /* gets the name of the parsed file and a pointer to the file, if either is null then an error is reported and
-     * the error_found flag is set to 1 */
-    parsed_file_name = get_parsed_file_name(file_name);
-    if (parsed_file_name == NULL) error_found = 1;
-    parsed_file = get_parsed_file_append(file_name);
-    if (!parsed_file) error_found = 1;
-
-    /* reads the input file line by line, and checks for macro usage and definition */
-    line_count = 0;
-    while (!feof(input_file)) {
-        line_count++;
-        /* if an error has occurred while reading the line, the error_found flag is set to 1 */
-        if (read_line(input_file, input_file_name, line_count, line_read)) error_found = 1;
-        line = line_read;
-        /* changes line to not include a label (if there is one), and sets label to be either the line's label if one
-         * exists, or null otherwise */
-        find_label(&line, &label);
-        /* if a macro usage is detected, its content are written to the parsed file, and the loop moves to the
-         * next line */
-        if (check_and_handle_macro_usage(requirements->macro_table, line, label, parsed_file,
-                                         line_count, input_file_name, &error_found)) {
-            continue;
-        }
-        /* if a macro definition is detected, it is inserted to the macro table, and the loop moves to the
-         * line after the macro's end */
-        if (check_and_handle_macro_definition(requirements->macro_table, line, label, input_file_name,
-                                              input_file, &line_count, &error_found)) {
-            continue;
-        }
-        /* if no special case is detected and no error has occurred so far, copies the line to the parsed file */
-        if (!error_found) fprintf(parsed_file, "%s\n", line_read);
-        free(label);
+    /* if the file may be handled by several threads, parses it in chunks - unless an error is found in its macro
+     * definitions, which is reported by a single run over the file */
+    if (requirements->thread_count < 2 ||
+        !pre_assemble_in_chunks(input_file, input_file_name, &error_found, requirements)) {
+        /* reads the input file line by line, and checks for macro usage and definition */
+        error_found = pre_assemble_lines(input_file, input_file_name, 1, INT_MAX, 0, requirements);
+    }
+    close_source_file(input_file);
+    /* the parsed file is only written if it was asked for and the parsing is known to be correct */
+    if (emit_parsed_file && !error_found && !is_alloc_failure()) {
+        error_found = write_parsed_file(file_name, requirements->parsed_source, requirements->arena);
     }
-    /* closes the files */
-    fclose(input_file);
-    fclose(parsed_file);
-    /* if an error has been found, removes the parsed file since the parsing cannot be correct */
-    if (error_found) remove(parsed_file_name);
-    free_all(2, input_file_name, parsed_file_name);
     return error_found;
 }
@@ -5,16 +5,37 @@
 #include "../headers/requirements.h"
 #include "stdlib.h"
 #include "stdio.h"
+#include "string.h"
 #include "../headers/alloc_failure_handler.h"
+#include "../headers/console.h"
+
+#define INITIAL_FIXUP_CAPACITY 64
+#define INITIAL_PARSED_LINE_CAPACITY 256
+#define INITIAL_MACRO_LINE_CAPACITY 64
+#define INITIAL_INDEX_CAPACITY 16
+#define INITIAL_APPEARANCES_CAPACITY 8
+
+/**
+ * Initializes an empty symbol index. No memory is allocated until the first symbol is added.
+ * 
+ * @param index a pointer to the index to be initialized
+ */
+static void init_symbol_index(SymbolIndex *index) {
+    index->handles = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->max_name_length = 0;
+}
 
 /**
  * Creates a new instance of Requirements to be used for the assembly of one file.
- * Does so by allocating memory for it and for the arrays it includes, creating the symbol table and initializing the
- * instruction and data counters.
+ * Does so by allocating memory for it and for the arrays it includes, creating the symbol table, the encoding cache
+ * and the buffer of the parsed source, and initializing the instruction and data counters.
  * 
+ * @param arena a pointer to an empty arena that the file's objects should be allocated from
  * @return a pointer to new Requirements, or NULL if memory for the Requirements structure could not be allocated
  */
-Requirements *create_requirements() {
+Requirements *create_requirements(Arena *arena) {
     Requirements *requirements = malloc(sizeof(Requirements));
     /* if an allocation failure occurred, updates the handler and returns null */
     if (requirements == NULL) {
@@ -22,36 +43,139 @@ Requirements *create_requirements() {
         set_alloc_failure();
         return NULL;
     }
+    requirements->arena = arena;
     requirements->macro_table = create_map(MACRO);
+    requirements->macro_lines = NULL;
+    requirements->macro_line_count = 0;
+    requirements->macro_line_capacity = 0;
+    memset(requirements->macro_first_chars, 0, CHARACTER_BITMAP_SIZE);
+    requirements->parsed_source = create_text_buffer();
+    requirements->parsed_lines = NULL;
+    requirements->parsed_line_count = 0;
+    requirements->parsed_line_capacity = 0;
     requirements->symbol_table = create_map(SYMBOL);
     requirements->data_array = calloc(MEMORY_SIZE, sizeof(short));
     /* if an allocation failure occurred, updates the handler */
     if (requirements->data_array == NULL) {
-        printf("Memory Error: Memory allocation failure when creating data array\n");
+        console_printf("Memory Error: Memory allocation failure when creating data array\n");
         set_alloc_failure();
     }
-    requirements->faulty_instructions = create_set();
+    init_symbol_index(&requirements->extern_symbols);
+    init_symbol_index(&requirements->entry_symbols);
+    requirements->fixups = NULL;
+    requirements->fixup_count = 0;
+    requirements->fixup_capacity = 0;
     requirements->instruction_array = calloc(MEMORY_SIZE, sizeof(short));
     /* if an allocation failure occurred, updates the handler */
     if (requirements->instruction_array == NULL) {
-        printf("Memory Error: Memory allocation failure when creating instruction array\n");
+        console_printf("Memory Error: Memory allocation failure when creating instruction array\n");
         set_alloc_failure();
     }
+    requirements->encoding_cache = create_encoding_cache(arena);
     requirements->ic = IC_START;
     requirements->dc = 0;
     requirements->extern_found = 0;
+    requirements->thread_count = 1;
     return requirements;
 }
 
 /**
- * Frees a pointer to an instance of Requirements and all of its members.
+ * Creates the requirements for a chunk of a file's parsed lines, which a pass handles separately from the rest of the
+ * file.
+ * Does so by pointing the chunk at the members of the file's requirements that are only read, copying the lines of
+ * the macros' contents (since the first pass records its encodings in them), and creating the rest of the members as
+ * in a new file. The chunk's counters start where a file's counters start, so its addresses are relative to its own
+ * start until they are rebased.
+ * 
+ * @param requirements a pointer to the requirements of the file
+ * @param arena        a pointer to an empty arena that the chunk's objects should be allocated from
+ * @return a pointer to the chunk's requirements, or NULL if memory for the Requirements structure could not be
+ *         allocated
+ */
+Requirements *create_chunk_requirements(Requirements *requirements, Arena *arena) {
+    Requirements *chunk = malloc(sizeof(Requirements));
+    /* if an allocation failure occurred, updates the handler and returns null */
+    if (chunk == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating requirements\n");
+        set_alloc_failure();
+        return NULL;
+    }
+    *chunk = *requirements;
+    chunk->arena = arena;
+    chunk->macro_lines = NULL;
+    chunk->macro_line_capacity = requirements->macro_line_count;
+    if (requirements->macro_line_count > 0) {
+        chunk->macro_lines = malloc(requirements->macro_line_count * sizeof(MacroLine));
+        /* if an allocation failure occurred, updates the handler */
+        if (chunk->macro_lines == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when copying macro lines\n");
+            set_alloc_failure();
+        }
+        else memcpy(chunk->macro_lines, requirements->macro_lines, requirements->macro_line_count * sizeof(MacroLine));
+    }
+    chunk->symbol_table = create_map(SYMBOL);
+    init_symbol_index(&chunk->extern_symbols);
+    init_symbol_index(&chunk->entry_symbols);
+    chunk->fixups = NULL;
+    chunk->fixup_count = 0;
+    chunk->fixup_capacity = 0;
+    chunk->data_array = calloc(MEMORY_SIZE, sizeof(short));
+    chunk->instruction_array = calloc(MEMORY_SIZE, sizeof(short));
+    /* if an allocation failure occurred, updates the handler */
+    if (chunk->data_array == NULL || chunk->instruction_array == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating memory image\n");
+        set_alloc_failure();
+    }
+    chunk->encoding_cache = create_encoding_cache(arena);
+    chunk->ic = IC_START;
+    chunk->dc = 0;
+    chunk->extern_found = 0;
+    chunk->thread_count = 1;
+    return chunk;
+}
+
+/**
+ * Frees the requirements of a chunk of a file, without freeing the members that it shares with the file's
+ * requirements. The chunk's arena is not reset, since the objects allocated from it may still be needed.
+ * 
+ * @param chunk a pointer to the chunk's requirements, which may be NULL
+ */
+void free_chunk_requirements(Requirements *chunk) {
+    if (chunk == NULL) return;
+    free(chunk->macro_lines);
+    free_map(chunk->symbol_table);
+    free(chunk->extern_symbols.handles);
+    free(chunk->entry_symbols.handles);
+    free(chunk->fixups);
+    free_encoding_cache(chunk->encoding_cache);
+    free(chunk->data_array);
+    free(chunk->instruction_array);
+    free(chunk);
+}
+
+/**
+ * Frees a pointer to an instance of Requirements and all of its members, and resets its arena so that everything
+ * allocated from it is released at once.
+ * The appearances of the external symbols are freed by going over the index of external symbols, since they are the
+ * only symbols that may have any.
  * 
  * @param requirements a pointer to the requirements to be freed
  */
 void free_requirements(Requirements *requirements) {
+    SymbolIndex *extern_symbols = &requirements->extern_symbols;
+    int i;
+    for (i = 0; i < extern_symbols->count; i++)
+        free(map_get_symbol_at(requirements->symbol_table, extern_symbols->handles[i])->appearances.addresses);
     free_map(requirements->macro_table);
+    free(requirements->macro_lines);
+    if (requirements->parsed_source != NULL) free_text_buffer(requirements->parsed_source);
+    free(requirements->parsed_lines);
     free_map(requirements->symbol_table);
-    free_set(requirements->faulty_instructions);
+    free(requirements->extern_symbols.handles);
+    free(requirements->entry_symbols.handles);
+    free(requirements->fixups);
+    free_encoding_cache(requirements->encoding_cache);
+    reset_arena(requirements->arena);
     free(requirements->data_array);
     free(requirements->instruction_array);
     free(requirements);
@@ -62,17 +186,17 @@ void free_requirements(Requirements *requirements) {
  * If the sum of the instruction and data counters is larger than the size of the memory, then there is no more
  * space for the new instruction in the memory image, so an error is thrown.
  * 
- * @param requirements     the requirements of the file
- * @param instruction      the word to be added, padded with a 0 on the left
- * @param line_count       the number of the line in the parsed file whose portion is being inserted to
- *                         the memory (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
+ * @param requirements    the requirements of the file
+ * @param instruction     the word to be added, padded with a 0 on the left
+ * @param line_count      the number of the line in the input file whose portion is being inserted to
+ *                        the memory (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
  * @return 0 if the insertion was successful, 1 otherwise
  */
-int memory_insert_instruction(Requirements *requirements, unsigned short instruction, int line_count, char *parsed_file_name) {
+int memory_insert_instruction(Requirements *requirements, unsigned short instruction, int line_count, char *input_file_name) {
     if (requirements->ic + requirements->dc >= MEMORY_SIZE) {
-        printf("Input Error: Not enough space in the memory image (Error occurred in line %d of file %s)\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: Not enough space in the memory image (Error occurred in line %d of file %s)\n",
+                       line_count, input_file_name);
         return 1;
     }
     requirements->instruction_array[requirements->ic++] = instruction;
@@ -84,19 +208,166 @@ int memory_insert_instruction(Requirements *requirements, unsigned short instruc
  * If the sum of the instruction and data counters is larger than the size of the memory, then there is no more
  * space for the new data in the memory image, so an error is thrown.
  * 
- * @param requirements     the requirements of the file
- * @param data             the word to be added, padded with a 0 on the left
- * @param line_count       the number of the line in the parsed file whose portion is being inserted to
- *                         the memory (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
+ * @param requirements    the requirements of the file
+ * @param data            the word to be added, padded with a 0 on the left
+ * @param line_count      the number of the line in the input file whose portion is being inserted to
+ *                        the memory (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
  * @return 0 if the insertion was successful, 1 otherwise
  */
-int memory_insert_data(Requirements *requirements, unsigned short data, int line_count, char *parsed_file_name) {
+int memory_insert_data(Requirements *requirements, unsigned short data, int line_count, char *input_file_name) {
     if (requirements->ic + requirements->dc >= MEMORY_SIZE) {
-        printf("Input Error: Not enough space in the memory image (Error occurred in line %d of file %s)\n",
-               line_count, parsed_file_name);
+        console_printf("Input Error: Not enough space in the memory image (Error occurred in line %d of file %s)\n",
+                       line_count, input_file_name);
         return 1;
     }
     requirements->data_array[requirements->dc++] = data;
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * Returns the address of a symbol in the file's memory image.
+ * Data symbols hold their offset in the data portion, which is placed right after the instructions, so the final
+ * instruction counter is added to their value. This way, finishing the first pass does not require going over the
+ * symbol table.
+ * Should only be used once the first pass is over.
+ * 
+ * @param requirements the requirements of the file
+ * @param symbol       the symbol whose address should be returned
+ * @return the address of the symbol
+ */
+int get_symbol_address(Requirements *requirements, SymbolContent symbol) {
+    return symbol.location == DATA ? symbol.value + requirements->ic : symbol.value;
+}
+
+/**
+ * Adds a symbol to the end of a symbol index, and updates the length of the longest name in the index.
+ * If there is no more space for the symbol, doubles the capacity of the index.
+ * 
+ * @param index  a pointer to the index that the symbol should be added to
+ * @param handle the handle of the symbol in the symbol table
+ * @param name   the name of the symbol
+ * @return 0 if the symbol was added successfully, 1 if an allocation failure has occurred
+ */
+int add_to_symbol_index(SymbolIndex *index, int handle, char *name) {
+    int name_length = strlen(name);
+    if (index->count == index->capacity) {
+        int new_capacity = index->capacity == 0 ? INITIAL_INDEX_CAPACITY : 2 * index->capacity;
+        int *new_handles = realloc(index->handles, new_capacity * sizeof(int));
+        /* if an allocation failure occurred, updates the handler and leaves the index unchanged */
+        if (new_handles == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when indexing symbol\n");
+            set_alloc_failure();
+            return 1;
+        }
+        index->handles = new_handles;
+        index->capacity = new_capacity;
+    }
+    index->handles[index->count++] = handle;
+    if (name_length > index->max_name_length) index->max_name_length = name_length;
+    return 0;
+}
+
+/**
+ * Adds an address to the end of an external symbol's appearances.
+ * If there is no more space for the address, doubles the capacity of the appearances.
+ * 
+ * @param symbol  a pointer to the symbol in the symbol table
+ * @param address the address of the memory word in which the symbol appears
+ * @return 0 if the address was added successfully, 1 if an allocation failure has occurred
+ */
+int add_appearance(SymbolContent *symbol, int address) {
+    Appearances *appearances = &symbol->appearances;
+    if (appearances->count == appearances->capacity) {
+        int new_capacity = appearances->capacity == 0 ? INITIAL_APPEARANCES_CAPACITY : 2 * appearances->capacity;
+        int *new_addresses = realloc(appearances->addresses, new_capacity * sizeof(int));
+        /* if an allocation failure occurred, updates the handler and leaves the appearances unchanged */
+        if (new_addresses == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when adding appearance\n");
+            set_alloc_failure();
+            return 1;
+        }
+        appearances->addresses = new_addresses;
+        appearances->capacity = new_capacity;
+    }
+    appearances->addresses[appearances->count++] = address;
+    return 0;
+}
+
+/**
+ * Adds a parsed line to the end of the Requirement's parsed lines.
+ * If there is no more space for the line, doubles the capacity of the parsed lines array.
+ * 
+ * @param requirements the requirements of the file
+ * @param line         the parsed line to be added
+ * @return 0 if the line was added successfully, 1 if an allocation failure has occurred
+ */
+int add_parsed_line(Requirements *requirements, ParsedLine line) {
+    if (requirements->parsed_line_count == requirements->parsed_line_capacity) {
+        int new_capacity = requirements->parsed_line_capacity == 0 ? INITIAL_PARSED_LINE_CAPACITY
+                                                                   : 2 * requirements->parsed_line_capacity;
+        ParsedLine *new_lines = realloc(requirements->parsed_lines, new_capacity * sizeof(ParsedLine));
+        /* if an allocation failure occurred, updates the handler and leaves the parsed lines unchanged */
+        if (new_lines == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when adding parsed line\n");
+            set_alloc_failure();
+            return 1;
+        }
+        requirements->parsed_lines = new_lines;
+        requirements->parsed_line_capacity = new_capacity;
+    }
+    requirements->parsed_lines[requirements->parsed_line_count++] = line;
+    return 0;
+}
+
+/**
+ * Adds a line to the end of the Requirement's lines of the macros' contents.
+ * If there is no more space for the line, doubles the capacity of the array of lines.
+ * 
+ * @param requirements the requirements of the file
+ * @param line         the line to be added
+ * @return 0 if the line was added successfully, 1 if an allocation failure has occurred
+ */
+int add_macro_line(Requirements *requirements, MacroLine line) {
+    if (requirements->macro_line_count == requirements->macro_line_capacity) {
+        int new_capacity = requirements->macro_line_capacity == 0 ? INITIAL_MACRO_LINE_CAPACITY
+                                                                  : 2 * requirements->macro_line_capacity;
+        MacroLine *new_lines = realloc(requirements->macro_lines, new_capacity * sizeof(MacroLine));
+        /* if an allocation failure occurred, updates the handler and leaves the lines unchanged */
+        if (new_lines == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when adding macro line\n");
+            set_alloc_failure();
+            return 1;
+        }
+        requirements->macro_lines = new_lines;
+        requirements->macro_line_capacity = new_capacity;
+    }
+    requirements->macro_lines[requirements->macro_line_count++] = line;
+    return 0;
+}
+
+/**
+ * Adds a fixup to the end of the Requirement's fixups. The fixup's symbol should be allocated from the arena.
+ * If there is no more space for the fixup, doubles the capacity of the fixups array.
+ * 
+ * @param requirements the requirements of the file
+ * @param fixup        the fixup to be added
+ * @return 0 if the fixup was added successfully, 1 if an allocation failure has occurred
+ */
+int add_fixup(Requirements *requirements, Fixup fixup) {
+    if (requirements->fixup_count == requirements->fixup_capacity) {
+        int new_capacity = requirements->fixup_capacity == 0 ? INITIAL_FIXUP_CAPACITY
+                                                             : 2 * requirements->fixup_capacity;
+        Fixup *new_fixups = realloc(requirements->fixups, new_capacity * sizeof(Fixup));
+        /* if an allocation failure occurred, updates the handler and leaves the fixups unchanged */
+        if (new_fixups == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when adding fixup\n");
+            set_alloc_failure();
+            return 1;
+        }
+        requirements->fixups = new_fixups;
+        requirements->fixup_capacity = new_capacity;
+    }
+    requirements->fixups[requirements->fixup_count++] = fixup;
+    return 0;
+}
@@ -1,380 +1,391 @@
 /**
- * Includes the function second_pass, which is responsible for encoding the operands of instructions,
- * updating symbols in the symbol table that are declared as .entry, and updating the list of appearances of external
- * symbols as operands. By the end of the second pass, the requirements of the file should be completely filled with
- * the information necessary to create the output files.
+ * Includes the function second_pass, which is responsible for handling the fixups that the first pass left for
+ * everything that depends on symbols: encoding operands in the direct address method, updating symbols in the symbol
+ * table that are declared as .entry, and updating the list of appearances of external symbols as operands. Since the
+ * symbol table is complete by then, the fixups are handled without reading the file again.
+ * By the end of the second pass, the requirements of the file should be completely filled with the information
+ * necessary to create the output files.
  * Also includes helper functions for second_pass.
  * Assumes that a symbol can be defined as .entry more than once, since it doesn't not interfere with any
  * part of the assembly process.
  */
 #include "../headers/second_pass.h"
 #include "../headers/util/string_ops.h"
-#include "../headers/util/general_util.h"
 #include "../headers/files.h"
 #include "stdio.h"
 #include "stdlib.h"
-#include "../headers/operators.h"
 #include "../headers/conversions.h"
+#include "../headers/console.h"
+#include "../headers/alloc_failure_handler.h"
+#include "../headers/chunks.h"
+
+/**
+ * The smallest number of fixups that a chunk of a file may have, when the file's fixups are split into chunks that
+ * are handled at the same time.
+ */
+#define MIN_CHUNK_FIXUPS 1024
+
+/**
+ * The number of fixups that the memory of a chunk's deferred fixups can hold once the chunk defers its first fixup.
+ */
+#define INITIAL_DEFERRED_CAPACITY 64
+
+/**
+ * Represents a chunk of a file's fixups, which the second pass handles on its own thread.
+ * The fixups are in the order of their lines, so the operand words of a chunk are a range of the memory image that no
+ * other chunk fills. Everything else that the fixups change - the types of the entry symbols, the index of entry
+ * symbols and the appearances of the external symbols - is deferred until all of the chunks are done, and then
+ * finished in the order of the fixups.
+ */
+typedef struct {
+    /* the state that every chunk shares, which the chunk's thread fills */
+    Chunk base;
+    /* the range of the fixups - from the first one to the one after the last */
+    int first_fixup;
+    int end_fixup;
+    /* the name of the input file that is being assembled (used for error reporting) */
+    char *input_file_name;
+    /* the requirements of the file */
+    Requirements *requirements;
+    /* the indexes of the fixups whose handling should be finished once all of the chunks are done, in order */
+    int *deferred;
+    /* the number of deferred fixups */
+    int deferred_count;
+    /* the number of deferred fixups that the allocated memory can hold */
+    int deferred_capacity;
+} SecondPassChunk;
 
 /** PROTOTYPES FOR FUNCTIONS DEFINED LATER IN THE FILE **/
 /** FOR DOCUMENTATION, SEE DEFINITIONS **/
 
-static void second_pass_handle_instruction(char *line, int line_count, char *parsed_file_name, int *error_found,
-                                    Requirements *requirements);
+static int handle_fixups(int first_fixup, int end_fixup, char *input_file_name, SecondPassChunk *chunk,
+                         Requirements *requirements);
 
-static void second_pass_handle_two_operand_instruction(char *rest, int line_count, char *parsed_file_name, int *error_found,
-                                                Requirements *requirements);
+static int second_pass_in_chunks(char *input_file_name, Requirements *requirements);
 
-static void second_pass_handle_one_operand_instruction(char *rest, int line_count, char *parsed_file_name, int *error_found,
-                                                Requirements *requirements);
+static int defer_fixup(SecondPassChunk *chunk, Fixup *fixup);
 
-static void check_and_handle_entry(char *rest, char *label_name, int line_count, char *parsed_file_name, int *error_found,
-                            Requirements *requirements);
+static void mark_entry_symbol(Fixup *fixup, SymbolContent *symbol, int *error_found, Requirements *requirements);
 
-static int validate_operand(char *operand, AddressMethod address_method, int line_count, char *parsed_file_name,
-                     int *error_found, Requirements *requirements);
+static SymbolContent *get_fixup_symbol(Fixup *fixup, Requirements *requirements);
 
-static short unsigned create_single_operand_word(char *operand, AddressMethod address_method, Requirements *requirements,
-                                          int is_source);
+static void handle_entry_fixup(Fixup *fixup, char *input_file_name, int *error_found, SecondPassChunk *chunk,
+                               Requirements *requirements);
 
-static short unsigned create_combined_operand_word(char *source_operand, char *destination_operand,
-                                            AddressMethod source_method, AddressMethod destination_method);
+static int handle_operand_fixup(Fixup *fixup, char *input_file_name, int *error_found, SecondPassChunk *chunk,
+                                Requirements *requirements);
 
-static void check_and_handle_external_symbol(char *symbol_name, Requirements *requirements);
+static int validate_operand(char *operand, AddressMethod address_method, SymbolContent *symbol, int line_count,
+                            char *input_file_name, int *error_found);
+
+static void check_and_handle_external_symbol(SymbolContent *symbol, int address, Requirements *requirements,
+                                             int *error_found);
 
 
 /**
- * Executes the second pass over the parsed .am file, which is responsible for encoding the operands of instructions,
- * updating symbols in the symbol table that are declared as .entry, and updating the list of appearances of external
- * symbols as operands.
+ * Executes the second pass over the fixups left by the first pass, which is responsible for encoding the operands
+ * in the direct address method, updating symbols in the symbol table that are declared as .entry, and updating the
+ * list of appearances of external symbols as operands. It also reports the errors of operands whose content was
+ * found to be invalid by the first pass.
  * 
- * Does so by going over every line, and if it is not blank or has a comment, checks if it is a directive. If it is not,
- * then it is an instruction and it is handled. Otherwise, checks if it is a .entry directive and handles it if it is
- * (all other directives have already been handled in the first pass).
+ * If the file may be handled by several threads and it has enough fixups, the fixups are first split into chunks
+ * that are handled at the same time (see second_pass_in_chunks). If that fails for any reason - including an error in
+ * the file, which should be reported exactly as in a single run over the fixups - the fixups are handled by a single
+ * run instead.
  * 
  * @param file_name the extensionless file name
  * @param requirements a pointer to the requirements of the file
  * @return 1 if an error has occurred, 0 otherwise
  */
 int second_pass(char file_name[], Requirements *requirements) {
-    char *parsed_file_name = get_parsed_file_name(file_name);
-    FILE *parsed_file = get_parsed_file_read(file_name);
-    int error_found = 0;
-    /* the number of the line being read */
-    int line_count = 0;
-    /* the line being read */
-    char line_read[MAX_LINE_LENGTH + 1];
-    /* the line's label */
-    char *label;
+    char *input_file_name = get_input_file_name(file_name, requirements->arena);
     /* makes sure the parsed file name is not null (no allocation failure occurred) */
-    if (parsed_file_name == NULL) {
+    if (input_file_name == NULL) {
         return 1;
     }
-    /* makes sure the parsed file is not null, if it is then the file can't be encoded */
-    if (!parsed_file) {
-        free(parsed_file_name);
-        return 1;
-    }
-    /* since the instructions are gone over again, resets the instruction counter */
-    requirements->ic = IC_START;
-    /* for each line */
-    while (!feof(parsed_file)) {
-        /* a pointer version of line_read that can have a pointer reference it */
-        char *line;
-        line_count++;
-        read_line(parsed_file, parsed_file_name, line_count, line_read);
-        line = line_read;
-        /* if the line is blank or a has a comment, skips to the next line.
-         * Even if the comment starts mid-line, this has already been reported in the first pass, and the line
-         * does not need to be encoded in the second pass */
-        if (is_line_blank(line) || exists(line, COMMENT_START)) continue;
-        find_label(&line, &label);
-        /* checks that the part after the label is not blank */
-        if (is_line_blank(line)) {
-            free(label);
-            continue;
+    if (requirements->thread_count > 1 && second_pass_in_chunks(input_file_name, requirements)) return 0;
+    /* if a memory allocation failure has occurred while the chunks were handled, stops */
+    if (is_alloc_failure()) return 1;
+    return handle_fixups(0, requirements->fixup_count, input_file_name, NULL, requirements);
+}
+
+/**
+ * Handles a range of the fixups of a file.
+ * 
+ * Does so by going over the fixups in the order of the lines they were left for. Every fixup of a .entry directive
+ * is handled by marking its symbol as an entry, and every fixup of an operand is validated and, if it is a symbol,
+ * its memory word is filled. Once an operand of an instruction is found to be invalid, the rest of the
+ * instruction's operands are skipped. An invalid operand in a line that was stamped out from a line of a macro's
+ * content is only reported once - the same line's operands are skipped at the macro's later usages.
+ * 
+ * @param first_fixup     the index of the first fixup to be handled
+ * @param end_fixup       the index of the fixup after the last one to be handled
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param chunk           a pointer to the chunk that the fixups belong to, or NULL if they are handled by a single run
+ * @param requirements    a pointer to the requirements of the file
+ * @return 1 if an error has occurred, 0 otherwise
+ */
+static int handle_fixups(int first_fixup, int end_fixup, char *input_file_name, SecondPassChunk *chunk,
+                         Requirements *requirements) {
+    int error_found = 0;
+    /* the number of the last line in which an invalid operand was found, or 0 if none was found */
+    int failed_line = 0;
+    int i;
+    for (i = first_fixup; i < end_fixup; i++) {
+        Fixup *fixup = &requirements->fixups[i];
+        /* the line of a macro's content that the fixup's line was stamped out from, if there is one */
+        MacroLine *macro_line = fixup->macro_line == -1 ? NULL : &requirements->macro_lines[fixup->macro_line];
+        if (fixup->kind == ENTRY_FIXUP) {
+            handle_entry_fixup(fixup, input_file_name, &error_found, chunk, requirements);
         }
-        /* if the line is not a directive, it's an instruction */
-        if (!is_directive(line)) {
-            free(label);
-            second_pass_handle_instruction(line, line_count, parsed_file_name, &error_found, requirements);
-            
+        /* skips the operands of a line whose invalid operand was already reported at an earlier usage of its macro */
+        else if (macro_line != NULL && macro_line->operand_error_reported) error_found = 1;
+        /* skips the operands that come after an invalid operand of the same instruction */
+        else if (fixup->line != failed_line &&
+                 !handle_operand_fixup(fixup, input_file_name, &error_found, chunk, requirements)) {
+            failed_line = fixup->line;
+            /* a chunk leaves the flag to the single run that reports its errors */
+            if (macro_line != NULL && chunk == NULL) macro_line->operand_error_reported = 1;
         }
-        /* otherwise, checks if the line is a .entry directive and handles it if necessary.All other directives
-         * have already been handled in the first pass */
-        else check_and_handle_entry(line, label, line_count, parsed_file_name, &error_found, requirements);
+        /* an error in a chunk means that the fixups are handled again by a single run, so the chunk can stop */
+        if (chunk != NULL && error_found) break;
     }
-    fclose(parsed_file);
-    free(parsed_file_name);
     return error_found;
 }
 
 /**
- * Checks if a given directive line is a .entry directive, and if so, handles it.
- * Does so by finding the directive itself (the first field of the line) and checking if it is .entry.
- * If it is, finds the argument (and makes sure there is exactly one), makes sure it is a defined, non-external symbol,
- * and if it is, finds it in the symbol table and changes its type to ENTRY.
- * Assumes that a symbol can be defined as .entry more than once, since it doesn't not interfere with any
- * part of the assembly process.
- * 
- * @param line             the line being read (excluding the label, if there is one)
- * @param label_name       the name of the line's label, or null if there isn't one
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * Handles a chunk on its own thread (see run_chunks): handles the chunk's fixups.
+ *
+ * @param arg a pointer to the chunk
+ * @return 1 if an error was found in the chunk's fixups, 0 otherwise
  */
-static void check_and_handle_entry(char *line, char *label_name, int line_count, char *parsed_file_name, int *error_found,
-                            Requirements *requirements) {
-    /* the part of the line after .entry */
-    char *rest;
-    char *directive = find_token(line, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag, frees the label name and stops */
-    if (directive == NULL) {
-        *error_found = 1;
-        free(label_name);
-        return;
+static int second_pass_chunk(void *arg) {
+    SecondPassChunk *chunk = (SecondPassChunk *) arg;
+    return handle_fixups(chunk->first_fixup, chunk->end_fixup, chunk->input_file_name, chunk, chunk->requirements);
+}
+
+/**
+ * Executes the second pass over the fixups of a file by splitting them into chunks and handling the chunks at the
+ * same time, each on its own thread. The symbol table is complete once the first pass is over, so the chunks only read
+ * it, and every chunk fills the operand words of its own range of the memory image. The fixups of the same line are
+ * always in the same chunk, since the skipping of an instruction's operands depends on the ones before them.
+ * Once all of the chunks are done, the fixups that they deferred are finished in order - the entry symbols are marked
+ * and indexed and the appearances of the external symbols are added - so the result is the same as in a single run.
+ * The result is only used if no chunk found an error, in which case the messages of the chunks (which can only be
+ * warnings) are printed in order. Otherwise, the symbol table is left as it was, so the fixups can be handled by a
+ * single run, which reports the errors in order (and fills the same words again).
+ * A file is only split if every chunk would have at least MIN_CHUNK_FIXUPS fixups.
+ *
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param requirements    a pointer to the requirements for the file
+ * @return 1 if the fixups were handled without errors, 0 otherwise
+ */
+static int second_pass_in_chunks(char *input_file_name, Requirements *requirements) {
+    int chunk_count = requirements->fixup_count / MIN_CHUNK_FIXUPS;
+    SecondPassChunk *chunks;
+    /* the number of chunks that were prepared */
+    int prepared;
+    int finished = 0;
+    int error_found = 0;
+    int i, j;
+    if (chunk_count > requirements->thread_count) chunk_count = requirements->thread_count;
+    if (chunk_count < 2) return 0;
+    chunks = calloc(chunk_count, sizeof(SecondPassChunk));
+    if (chunks == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when splitting fixups into chunks\n");
+        set_alloc_failure();
+        return 0;
     }
-    /* makes sure the directive is .entry */
-    if (equal(directive, ENTRY_DIRECTIVE)) {
-        /* the name of the symbol given as argument for .extern */
-        char *argument;
-        /* the content of the symbol being given as an argument */
-        SymbolContent *symbol;
-        /* if the line has a label, issues a warning */
-        if (label_name != NULL) {
-            printf("Warning: Label found before .entry directive in line %d of file %s\n",
-                   line_count, parsed_file_name);
-        }
-        /* the argument is the field directly after .entry */
-        argument = find_token(rest, BLANKS, &rest);
-        /* if a memory allocation failure has occurred, updates the error flag, frees variables and stops */
-        if (argument == NULL) {
-            *error_found = 1;
-            free_all(2, directive, label_name);
-            return;
+    /* splits the fixups as evenly as possible, without splitting the fixups of a line */
+    for (prepared = 0; prepared < chunk_count; prepared++) {
+        SecondPassChunk *chunk = &chunks[prepared];
+        chunk->first_fixup = prepared == 0 ? 0 : chunks[prepared - 1].end_fixup;
+        chunk->end_fixup = (int) ((long) requirements->fixup_count * (prepared + 1) / chunk_count);
+        if (chunk->end_fixup < chunk->first_fixup) chunk->end_fixup = chunk->first_fixup;
+        while (chunk->end_fixup > 0 && chunk->end_fixup < requirements->fixup_count &&
+               requirements->fixups[chunk->end_fixup].line == requirements->fixups[chunk->end_fixup - 1].line) {
+            chunk->end_fixup++;
         }
-        /* makes sure the argument field is not empty */
-        if (is_line_blank(argument)) {
-            printf("Input Error: No argument given to .entry directive in line %d of file %s\n",
-                   line_count, parsed_file_name);
-            *error_found = 1;
-            free_all(3, argument, directive, label_name);
-            return;
-        }
-        /* makes sure the part of the line after the argument is empty */
-        if (!is_line_blank(rest)) {
-            printf("Input Error: Extra characters after the argument for .entry directive in line %d of file %s\n",
-                   line_count, parsed_file_name);
-            *error_found = 1;
-            free_all(3, argument, directive, label_name);
-            return;
-        }
-        /* makes sure the argument symbol is defined */
-        if (!map_contains(requirements->symbol_table, argument)) {
-            printf("Input Error: Symbol \"%s\" given as argument for .entry directive in line %d of file %s is "
-                   "undefined in that file\n", argument, line_count, parsed_file_name);
-            *error_found = 1;
-            free_all(3, argument, directive, label_name);
-            return;
+        chunk->input_file_name = input_file_name;
+        chunk->requirements = requirements;
+        chunk->base.output = tmpfile();
+        if (chunk->base.output == NULL) break;
+    }
+    /* the deferred fixups are only finished if all of the chunks were prepared and handled without errors */
+    if (prepared == chunk_count && run_chunks(chunks, chunk_count, sizeof(SecondPassChunk), second_pass_chunk)) {
+        finished = 1;
+        for (i = 0; i < chunk_count; i++) {
+            if (chunks[i].base.alloc_failure || chunks[i].base.error_found) finished = 0;
         }
-        /* finds the reference to the symbol in the symbol table */
-        symbol = map_get_symbol(requirements->symbol_table, argument);
-        /* makes sure the symbol is not external */
-        if (symbol->type == EXTERNAL) {
-            printf("Input Error: Symbol \"%s\" given as argument for .entry directive in line %d of file %s is "
-                   "already defined in that file as external\n", argument, line_count, parsed_file_name);
-            *error_found = 1;
-            free_all(3, directive, label_name, argument);
-            return;
+        for (i = 0; finished && i < chunk_count; i++) {
+            for (j = 0; j < chunks[i].deferred_count; j++) {
+                Fixup *fixup = &requirements->fixups[chunks[i].deferred[j]];
+                SymbolContent *symbol = get_fixup_symbol(fixup, requirements);
+                if (fixup->kind == ENTRY_FIXUP) mark_entry_symbol(fixup, symbol, &error_found, requirements);
+                else check_and_handle_external_symbol(symbol, fixup->address, requirements, &error_found);
+            }
         }
-        free(argument);
-        /* changes the symbol's type to ENTRY */
-        symbol->type = ENTRY;
+        /* an error while finishing the fixups can only be an allocation failure */
+        if (error_found) finished = 0;
     }
-    free(directive);
-    free(label_name);
+    close_chunks(chunks, chunk_count, sizeof(SecondPassChunk), finished);
+    for (i = 0; i < chunk_count; i++) free(chunks[i].deferred);
+    free(chunks);
+    return finished;
 }
 
 /**
- * Verifies and encodes an instruction's operands and enters them into the memory image.
- * 
- * Does so by first making sure that the line doesn't contain any errors that were found and reported during the first
- * pass, by checking if it is in the faulty instructions set. If no such errors were found, finds the operator, and
- * based on what operator it is, handles the instruction either as a one-operator or two-operator instruction. If it is
- * a zero-operand instruction, there are no operators to encode.
- * 
- * @param line             the line being read (excluding the label, if there is one)
- * @param line_count       the number of the line in the file that is being analyzed
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * Adds a fixup to the end of the fixups that a chunk deferred.
+ * If there is no more space for the fixup, doubles the capacity of the deferred fixups.
+ *
+ * @param chunk a pointer to the chunk
+ * @param fixup a pointer to the fixup, in the fixups of the file
+ * @return 0 if the fixup was added successfully, 1 if an allocation failure has occurred
  */
-static void second_pass_handle_instruction(char *line, int line_count, char *parsed_file_name, int *error_found,
-                                    Requirements *requirements) {
-    /* the part of the line after the operator */
-    char *rest;
-    char *operator_name;
-    Operator op;
-    /* if the line was found to be faulty in the first pass, the operators can't be encoded */
-    if (set_contains(requirements->faulty_instructions, line_count)) return;
-    operator_name = find_token(line, BLANKS, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (operator_name == NULL) {
-        *error_found = 1;
-        return;
-    }
-    op = get_operator(operator_name);
-    free(operator_name);
-    /* increments the instruction count, so ic now refers to the slot in the memory where the first operand should go */ 
-    requirements->ic++;
-    
-    /* Since the instruction was found to have no syntax errors, the number of operands in teh instruction is as it
-     * should be based on the operator. */
-    
-    /* if the instruction has two operands */
-    if (has_source(op)) {
-        second_pass_handle_two_operand_instruction(rest, line_count, parsed_file_name, error_found, requirements);
-    } 
-    /* if the instruction has one operand */
-    else if (has_destination(op)) {
-        second_pass_handle_one_operand_instruction(rest, line_count, parsed_file_name, error_found, requirements);
+static int defer_fixup(SecondPassChunk *chunk, Fixup *fixup) {
+    if (chunk->deferred_count == chunk->deferred_capacity) {
+        int new_capacity = chunk->deferred_capacity == 0 ? INITIAL_DEFERRED_CAPACITY : 2 * chunk->deferred_capacity;
+        int *new_deferred = realloc(chunk->deferred, new_capacity * sizeof(int));
+        /* if an allocation failure occurred, updates the handler and leaves the deferred fixups unchanged */
+        if (new_deferred == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when deferring fixup\n");
+            set_alloc_failure();
+            return 1;
+        }
+        chunk->deferred = new_deferred;
+        chunk->deferred_capacity = new_capacity;
     }
+    chunk->deferred[chunk->deferred_count++] = fixup - chunk->requirements->fixups;
+    return 0;
 }
 
 /**
- * Verifies and encodes the operands of a two-operand instruction and inserts them into the memory image.
- * 
- * Does so by splitting the part of the line after the operator based on commas to find the operands, finding their
- * address methods, verifying the operand's legality, deciding whether they should be combined into a single word,
- * and finally encoding them. Also, if wither of the operands is found to be an external symbol, its slot in the memory
- * is added to the symbol's appearances list.
+ * Returns the symbol that a fixup refers to, if it is defined.
+ * Does so by reaching the symbol through the handle that the first pass got for it, so the symbol table is not
+ * searched again.
  * 
+ * @param fixup        a pointer to the fixup
+ * @param requirements a pointer to the requirements for the file
+ * @return a pointer to the symbol in the symbol table, or NULL if the fixup does not refer to a defined symbol
+ */
+static SymbolContent *get_fixup_symbol(Fixup *fixup, Requirements *requirements) {
+    SymbolContent *symbol;
+    if (fixup->handle == -1) return NULL;
+    symbol = map_get_symbol_at(requirements->symbol_table, fixup->handle);
+    return symbol->defined ? symbol : NULL;
+}
+
+/**
+ * Handles the fixup of a .entry directive.
+ * Does so by making sure the directive has exactly one argument, and that it is a defined symbol which is not
+ * external, and then changing the symbol's type to entry and adding it to the index of entry symbols (unless it is
+ * already an entry).
  * 
- * @param line             the part of the line after the operator
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param fixup           a pointer to the fixup of the directive
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param chunk           a pointer to the chunk that the fixup belongs to, which the marking of the symbol is deferred
+ *                        to, or NULL if the fixups are handled by a single run
+ * @param requirements    a pointer to the requirements for the file
  */
-static void second_pass_handle_two_operand_instruction(char *rest, int line_count, char *parsed_file_name, int *error_found,
-                                                Requirements *requirements) {
-    /* the field that represents the source operand */
-    char *source_operand;
-    /* the field that represents the source operand, without heading or trailing whitespaces */
-    char *trimmed_source_operand;
-    /* the field that represents the destination operand */
-    char *destination_operand;
-    /* the field that represents the destination operand, without heading or trailing whitespaces */
-    char *trimmed_destination_operand;
-    
-    /* the address method for the source operand */
-    AddressMethod source_method;
-    /* the address method for the destination operand */
-    AddressMethod destination_method;
-    
-    source_operand = find_token(rest, OPERAND_SEPARATOR, &rest);
-    destination_operand = find_token(rest, OPERAND_SEPARATOR, &rest);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (source_operand == NULL || destination_operand == NULL) {
+static void handle_entry_fixup(Fixup *fixup, char *input_file_name, int *error_found, SecondPassChunk *chunk,
+                               Requirements *requirements) {
+    /* the content of the symbol being given as an argument */
+    SymbolContent *symbol;
+    /* if the line has a label, issues a warning */
+    if (fixup->has_label) {
+        console_printf("Warning: Label found before .entry directive in line %d of file %s\n",
+                       fixup->line, input_file_name);
+    }
+    /* makes sure the argument field is not empty */
+    if (is_line_blank(fixup->symbol)) {
+        console_printf("Input Error: No argument given to .entry directive in line %d of file %s\n",
+                       fixup->line, input_file_name);
         *error_found = 1;
         return;
     }
-    trimmed_source_operand = trim(source_operand);
-    trimmed_destination_operand = trim(destination_operand);
-    free_all(2, source_operand, destination_operand);
-    /* if a memory allocation failure has occurred, updates the error flag and stops */
-    if (trimmed_source_operand == NULL || trimmed_destination_operand == NULL) {
+    /* makes sure the part of the line after the argument is empty */
+    if (fixup->has_extra_characters) {
+        console_printf("Input Error: Extra characters after the argument for .entry directive in line %d of "
+                       "file %s\n", fixup->line, input_file_name);
         *error_found = 1;
         return;
     }
-    
-    source_method = get_address_method(trimmed_source_operand);
-    destination_method = get_address_method(trimmed_destination_operand);
-    
-    /* makes sure that the operands are legal, with respect to their address methods */
-    if (!validate_operand(trimmed_source_operand, source_method, line_count, parsed_file_name,
-                          error_found, requirements)
-        || !validate_operand(trimmed_destination_operand, destination_method, line_count,
-                             parsed_file_name, error_found, requirements)) {
-        free_all(2, trimmed_source_operand, trimmed_destination_operand);
+    /* finds the reference to the symbol in the symbol table */
+    symbol = get_fixup_symbol(fixup, requirements);
+    /* makes sure the argument symbol is defined */
+    if (symbol == NULL) {
+        console_printf("Input Error: Symbol \"%s\" given as argument for .entry directive in line %d of file %s is "
+                       "undefined in that file\n", fixup->symbol, fixup->line, input_file_name);
+        *error_found = 1;
         return;
     }
-    /* if the operands should be combined into a single word, creates that word and inserts it to the memory */ 
-    if (should_combine_additional_words(source_method, destination_method)) {
-        short unsigned word = create_combined_operand_word(trimmed_source_operand,
-                                                           trimmed_destination_operand,
-                                                           source_method, destination_method);
-        memory_insert_instruction(requirements, word, line_count, parsed_file_name);
-    } 
-    /* if the operands should not be combined into a single word */
-    else {
-        short unsigned source_word = create_single_operand_word(trimmed_source_operand,
-                                                                source_method, requirements,
-                                                                1);
-        short unsigned destination_word = create_single_operand_word(trimmed_destination_operand, 
-                                                                     destination_method, requirements,
-                                                                     0);
-        /* if the source operand is a symbol, checks if it is external */
-        if (source_method == DIRECT_ADDRESS) {
-            check_and_handle_external_symbol(trimmed_source_operand, requirements);
-        }
-        memory_insert_instruction(requirements, source_word, line_count, parsed_file_name);
-        
-        /* if the destination operand is a symbol, checks if it is external */
-        if (destination_method == DIRECT_ADDRESS) {
-            check_and_handle_external_symbol(trimmed_destination_operand, requirements);
-        }
-        memory_insert_instruction(requirements, destination_word, line_count, parsed_file_name);
+    /* makes sure the symbol is not external */
+    if (symbol->type == EXTERNAL) {
+        console_printf("Input Error: Symbol \"%s\" given as argument for .entry directive in line %d of file %s is "
+                       "already defined in that file as external\n", fixup->symbol, fixup->line, input_file_name);
+        *error_found = 1;
+        return;
     }
-    free_all(2, trimmed_source_operand, trimmed_destination_operand);
+    /* a chunk only reads the symbol table, so the symbol is marked once all of the chunks are done */
+    if (chunk != NULL) {
+        if (defer_fixup(chunk, fixup)) *error_found = 1;
+        return;
+    }
+    mark_entry_symbol(fixup, symbol, error_found, requirements);
 }
 
 /**
- * Verifies and encodes the operand of a one-operand instruction and inserts it into the memory image.
- * 
- * Does so by finding the field after the operator, verifying it, checking if it is an external symbol and adding
- * the slot in the memory to its appearances list if necessary, and finally encoding the operand and adding to the
- * memory image.
+ * Marks the symbol of a valid .entry directive as an entry symbol and adds it to the index of entry symbols, unless it
+ * is already an entry.
  * 
- * @param line             the part of the line after the operator
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements for the file
+ * @param fixup        a pointer to the fixup of the directive
+ * @param symbol       a pointer to the symbol in the symbol table
+ * @param error_found  a pointer to a value that represents whether an error has been found
+ * @param requirements a pointer to the requirements for the file
  */
-static void second_pass_handle_one_operand_instruction(char *rest, int line_count, char *parsed_file_name, int *error_found,
-                                                Requirements *requirements) {
-    /* the only field after the operator is the destination operand */
-    char *destination_operand = find_token(rest, BLANKS, &rest);
-    /* the word in the memory representing the destination operand */
-    short unsigned destination_word;
-    
-    /* the destination operand's address method */
-    AddressMethod destination_method;
-    
-    if (destination_operand ==  NULL) {
-        *error_found = 1;
-        return;
-    }
+static void mark_entry_symbol(Fixup *fixup, SymbolContent *symbol, int *error_found, Requirements *requirements) {
+    /* a symbol that is declared as an entry more than once is only indexed once */
+    if (symbol->type == ENTRY) return;
+    /* changes the symbol's type to ENTRY */
+    symbol->type = ENTRY;
+    if (add_to_symbol_index(&requirements->entry_symbols, fixup->handle, fixup->symbol)) *error_found = 1;
+}
 
-    destination_method = get_address_method(destination_operand);
-    
-    /* makes sure that the operand is legal, with respect to its address method */
-    if (!validate_operand(destination_operand, destination_method, line_count, parsed_file_name, error_found,
-                          requirements)) {
-        free(destination_operand);
-        return;
+/**
+ * Handles the fixup of an operand.
+ * Does so by reaching the operand's symbol through its handle if it is in the direct address method, validating the
+ * operand with respect to its address method, and if it is a valid symbol, filling its memory word based on the
+ * symbol's value and type, and adding the word's address to the symbol's appearances if it is external.
+ * 
+ * @param fixup           a pointer to the fixup of the operand
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
+ * @param chunk           a pointer to the chunk that the fixup belongs to, which the appearances of external symbols
+ *                        are deferred to, or NULL if the fixups are handled by a single run
+ * @param requirements    a pointer to the requirements for the file
+ * @return 1 if the operand is valid, 0 otherwise
+ */
+static int handle_operand_fixup(Fixup *fixup, char *input_file_name, int *error_found, SecondPassChunk *chunk,
+                                Requirements *requirements) {
+    /* the symbol that the operand refers to, or NULL if it is not a defined symbol */
+    SymbolContent *symbol = get_fixup_symbol(fixup, requirements);
+    /* the address of the symbol in the memory image */
+    int address;
+    if (!validate_operand(fixup->symbol, fixup->method, symbol, fixup->line, input_file_name, error_found)) {
+        return 0;
     }
-    /* if the operand is a symbol, checks if it is external and handles it appropriately */
-    if (destination_method == DIRECT_ADDRESS) {
-        check_and_handle_external_symbol(destination_operand, requirements);
+    /* the first pass only leaves fixups for valid operands if they are symbols, and if the word could not be
+     * inserted there is nothing to fill */
+    if (fixup->method != DIRECT_ADDRESS || fixup->address == -1) return 1;
+    address = get_symbol_address(requirements, *symbol);
+    requirements->instruction_array[fixup->address] = create_direct_address_word(address, symbol->type);
+    /* a chunk only reads the symbol table, so the appearance is added once all of the chunks are done */
+    if (chunk != NULL && symbol->type == EXTERNAL) {
+        if (defer_fixup(chunk, fixup)) *error_found = 1;
     }
-    /* creates the memory word for the operands and inserts it to the memory */
-    destination_word = create_single_operand_word(destination_operand,
-                                                  destination_method, requirements, 0);
-    memory_insert_instruction(requirements, destination_word, line_count, parsed_file_name);
-    free(destination_operand);
+    else check_and_handle_external_symbol(symbol, fixup->address, requirements, error_found);
+    return 1;
 }
 
 /**
@@ -383,27 +394,27 @@ static void second_pass_handle_one_operand_instruction(char *rest, int line_coun
  * Does so by checking sure that the part after the pound is an integer, and that it within the bounds for a
  * signed 12 bit integer in the 2's complement method.
  * 
- * @param operand          the operand to be checked
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
+ * @param operand         the operand to be checked
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
  * @return 1 if the operand is legal, 0 otherwise
  */
-static int validate_immediate_address_operand(char *operand, int line_count, char *parsed_file_name, int *error_found) {
+static int validate_immediate_address_operand(char *operand, int line_count, char *input_file_name, int *error_found) {
     /* the value represented by the operand */
     int value;
     /* makes sure the part of the operand after the starting pound is an integer */
     if (!is_integer(operand + 1)) {
-        printf("Input Error: In operand \"%s\" given in the immediate address method in line %d of file %s, "
-               "%s is not an integer\n", operand, line_count, parsed_file_name, operand + 1);
+        console_printf("Input Error: In operand \"%s\" given in the immediate address method in line %d of file %s, "
+                       "%s is not an integer\n", operand, line_count, input_file_name, operand + 1);
         *error_found = 1;
         return 0;
     }
     value = atoi(operand + 1);
     /* makes sure the operand's value is within the bounds for signed 12 bit integer in the 2's complement method */
     if (value > IMMEDIATE_VALUE_MAX || value < IMMEDIATE_VALUE_MIN) {
-        printf("Input Error: In operand \"%s\" given in the immediate address method in line %d of file %s, "
-               "%d is not in the allowed range\n", operand, line_count, parsed_file_name, value);
+        console_printf("Input Error: In operand \"%s\" given in the immediate address method in line %d of file %s, "
+                       "%d is not in the allowed range\n", operand, line_count, input_file_name, value);
         *error_found = 1;
         return 0;
     }
@@ -413,21 +424,21 @@ static int validate_immediate_address_operand(char *operand, int line_count, cha
 /**
  * Checks if a given operand given in the direct address method is legal.
  * 
- * Does so by checking if it is in fact a defined symbol.
+ * Does so by checking if it is in fact a defined symbol, based on the result of looking it up in the symbol table.
  * 
- * @param operand          the operand to be checked
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements of the file
+ * @param operand         the operand to be checked
+ * @param symbol          the symbol that the operand refers to, or NULL if it is not a defined symbol
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
  * @return 1 if the operand is legal, 0 otherwise
  */
-static int validate_direct_address_operand(char *operand, int line_count, char *parsed_file_name, int *error_found,
-                                    Requirements *requirements) {
+static int validate_direct_address_operand(char *operand, SymbolContent *symbol, int line_count,
+                                           char *input_file_name, int *error_found) {
     /* makes sure the operand is a defined symbol */
-    if (!map_contains(requirements->symbol_table, operand)) {
-        printf("Input Error: Operand \"%s\" given in the direct address method in line %d of file %s is not"
-               " a defined symbol\n", operand, line_count, parsed_file_name);
+    if (symbol == NULL) {
+        console_printf("Input Error: Operand \"%s\" given in the direct address method in line %d of file %s is not"
+                       " a defined symbol\n", operand, line_count, input_file_name);
         *error_found = 1;
         return 0;
     }
@@ -439,17 +450,17 @@ static int validate_direct_address_operand(char *operand, int line_count, char *
  * 
  * Does so by checking if the part after the starting asterisk is a legal register.
  * 
- * @param operand          the operand to be checked
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
+ * @param operand         the operand to be checked
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
  * @return 1 if the operand is legal, 0 otherwise
  */
-static int validate_indirect_register_address_operand(char *operand, int line_count, char *parsed_file_name,
+static int validate_indirect_register_address_operand(char *operand, int line_count, char *input_file_name,
                                                int *error_found) {
     if (!is_register(operand + 1)) {
-        printf("Input Error: In operand \"%s\" given in the indirect register address method in line %d of file %s,"
-               " %s is not valid register\n", operand, line_count, parsed_file_name, operand + 1);
+        console_printf("Input Error: In operand \"%s\" given in the indirect register address method in line %d of "
+                       "file %s, %s is not valid register\n", operand, line_count, input_file_name, operand + 1);
         *error_found = 1;
         return 0;
     }
@@ -459,24 +470,25 @@ static int validate_indirect_register_address_operand(char *operand, int line_co
 /**
  * Makes sure that a given operand is legal in respect to its address method.
  * 
- * @param operand          the operand to be checked
- * @param address_method   the operand's address method
- * @param line_count       the number of the line in the file that is being analyzed (used for error reporting)
- * @param parsed_file_name the name of the parsed file that is being read (used for error reporting)
- * @param error_found      a pointer to a value that represents whether an error has been found
- * @param requirements     a pointer to the requirements of the file
+ * @param operand         the operand to be checked
+ * @param address_method  the operand's address method
+ * @param symbol          the symbol that the operand refers to, or NULL if it is not a defined symbol (only used in
+ *                        the direct address method)
+ * @param line_count      the number of the line in the file that is being analyzed (used for error reporting)
+ * @param input_file_name the name of the input file that is being assembled (used for error reporting)
+ * @param error_found     a pointer to a value that represents whether an error has been found
  * @return 1 if the operand is legal, 0 otherwise
  */
-static int validate_operand(char *operand, AddressMethod address_method, int line_count, char *parsed_file_name,
-                     int *error_found, Requirements *requirements) {
+static int validate_operand(char *operand, AddressMethod address_method, SymbolContent *symbol, int line_count,
+                            char *input_file_name, int *error_found) {
     if (address_method == IMMEDIATE_ADDRESS) {
-        return validate_immediate_address_operand(operand, line_count, parsed_file_name, error_found);
+        return validate_immediate_address_operand(operand, line_count, input_file_name, error_found);
     }
     if (address_method == INDIRECT_REGISTER_ADDRESS) {
-        return validate_indirect_register_address_operand(operand, line_count, parsed_file_name, error_found);
+        return validate_indirect_register_address_operand(operand, line_count, input_file_name, error_found);
     }
     if (address_method == DIRECT_ADDRESS) {
-        return validate_direct_address_operand(operand, line_count, parsed_file_name, error_found, requirements);
+        return validate_direct_address_operand(operand, symbol, line_count, input_file_name, error_found);
     }
     /* an operand is considered to be in the direct register address if and only if it is one of eight defined
      * keywords (the registers), which means it necessarily legal */
@@ -484,82 +496,19 @@ static int validate_operand(char *operand, AddressMethod address_method, int lin
 }
 
 /**
- * Creates a memory word representing a single operand.
- * Assumes the operand is valid.
- * 
- * Does so by building the correct type of word based on the operand's address method, as well as whether it is a source
- * or destination operand if the address method is one of the register address methods, and whether it is an external
- * symbol if the address method is direct address.
- * 
- * @param operand        the operand to be represented
- * @param address_method the operand's address method
- * @param requirements   the requirements of the file
- * @param is_source      1 if the operand is a source operand, 0 if it is a destination operand
- * @return the memory word
- */
-static short unsigned create_single_operand_word(char *operand, AddressMethod address_method, Requirements *requirements,
-                                          int is_source) {
-    /* if the address method is immediate address, the immediate value is the part after the starting '#',
-     * builds the word based on this value */
-    if (address_method == IMMEDIATE_ADDRESS) {
-        return create_immediate_address_word(atoi(operand + 1));
-    }
-    /* if the address method is direct address, gets the symbol's value and type and builds the word */
-    if (address_method == DIRECT_ADDRESS) {
-        SymbolContent symbol = *map_get_symbol(requirements->symbol_table, operand);
-        return create_direct_address_word(symbol.value, symbol.type);
-    }
-    /* if the address method is indirect register address, then the register is the part after the starting '*'.
-     * The word is different for source and destination operands */
-    if (address_method == INDIRECT_REGISTER_ADDRESS && is_source) {
-        return create_source_register_word(operand + 1);
-    }
-    /* the address method is indirect register address, but it is necessarily not a source operand */
-    if (address_method == INDIRECT_REGISTER_ADDRESS) {
-        return create_destination_register_word(operand + 1);
-    }
-    /* the address method is necessarily direct register address, so the register is the whole operand.
-     * The word changes based on whether it is a source or destination operand */
-    if (is_source) return create_source_register_word(operand);
-    return create_destination_register_word(operand);
-}
-
-/**
- * Creates a memory word representing two operands in the either direct or indirect register address method.
- * Assumes both operands are valid and are given in one of the mentioned methods.
- * 
- * Does so by getting the register part of the operands based on their address methods, and creating the memory
- * word based on the registers.
- * 
- * @param source_operand      the source operand
- * @param destination_operand the destination operand
- * @param source_method       the source operand's address method
- * @param destination_method  the destination operand's address method
- * @return the memory word
- */
-static short unsigned create_combined_operand_word(char *source_operand, char *destination_operand,
-                                            AddressMethod source_method, AddressMethod destination_method) {
-    /* if the address method for either of the operands is indirect register address, then the register is the part
-     * immediately after the starting asterisk, so the operand variable changes to it.
-     * Otherwise, it's the whole operand */
-    if (source_method == INDIRECT_REGISTER_ADDRESS) source_operand++;
-    if (destination_method == INDIRECT_REGISTER_ADDRESS) destination_operand++;
-    return create_combined_register_word(source_operand, destination_operand);
-}
-
-/**
- * Checks if a symbol used aas an operand is an external symbol, and if it does, inserts the instruction counter (the
- * index of the operand's memory word) to the symbol's appearances list, and updating the requirements to know that
- * a .ext file needs to be created.
- * Assumes that the symbol name given represents an existing symbol.
+ * Checks if a symbol used aas an operand is an external symbol, and if it does, appends the address of the operand's
+ * memory word to the symbol's appearances, and updating the requirements to know that a .ext file needs to be
+ * created.
  * 
- * @param symbol_name the name of the symbol to be checked
+ * @param symbol       a pointer to the symbol to be checked, in the symbol table
+ * @param address      the address of the operand's memory word
  * @param requirements a pointer to the requirements of the file
+ * @param error_found  a pointer to a value that represents whether an error has been found
  */
-static void check_and_handle_external_symbol(char *symbol_name, Requirements *requirements) {
-    SymbolContent *symbol_content = map_get_symbol(requirements->symbol_table, symbol_name);
-    if (symbol_content->type == EXTERNAL) {
-        list_add_int(symbol_content->appearances, requirements->ic);
+static void check_and_handle_external_symbol(SymbolContent *symbol, int address, Requirements *requirements,
+                                             int *error_found) {
+    if (symbol->type == EXTERNAL) {
+        if (add_appearance(symbol, address)) *error_found = 1;
         requirements->extern_found = 1;
     }
 }
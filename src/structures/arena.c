@@ -0,0 +1,125 @@
+/**
+ * Includes functions that allow for interacting with arenas.
+ */
+
+#include "../../headers/structures/arena.h"
+#include "stdlib.h"
+#include "stdio.h"
+#include "../../headers/alloc_failure_handler.h"
+
+/**
+ * The number of bytes that a block can hold, unless a larger object is requested.
+ */
+#define BLOCK_SIZE 65536
+
+/**
+ * A union of the types with the strictest alignment, so its size is a multiple that fits the alignment of any object.
+ */
+typedef union {
+    long integer;
+    double real;
+    void *pointer;
+} MaxAlign;
+
+/**
+ * Rounds a number of bytes up to the nearest multiple of the strictest alignment.
+ */
+#define ALIGN(size) (((size) + sizeof(MaxAlign) - 1) / sizeof(MaxAlign) * sizeof(MaxAlign))
+
+/**
+ * The number of bytes taken by the header of a block, so that the objects after it are aligned.
+ */
+#define HEADER_SIZE ALIGN(sizeof(ArenaBlock))
+
+/**
+ * Initializes a new, empty arena. No memory is allocated until the first object is requested.
+ *
+ * @param arena a pointer to the arena to be initialized
+ */
+void init_arena(Arena *arena) {
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+/**
+ * Allocates a new, empty block that can hold a given number of bytes.
+ *
+ * @param size the number of bytes that the block should be able to hold
+ * @return a pointer to the new block, or NULL if an allocation failure has occurred
+ */
+static ArenaBlock *create_block(size_t size) {
+    ArenaBlock *block = malloc(HEADER_SIZE + size);
+    /* if an allocation failure has occurred, updates the handler and returns NULL */
+    if (block == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when extending arena\n");
+        set_alloc_failure();
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+/**
+ * Allocates memory for an object from an arena. The memory is aligned for any type of object, and stays valid until
+ * the arena is reset or released.
+ * Does so by going over the blocks from the current one until finding one with enough room, and if there is no such
+ * block, adding a new block to the end of the arena (which is large enough for the object). The object is then
+ * handed out from the unused part of the block.
+ *
+ * @param arena a pointer to the arena that the memory should be allocated from
+ * @param size  the number of bytes to be allocated
+ * @return a pointer to the allocated memory, or NULL if an allocation failure has occurred
+ */
+void *arena_allocate(Arena *arena, size_t size) {
+    ArenaBlock *block = arena->current;
+    /* the last block that was checked */
+    ArenaBlock *last = NULL;
+    void *object;
+    size = ALIGN(size);
+    while (block != NULL && block->used + size > block->size) {
+        last = block;
+        block = block->next;
+    }
+    /* if no block has enough room, adds a new one after the last block */
+    if (block == NULL) {
+        block = create_block(size > BLOCK_SIZE ? size : BLOCK_SIZE);
+        if (block == NULL) return NULL;
+        if (last == NULL) arena->first = block;
+        else last->next = block;
+    }
+    arena->current = block;
+    object = (char *) block + HEADER_SIZE + block->used;
+    block->used += size;
+    return object;
+}
+
+/**
+ * Releases all of the objects allocated from an arena at once, while keeping its blocks so that they can be reused.
+ * Does so by marking every block as unused and handing out the next objects from the first block.
+ *
+ * @param arena a pointer to the arena to be reset
+ */
+void reset_arena(Arena *arena) {
+    ArenaBlock *block;
+    for (block = arena->first; block != NULL; block = block->next) block->used = 0;
+    arena->current = arena->first;
+}
+
+/**
+ * Frees all of the blocks of an arena (and with them, all of the objects allocated from it) from the memory.
+ * Does so by freeing the blocks one by one, and leaving the arena empty.
+ *
+ * @param arena a pointer to the arena to be released
+ */
+void release_arena(Arena *arena) {
+    ArenaBlock *block = arena->first;
+    ArenaBlock *next;
+    while (block != NULL) {
+        next = block->next;
+        free(block);
+        block = next;
+    }
+    init_arena(arena);
+}
@@ -5,76 +5,176 @@
 #include "../../headers/structures/hash_map.h"
 #include "stdlib.h"
 #include "stdio.h"
+#include "string.h"
 #include "../../headers/alloc_failure_handler.h"
 
-#define HASH_MULTIPLIER 31
+/**
+ * The number of slots in the hash-table of a new map (must be a power of two).
+ */
+#define INITIAL_SLOT_COUNT 64
+
+/**
+ * The number of items that the memory of a new map can hold.
+ */
+#define INITIAL_ITEM_CAPACITY 32
+
+/**
+ * The seed that every hash-value starts from.
+ */
+#define MAP_HASH_SEED 0x9E3779B9UL
+
+/**
+ * The prime that the hash-value is multiplied by after each character (the 32-bit FNV prime).
+ */
+#define HASH_PRIME 16777619UL
 
 /**
- * Generates a hash value for a given string, that represents the index of the list that a value which has the given
- * string as its name should be entered into.
- * Does so by multiplying each character in the string by a power of 31 (with the power increasing by 1 for each
- * character), and then taking the modulo 101 of the value so it can exists as a slot in the map.
+ * A mask that keeps only the lowest 32 bits of a hash-value, since an unsigned long may be wider than that.
+ */
+#define HASH_MASK 0xFFFFFFFFUL
+
+/**
+ * Generates a hash-value for a given string.
+ * Does so by starting from the seed, and for each character, combining it with the value using XOR and multiplying the
+ * value by a prime (as in FNV-1a). Then mixes the bits of the value so that every bit of the string affects the lowest
+ * bits, which are the ones that choose the slot.
  * 
- * @param  s the name to be hashed
- * @return the hash value for the given string
+ * @param  string the name to be hashed
+ * @return the hash-value for the given string
  */
-unsigned map_hash(char *string) {
-    unsigned hash_val;
-    for (hash_val = 0; *string != '\0'; string++) {
-        hash_val = *string + HASH_MULTIPLIER * hash_val;
+unsigned long map_hash(char *string) {
+    unsigned long hash_val = MAP_HASH_SEED;
+    for (; *string != '\0'; string++) {
+        hash_val = ((hash_val ^ (unsigned char) *string) * HASH_PRIME) & HASH_MASK;
     }
-    return hash_val % MAP_HASH_TABLE_SIZE;
+    hash_val ^= hash_val >> 16;
+    hash_val = (hash_val * 0x85EBCA6BUL) & HASH_MASK;
+    hash_val ^= hash_val >> 13;
+    hash_val = (hash_val * 0xC2B2AE35UL) & HASH_MASK;
+    hash_val ^= hash_val >> 16;
+    return hash_val;
+}
+
+/**
+ * Allocates a hash-table with a given number of slots, all of them empty.
+ * 
+ * @param slot_count the number of slots in the table
+ * @return a pointer to the table, or NULL if an allocation failure has occurred
+ */
+static MapSlot *create_slots(int slot_count) {
+    MapSlot *slots = malloc(slot_count * sizeof(MapSlot));
+    int i;
+    /* if an allocation failure has occurred, updates the handler and returns NULL */
+    if (slots == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating map\n");
+        set_alloc_failure();
+        return NULL;
+    }
+    for (i = 0; i < slot_count; i++) {
+        slots[i].item = -1;
+    }
+    return slots;
 }
 
 /**
  * Creates a new, empty hash-map.
- * Does so by allocating the necessary memory in the heap, and creating a new list for every slot.
+ * Does so by allocating the map, its hash-table and its items in the heap.
  * 
  * @return a pointer to the new map, or null if an allocation failure occurred
  */
 HashMap *create_map(ContentType content_type) {
     HashMap *map = malloc(sizeof(HashMap));
-    int i;
     /* if an allocation failure has occurred, updates the handler and returns NULL */
     if (map == NULL) {
         fprintf(stderr, "Memory Error: Memory allocation failure when creating map\n");
         set_alloc_failure();
         return NULL;
     }
-    for (i = 0; i < MAP_HASH_TABLE_SIZE; i++) {
-        map->lists[i] = create_list(content_type);
+    map->content_type = content_type;
+    map->slot_count = INITIAL_SLOT_COUNT;
+    map->slots = create_slots(INITIAL_SLOT_COUNT);
+    map->item_count = 0;
+    map->item_capacity = INITIAL_ITEM_CAPACITY;
+    map->items = malloc(INITIAL_ITEM_CAPACITY * sizeof(MapItem));
+    /* if an allocation failure has occurred, updates the handler, frees what was allocated and returns NULL */
+    if (map->slots == NULL || map->items == NULL) {
+        if (map->items == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when creating map\n");
+            set_alloc_failure();
+        }
+        free(map->slots);
+        free(map->items);
+        free(map);
+        return NULL;
     }
     return map;
 }
 
+/**
+ * Checks if the item of a slot has a given name.
+ * Does so by comparing the name with the beginning of the item's name that is kept in the slot. Only if the item's
+ * name is too long to be kept whole, compares the rest of it with the rest of the given name.
+ * 
+ * @param map  a pointer to the map that the slot belongs to
+ * @param slot a pointer to the slot, which should not be empty
+ * @param name the name to compare with
+ * @return 1 if the slot's item has the given name, 0 otherwise
+ */
+static int slot_has_name(HashMap *map, MapSlot *slot, char *name) {
+    if (strncmp(slot->key, name, MAP_INLINE_KEY_LENGTH) != 0) return 0;
+    /* a name that is kept whole ends with a zero, and has already been compared entirely */
+    if (slot->key[MAP_INLINE_KEY_LENGTH - 1] == '\0') return 1;
+    return strcmp(map->items[slot->item].name + MAP_INLINE_KEY_LENGTH, name + MAP_INLINE_KEY_LENGTH) == 0;
+}
+
+/**
+ * Finds the slot of the item with a given name, or the empty slot that such an item should be placed in.
+ * Does so by starting from the slot that the name's hash-value points to, and going over the next slots one by one
+ * until reaching an empty slot or a slot with the same hash-value whose item has the given name.
+ * 
+ * @param map  a pointer to the map that should be searched
+ * @param name the name to look for
+ * @param hash the hash-value of the name
+ * @return a pointer to the item's slot, or to an empty slot if the map has no item with the given name
+ */
+static MapSlot *find_slot(HashMap *map, char *name, unsigned long hash) {
+    /* since the number of slots is a power of two, the remainder can be found using a mask */
+    unsigned long mask = map->slot_count - 1;
+    unsigned long i = hash & mask;
+    while (map->slots[i].item != -1) {
+        if (map->slots[i].hash == hash && slot_has_name(map, &map->slots[i], name)) break;
+        i = (i + 1) & mask;
+    }
+    return &map->slots[i];
+}
+
 /**
  * Checks if a map contains an item represented by a given name.
- * Does so by checking if the list at the index of the name's hash-value contains an item that has the given name.
+ * Does so by checking if the slot found for the name holds an item.
  * 
  * @param map   a pointer to the map to be checked
  * @param name  the name to be checked
  * @return      1 if the map contains an item with the given name, 0 otherwise
  */
 int map_contains(HashMap *map, char *name) {
-    return list_contains(map->lists[map_hash(name)], name);
+    return find_slot(map, name, map_hash(name))->item != -1;
 }
 
 /**
  * Looks for a name in a hash-map and retrieves the content associated with that name.
- * Does so by looking for the name in the list at the index of the name's hash-value and retrieving its content.
+ * Does so by retrieving the content of the item in the slot found for the name.
  * Should only be used after verifying that the name exists in the map using map_contains.
  * 
  * @param map   a pointer to the hash-map that the content should be retrieved from
  * @param name  the name to look for
  * @return      a pointer to the content associated with the given name
  */
-Content *map_get(HashMap *map, char *name) {
-    return list_get(map->lists[map_hash(name)], name);
+static Content *map_get(HashMap *map, char *name) {
+    return &map->items[find_slot(map, name, map_hash(name))->item].content;
 }
 
 /**
  * Looks for a name in a hash-map and retrieves the macro content associated with that name.
- * Does so by looking for the name in the list at the index of the name's hash-value and retrieving its macro content.
  * Should only be used after verifying that the name exists in the map using map_contains.
  * 
  * @param map   a pointer to the hash-map that the macro should be retrieved from
@@ -87,7 +187,6 @@ MacroContent *map_get_macro(HashMap *map, char *name) {
 
 /**
  * Looks for a name in a hash-map and retrieves the symbol content associated with that name.
- * Does so by looking for the name in the list at the index of the name's hash-value and retrieving its symbol content.
  * Should only be used after verifying that the name exists in the map using map_contains.
  * 
  * @param map   a pointer to the hash-map that the symbol should be retrieved from
@@ -99,77 +198,179 @@ SymbolContent *map_get_symbol(HashMap *map, char *name) {
 }
 
 /**
- * Adds a macro with a given name to a hash-map.
- * Does so by adding it to the list at the index of the name's hash-value.
+ * Looks for a name in a hash-map and returns the handle of the item with that name, if there is one.
+ * Does so by returning the index of the item in the slot found for the name, which is -1 if the slot is empty.
  * 
- * @param map           a pointer to the map that the macro should be added to
- * @param name          the name of the macro
- * @param macro_content the content of the macro to be added
+ * @param map   a pointer to the hash-map to be searched
+ * @param name  the name to look for
+ * @return      the handle of the item with the given name, or -1 if the map has no item with the given name
  */
-void map_add_macro(HashMap *map, char *name, MacroContent macro_content) {
-    list_add_macro(map->lists[map_hash(name)], name, macro_content);
+int map_find_handle(HashMap *map, char *name) {
+    return find_slot(map, name, map_hash(name))->item;
 }
 
 /**
- * Adds an symbol with a given name to a hash-map.
- * Does so by adding it to the list at the index of the name's hash-value.
+ * Retrieves the symbol content of the item with a given handle, without searching the map.
+ * The pointer stays valid until the next item is added to the map.
  * 
- * @param map           a pointer to the map that the symbol should be added to
- * @param name           the name of the symbol
- * @param symbol_content the content of the symbol to be added
+ * @param map    a pointer to the hash-map that the symbol should be retrieved from
+ * @param handle the handle of the item, as returned when it was found or added
+ * @return       a pointer to the symbol content of the item
  */
-void map_add_symbol(HashMap *map, char *name, SymbolContent symbol_content) {
-    list_add_symbol(map->lists[map_hash(name)], name, symbol_content);
+SymbolContent *map_get_symbol_at(HashMap *map, int handle) {
+    return &map->items[handle].content.symbol;
 }
 
 /**
- * Frees a hash-map and all of its contents from the memory.
- * Does so by freeing the list in every slot and their items' names and contents, and then 
- * freeing the pointer to the map.
+ * Retrieves the encoding content of the item with a given handle, without searching the map.
+ * The pointer stays valid until the next item is added to the map.
  * 
- * @param map a pointer to the map that should be freed
+ * @param map    a pointer to the hash-map that the encoding should be retrieved from
+ * @param handle the handle of the item, as returned when it was found or added
+ * @return       a pointer to the encoding content of the item
  */
-void free_map(HashMap *map) {
+EncodingContent *map_get_encoding_at(HashMap *map, int handle) {
+    return &map->items[handle].content.encoding;
+}
+
+/**
+ * Retrieves the name of the item with a given handle, without searching the map.
+ * 
+ * @param map    a pointer to the hash-map that the name should be retrieved from
+ * @param handle the handle of the item, as returned when it was found or added
+ * @return       the name of the item
+ */
+char *map_get_name_at(HashMap *map, int handle) {
+    return map->items[handle].name;
+}
+
+/**
+ * Doubles the number of slots in a hash-map's table.
+ * Does so by allocating a new table and placing the slot of every item in it, based on the stored hash-values (so
+ * no name is hashed or compared again).
+ * 
+ * @param map a pointer to the map whose table should grow
+ * @return 1 if an allocation failure has occurred, 0 otherwise
+ */
+static int grow_slots(HashMap *map) {
+    int new_slot_count = map->slot_count * 2;
+    unsigned long mask = new_slot_count - 1;
+    MapSlot *new_slots = create_slots(new_slot_count);
     int i;
-    for (i = 0; i < MAP_HASH_TABLE_SIZE; i++) {
-        deep_free_list(map->lists[i]);
+    if (new_slots == NULL) return 1;
+    for (i = 0; i < map->slot_count; i++) {
+        unsigned long j;
+        if (map->slots[i].item == -1) continue;
+        /* finds the first empty slot starting from the one that the hash-value points to */
+        j = map->slots[i].hash & mask;
+        while (new_slots[j].item != -1) j = (j + 1) & mask;
+        new_slots[j] = map->slots[i];
     }
-    free(map);
+    free(map->slots);
+    map->slots = new_slots;
+    map->slot_count = new_slot_count;
+    return 0;
 }
 
 /**
- * Adds a given integer to the value of every symbol in a hash-map that meets a given condition.
- * Does so by applying the change to the list in every slot.  
- * Assumes that that the content of every item in the map is a symbol.
+ * Adds a content with a given name to a hash-map.
+ * Does so by growing the table if it is half full and the items if they are full, then adding the item after the
+ * existing ones and pointing the slot found for its name at it, along with the beginning of the name.
+ * Assumes that the map does not contain an item with the given name.
  * 
- * @param map       a pointer to the hash map whose items' values should be changed
- * @param to_add    the integer to add to the values
- * @param condition a pointer to a function that accepts a symbol and returns 1 if it meets the wanted condition and 0
- *                  otherwise
+ * @param map     a pointer to the map that the content should be added to
+ * @param name    the name associated with the content
+ * @param content the content to be added
+ * @return the handle of the new item, or -1 if an allocation failure has occurred
  */
-void map_add_to_all_that_apply(HashMap *map, int to_add, int (*condition)(SymbolContent symbol)) {
-    int i;
-    for (i = 0; i < MAP_HASH_TABLE_SIZE; i++) {
-        list_add_to_all_that_apply(map->lists[i], to_add, condition);
+static int map_add(HashMap *map, char *name, Content content) {
+    unsigned long hash = map_hash(name);
+    size_t name_length = strlen(name);
+    MapSlot *slot;
+    MapItem item;
+    item.name = name;
+    item.content = content;
+    /* keeps at least half of the slots empty, so searches end quickly */
+    if ((map->item_count + 1) * 2 > map->slot_count && grow_slots(map)) return -1;
+    if (map->item_count == map->item_capacity) {
+        MapItem *new_items = realloc(map->items, map->item_capacity * 2 * sizeof(MapItem));
+        /* if an allocation failure has occurred, updates the handler and leaves the map unchanged */
+        if (new_items == NULL) {
+            fprintf(stderr, "Memory Error: Memory allocation failure when adding to map\n");
+            set_alloc_failure();
+            return -1;
+        }
+        map->items = new_items;
+        map->item_capacity *= 2;
     }
+    slot = find_slot(map, name, hash);
+    slot->hash = hash;
+    slot->item = map->item_count;
+    /* the inline key is not a C string - a name of MAP_INLINE_KEY_LENGTH characters or more fills it without a
+     * terminating zero (see slot_has_name) */
+    memset(slot->key, 0, MAP_INLINE_KEY_LENGTH);
+    memcpy(slot->key, name, name_length < MAP_INLINE_KEY_LENGTH ? name_length : MAP_INLINE_KEY_LENGTH);
+    map->items[map->item_count] = item;
+    return map->item_count++;
 }
 
 /**
- * Adds every symbol in a hash-map that meets a given condition to a given linked-list.
- * Importantly, copies the symbols are added, rather then references to the same symbols.
- * Assumes every item in the map is a symbol and that the pointer to the list is not null.
+ * Adds a macro with a given name to a hash-map.
+ * Does so by creating a new Content struct with its macro field being the given macro content, and adding it to the
+ * map using map_add.
  * 
- * Does so by going over every list in the table and adding its members that meet to the condition to the given list.
+ * @param map           a pointer to the map that the macro should be added to
+ * @param name          the name of the macro
+ * @param macro_content the content of the macro to be added
+ */
+void map_add_macro(HashMap *map, char *name, MacroContent macro_content) {
+    Content content;
+    content.macro = macro_content;
+    map_add(map, name, content);
+}
+
+/**
+ * Adds an symbol with a given name to a hash-map.
+ * Does so by creating a new Content struct with its symbol field being the given symbol content, and adding it to the
+ * map using map_add.
  * 
- * @param map       the map whose symbols should be added to the list
- * @param list      the list that the symbols should be added to
- * @param condition a pointer to a function that accepts a symbol and returns 1 if it meets the wanted condition and 0
- *                  otherwise
+ * @param map            a pointer to the map that the symbol should be added to
+ * @param name           the name of the symbol
+ * @param symbol_content the content of the symbol to be added
+ * @return the handle of the new item, or -1 if an allocation failure has occurred
  */
-void map_add_matching_to_list(HashMap *map, LinkedList *list, int (*condition)(SymbolContent symbol)) {
-    int i;
-    for (i = 0; i < MAP_HASH_TABLE_SIZE; i++) {
-        list_add_matching_to_list(map->lists[i], list, condition);
-    }
+int map_add_symbol(HashMap *map, char *name, SymbolContent symbol_content) {
+    Content content;
+    content.symbol = symbol_content;
+    return map_add(map, name, content);
 }
 
+/**
+ * Adds an encoding with a given name to a hash-map.
+ * Does so by creating a new Content struct with its encoding field being the given encoding content, and adding it to
+ * the map using map_add.
+ * 
+ * @param map              a pointer to the map that the encoding should be added to
+ * @param name             the name of the encoding
+ * @param encoding_content the content of the encoding to be added
+ * @return the handle of the new item, or -1 if an allocation failure has occurred
+ */
+int map_add_encoding(HashMap *map, char *name, EncodingContent encoding_content) {
+    Content content;
+    content.encoding = encoding_content;
+    return map_add(map, name, content);
+}
+
+/**
+ * Frees a hash-map from the memory. The names and contents of its items are not freed, since they are allocated from
+ * the arena of the file they belong to.
+ * Does so by freeing the items, the table and the pointer to the map.
+ * 
+ * @param map a pointer to the map that should be freed, which may be NULL
+ */
+void free_map(HashMap *map) {
+    if (map == NULL) return;
+    free(map->items);
+    free(map->slots);
+    free(map);
+}
@@ -7,26 +7,46 @@
 #include "../../headers/util/string_ops.h"
 #include "stdio.h"
 #include "../../headers/alloc_failure_handler.h"
-#include "string.h"
+
+/**
+ * Allocates memory for a list or a node, either from a given arena or on the heap. If an allocation failure occurs,
+ * updates the handler.
+ * 
+ * @param arena a pointer to the arena that the memory should be allocated from, or NULL if it should be allocated on
+ *              the heap
+ * @param size  the number of bytes to be allocated
+ * @return a pointer to the allocated memory, or NULL if an allocation failure has occurred
+ */
+static void *list_allocate(Arena *arena, size_t size) {
+    void *memory;
+    /* the arena updates the handler by itself */
+    if (arena != NULL) return arena_allocate(arena, size);
+    memory = malloc(size);
+    if (memory == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when extending list\n");
+        set_alloc_failure();
+    }
+    return memory;
+}
 
 /**
  * Creates a new, empty linked-list.
- * Does so by allocating the required memory on the heap, then setting the list's head to a null pointer.
+ * Does so by allocating the required memory (from the given arena, or on the heap if there is none), then setting the
+ * list's head to a null pointer.
  * Also sets the content_type field to the given type.
  * 
  * @param content_type the type that the list's items' content should be
+ * @param arena        a pointer to the arena that the list and its nodes should be allocated from, or NULL if they
+ *                     should be allocated on the heap
  * @return a pointer to the new list, or NULL if an allocation failure occurred
  */
-LinkedList *create_list(ContentType content_type) {
-    LinkedList *list = malloc(sizeof(LinkedList));
-    /* if an allocation failure has occurred, updates the handler and returns NULL */
-    if (list == NULL) {
-        fprintf(stderr, "Memory Error: Memory allocation failure when creating list");
-        set_alloc_failure();
-        return NULL;
-    }
+LinkedList *create_list(ContentType content_type, Arena *arena) {
+    LinkedList *list = list_allocate(arena, sizeof(LinkedList));
+    /* if an allocation failure has occurred, returns NULL */
+    if (list == NULL) return NULL;
     list->head = NULL;
     list->content_type = content_type;
+    list->arena = arena;
     return list;
 }
 
@@ -131,21 +151,18 @@ SymbolContent *list_get_symbol(LinkedList *list, char *name) {
 
 /**
  * Adds a content with a given name to a linked-list.
- * Does so by creating a new node, setting its content to be the given content, setting it to point to the current 
- * head of the list as its next node, and finally setting it to be the new head of the list.
+ * Does so by creating a new node (from the list's arena, if it has one), setting its content to be the given content,
+ * setting it to point to the current head of the list as its next node, and finally setting it to be the new head of
+ * the list.
  * 
  * @param list    a pointer to the list that the value should be added to
  * @param name    the name associated with the value
  * @param content the content to be added
  */
 void list_add(LinkedList *list, char *name, Content content) {
-    Node *node = malloc(sizeof(Node));
-    /* if an allocation failure has occurred, updates the handler and does nothing */
-    if (node == NULL) {
-        fprintf(stderr, "Memory Error: Memory allocation failure when creating node\n");
-        set_alloc_failure();
-        return;
-    }
+    Node *node = list_allocate(list->arena, sizeof(Node));
+    /* if an allocation failure has occurred, does nothing */
+    if (node == NULL) return;
     node->name = name;
     node->content = content;
     node->next = list->head;
@@ -196,37 +213,9 @@ void list_add_int(LinkedList *list, int num) {
     list_add(list, NULL, content);
 }
 
-/**
- * Frees a linked-list and all of its  items' names and contents from the memory.
- * Does so by going over every node in the list, getting the next node and freeing the current one and its contents,
- * then doing the same with the next node.
- * Finally frees the list pointer.
- * 
- * @param list a pointer to the list that should be freed
- */
-void deep_free_list(LinkedList *list) {
-    Node *node = list->head;
-    Node *next;
-    while (node != NULL) {
-        /* if the content is a symbol, its name and list of appearances are allocated on the heap and should be freed */
-        if (list->content_type == SYMBOL) {
-            deep_free_list(node->content.symbol.appearances);
-            free(node->name);
-        }
-        /* if the content is a macro, its name and content are allocated on the heap and should be freed */
-        if (list->content_type == MACRO) {
-            free(node->content.macro);
-            free(node->name);
-        }
-        next = node->next;
-        free(node);
-        node = next;
-    }
-    free(list);
-}
-
 /**
  * Frees a linked-list and its nodes from the memory, without freeing the nodes' names contents.
+ * A list allocated from an arena is left as is, since it is released along with the arena.
  * Does so by going over every node in the list, getting the next node and freeing the current one,
  * then doing the same with the next node.
  * Finally frees the list pointer.
@@ -236,6 +225,7 @@ void deep_free_list(LinkedList *list) {
 void shallow_free_list(LinkedList *list) {
     Node *node = list->head;
     Node *next;
+    if (list->arena != NULL) return;
     while (node != NULL) {
         next = node->next;
         free(node);
@@ -244,26 +234,6 @@ void shallow_free_list(LinkedList *list) {
     free(list);
 }
 
-/**
- * Adds a given integer to the value of every symbol in a hash-linked-list that meets a given condition.
- * Does so by going over every item on the list, and if applying the condition to its symbol content yields 1,
- * adding the given integer to its value.
- * Assumes that that the content of every item in the list is a symbol.
- * 
- * @param list      a pointer to the list whose items' values should be changed
- * @param to_add    the integer to add to the values
- * @param condition a pointer to a function that accepts a symbol and returns 1 if it meets the wanted condition and 0
- *                  otherwise
- */
-void list_add_to_all_that_apply(LinkedList *list, int to_add, int (*condition)(SymbolContent symbol)) {
-    Node *node = list->head;
-    while (node != NULL) {
-        if (condition(node->content.symbol))
-            node->content.symbol.value += to_add;
-        node = node->next;
-    }
-}
-
 /**
  * Adds every symbol in a given linked-list that meets a given condition to another given linked-list.
  * Importantly, copies of the symbols are added, rather then references to the same symbols, and copies of the pointers
@@ -285,22 +255,3 @@ void list_add_matching_to_list(LinkedList *list1, LinkedList *list2, int (*condi
         node = node->next;
     }
 }
-
-/**
- * Gets the length of the longest name of any item in a linked-list.
- * Does so by traversing the entire list and updating the maximum length found whenever necessary.\
- * Assumes the list is not empty.
- * 
- * @param list a pointer to the list to be checked
- * @return the longest name of an item in the list
- */
-int get_max_name_length(LinkedList *list) {
-    Node *node = list->head;
-    int max = 0;
-    while (node != NULL) {
-        int len = strlen(node->name);
-        if (len > max) max = len;
-        node = node->next;
-    }
-    return max;
-}
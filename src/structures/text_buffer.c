@@ -0,0 +1,137 @@
+/**
+ * Includes functions that allow for interacting with text-buffers.
+ */
+#include "../../headers/structures/text_buffer.h"
+#include "stdlib.h"
+#include "stdio.h"
+#include "string.h"
+#include "../../headers/alloc_failure_handler.h"
+#include "../../headers/util/line_scan.h"
+
+#define INITIAL_CAPACITY 1024
+
+/**
+ * Creates a new, empty text-buffer.
+ * Does so by allocating the necessary memory in the heap for the buffer and for its initial capacity.
+ *
+ * @return a pointer to the new buffer, or NULL if an allocation failure has occurred
+ */
+TextBuffer *create_text_buffer() {
+    TextBuffer *buffer = (TextBuffer *)malloc(sizeof(TextBuffer));
+    /* if an allocation failure has occurred, updates the handler and returns NULL */
+    if (buffer == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating text buffer\n");
+        set_alloc_failure();
+        return NULL;
+    }
+    buffer->text = (char *)malloc(INITIAL_CAPACITY);
+    /* if an allocation failure has occurred, updates the handler and returns NULL */
+    if (buffer->text == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when creating text buffer\n");
+        set_alloc_failure();
+        free(buffer);
+        return NULL;
+    }
+    buffer->text[0] = '\0';
+    buffer->length = 0;
+    buffer->capacity = INITIAL_CAPACITY;
+    return buffer;
+}
+
+/**
+ * Makes sure a text-buffer can hold a given number of additional characters.
+ * Does so by doubling the buffer's capacity until it is large enough, and reallocating its text accordingly.
+ *
+ * @param buffer     a pointer to the buffer that should be able to hold the characters
+ * @param additional the number of characters that should be added to the buffer
+ * @return 0 if the buffer can hold the characters, 1 if an allocation failure has occurred
+ */
+static int ensure_capacity(TextBuffer *buffer, int additional) {
+    int capacity = buffer->capacity;
+    char *new_text;
+    if (buffer->length + additional < capacity) return 0;
+    while (buffer->length + additional >= capacity) capacity *= 2;
+    new_text = (char *)realloc(buffer->text, capacity);
+    /* if an allocation failure has occurred, updates the handler and leaves the buffer unchanged */
+    if (new_text == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when extending text buffer\n");
+        set_alloc_failure();
+        return 1;
+    }
+    buffer->text = new_text;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+/**
+ * Appends a string to the end of a text-buffer.
+ *
+ * @param buffer a pointer to the buffer that the string should be appended to
+ * @param string the string to be appended
+ */
+void text_buffer_append(TextBuffer *buffer, char *string) {
+    text_buffer_append_characters(buffer, string, strlen(string));
+}
+
+/**
+ * Appends a given number of characters to the end of a text-buffer. The characters don't need to be followed by a
+ * terminating 0.
+ * Does so by making sure the buffer has enough space for the characters, copying them to the end of the text and
+ * terminating the text after them.
+ *
+ * @param buffer     a pointer to the buffer that the characters should be appended to
+ * @param characters a pointer to the first character to be appended
+ * @param length     the number of characters to be appended
+ */
+void text_buffer_append_characters(TextBuffer *buffer, char *characters, int length) {
+    if (ensure_capacity(buffer, length)) return;
+    memcpy(buffer->text + buffer->length, characters, length);
+    buffer->length += length;
+    buffer->text[buffer->length] = '\0';
+}
+
+/**
+ * Appends a line to the end of a text-buffer, followed by a line break.
+ * Does so by appending the line and then appending a line break.
+ *
+ * @param buffer a pointer to the buffer that the line should be appended to
+ * @param line   the line to be appended, without a line break
+ */
+void text_buffer_append_line(TextBuffer *buffer, char *line) {
+    text_buffer_append(buffer, line);
+    text_buffer_append(buffer, "\n");
+}
+
+/**
+ * Reads a line from a text-buffer into a given character array, and advances a given position to the start of the
+ * next line. If the line is longer than the given maximum length, only its beginning is copied.
+ * Does so by finding the first line break after the position (or the end of the text), copying the characters before
+ * it and then skipping the line break.
+ *
+ * @param buffer     a pointer to the buffer that should be read from
+ * @param position   a pointer to the index in the buffer's text in which the line starts
+ * @param max_length the maximum number of characters that should be copied to the array
+ * @param s          an array that should contain the output, which can hold at least max_length + 1 characters
+ */
+void text_buffer_read_line(TextBuffer *buffer, int *position, int max_length, char s[]) {
+    char *start = buffer->text + *position;
+    char *end = buffer->text + buffer->length;
+    char *line_end = find_line_break(start, end);
+    int length = line_end - start;
+    if (length > max_length) length = max_length;
+    memcpy(s, start, length);
+    s[length] = '\0';
+    /* skips the line break at the end of the line, if there is one */
+    if (line_end < end) line_end++;
+    *position = line_end - buffer->text;
+}
+
+/**
+ * Frees a text-buffer and its text from the memory.
+ *
+ * @param buffer a pointer to the buffer that should be freed
+ */
+void free_text_buffer(TextBuffer *buffer) {
+    free(buffer->text);
+    free(buffer);
+}
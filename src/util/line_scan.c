@@ -0,0 +1,108 @@
+/**
+ * Includes the function that finds line breaks, and its versions for the different instruction sets.
+ */
+
+#include "../../headers/util/line_scan.h"
+#include "pthread.h"
+
+/* the vector versions are only available when compiling for x86 processors with GCC (or a compatible compiler) */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_LINE_SCAN
+#include "immintrin.h"
+#endif
+
+#define LINE_BREAK '\n'
+
+/**
+ * The version of the search that is used, chosen once based on the processor.
+ */
+static char *(*line_break_finder)(char *start, char *end);
+
+/**
+ * Makes sure the version is chosen exactly once.
+ */
+static pthread_once_t line_break_finder_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Finds the first line break in a given range of characters, one character at a time.
+ * 
+ * @param start a pointer to the first character in the range
+ * @param end   a pointer to the character immediately after the range
+ * @return a pointer to the first line break in the range, or end if there is no line break in it
+ */
+static char *find_line_break_scalar(char *start, char *end) {
+    while (start < end && *start != LINE_BREAK) start++;
+    return start;
+}
+
+#ifdef VECTOR_LINE_SCAN
+
+/**
+ * Finds the first line break in a given range of characters, 16 characters at a time using SSE2 instructions.
+ * Does so by comparing every 16 characters with a vector of line breaks at once, and taking the position of the
+ * lowest matching character out of the comparison's mask. The characters at the end of the range that don't fill a
+ * whole vector are checked one at a time.
+ * 
+ * @param start a pointer to the first character in the range
+ * @param end   a pointer to the character immediately after the range
+ * @return a pointer to the first line break in the range, or end if there is no line break in it
+ */
+__attribute__((target("sse2")))
+static char *find_line_break_sse2(char *start, char *end) {
+    __m128i line_breaks = _mm_set1_epi8(LINE_BREAK);
+    while (end - start >= 16) {
+        __m128i characters = _mm_loadu_si128((__m128i *) start);
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(characters, line_breaks));
+        if (mask != 0) return start + __builtin_ctz(mask);
+        start += 16;
+    }
+    return find_line_break_scalar(start, end);
+}
+
+/**
+ * Finds the first line break in a given range of characters, 32 characters at a time using AVX2 instructions.
+ * Does so in the same way as the SSE2 version, with vectors that are twice as wide.
+ * 
+ * @param start a pointer to the first character in the range
+ * @param end   a pointer to the character immediately after the range
+ * @return a pointer to the first line break in the range, or end if there is no line break in it
+ */
+__attribute__((target("avx2")))
+static char *find_line_break_avx2(char *start, char *end) {
+    __m256i line_breaks = _mm256_set1_epi8(LINE_BREAK);
+    while (end - start >= 32) {
+        __m256i characters = _mm256_loadu_si256((__m256i *) start);
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(characters, line_breaks));
+        if (mask != 0) return start + __builtin_ctz(mask);
+        start += 32;
+    }
+    return find_line_break_sse2(start, end);
+}
+
+#endif
+
+/**
+ * Chooses the version of the search based on the instruction sets that the processor supports.
+ */
+static void choose_line_break_finder() {
+    line_break_finder = find_line_break_scalar;
+#ifdef VECTOR_LINE_SCAN
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) line_break_finder = find_line_break_avx2;
+    else if (__builtin_cpu_supports("sse2")) line_break_finder = find_line_break_sse2;
+#endif
+}
+
+/**
+ * Finds the first line break in a given range of characters.
+ * Never reads characters outside of the range, so it can be used on text that doesn't end with a terminating 0.
+ * Does so using the version of the search that fits the processor, which is chosen on the first call.
+ * 
+ * @param start a pointer to the first character in the range
+ * @param end   a pointer to the character immediately after the range
+ * @return a pointer to the first line break in the range, or end if there is no line break in it
+ */
+char *find_line_break(char *start, char *end) {
+    pthread_once(&line_break_finder_once, choose_line_break_finder);
+    return line_break_finder(start, end);
+}
@@ -0,0 +1,186 @@
+/**
+ * Includes functions that open source-files and read them line by line.
+ * Mapping the file lets lines be found by searching the contents with vector instructions, instead of reading the
+ * file one character at a time.
+ */
+
+/* the memory-mapping functions are part of POSIX rather than ANSI C */
+#define _POSIX_C_SOURCE 200112L
+
+#include "../../headers/util/source_file.h"
+#include "../../headers/util/line_scan.h"
+#include "../../headers/util/general_util.h"
+#include "../../headers/alloc_failure_handler.h"
+#include "../../headers/console.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+
+/**
+ * The number of characters that are read at once from a file that can't be mapped.
+ */
+#define READ_CHUNK_SIZE 65536
+
+/**
+ * Copies the contents of a file that can't be mapped (such as a pipe) into allocated memory.
+ * Does so by reading chunks of the file and doubling the allocated memory whenever it is full.
+ * 
+ * @param fd     the file descriptor of the open file
+ * @param source a pointer to the source-file whose text and length should be set
+ * @return 1 if the file could not be read or an allocation failure has occurred, 0 otherwise
+ */
+static int read_source_text(int fd, SourceFile *source) {
+    long capacity = READ_CHUNK_SIZE;
+    long bytes_read;
+    source->text = malloc(capacity);
+    source->length = 0;
+    while (source->text != NULL) {
+        if (source->length == capacity) {
+            char *new_text = realloc(source->text, capacity * 2);
+            if (new_text == NULL) break;
+            source->text = new_text;
+            capacity *= 2;
+        }
+        bytes_read = read(fd, source->text + source->length, capacity - source->length);
+        if (bytes_read < 0) {
+            free(source->text);
+            return 1;
+        }
+        if (bytes_read == 0) return 0;
+        source->length += bytes_read;
+    }
+    /* an allocation failure has occurred */
+    fprintf(stderr, "Memory Error: Memory allocation failure when reading file\n");
+    set_alloc_failure();
+    free(source->text);
+    return 1;
+}
+
+/**
+ * Opens a source-file with a given name and maps its contents into the memory.
+ * Does so by opening the file, mapping it as a whole (with a hint that it is read sequentially) and closing it, since
+ * the mapping stays valid after the file is closed. If the file can't be mapped, copies its contents instead.
+ * 
+ * @param file_name the name of the file, including its extension
+ * @return a pointer to the source-file, or NULL if the file could not be opened or an allocation failure has occurred
+ */
+SourceFile *open_source_file(char *file_name) {
+    struct stat file_status;
+    int fd;
+    SourceFile *source = malloc(sizeof(SourceFile));
+    /* if an allocation failure has occurred, updates the handler and returns NULL */
+    if (source == NULL) {
+        fprintf(stderr, "Memory Error: Memory allocation failure when opening file\n");
+        set_alloc_failure();
+        return NULL;
+    }
+    fd = open(file_name, O_RDONLY);
+    if (fd == -1 || fstat(fd, &file_status) == -1) {
+        if (fd != -1) close(fd);
+        free(source);
+        return NULL;
+    }
+    source->position = 0;
+    source->mapped = 0;
+    source->text = NULL;
+    source->length = 0;
+    /* regular, non-empty files are mapped, since a mapping can't be empty */
+    if (S_ISREG(file_status.st_mode) && file_status.st_size > 0) {
+        void *text = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (text != MAP_FAILED) {
+            posix_madvise(text, file_status.st_size, POSIX_MADV_SEQUENTIAL);
+            source->text = text;
+            source->length = file_status.st_size;
+            source->mapped = 1;
+        }
+    }
+    if (!source->mapped && (!S_ISREG(file_status.st_mode) || file_status.st_size > 0) &&
+        read_source_text(fd, source)) {
+        close(fd);
+        free(source);
+        return NULL;
+    }
+    close(fd);
+    return source;
+}
+
+/**
+ * Checks if every line of a source-file has been read. Like a file that is read with getc, a source-file whose last
+ * character is a line break has another, empty line after it.
+ * Does so by checking if the position has moved past the end of the text, which only happens when reading the last
+ * line.
+ * 
+ * @param source a pointer to the source-file
+ * @return 1 if every line has been read, 0 otherwise
+ */
+int source_ended(SourceFile *source) {
+    return source->position > source->length;
+}
+
+/**
+ * Asks the system to start loading the contents of a source-file into the memory in the background, so they are
+ * ready by the time the file is read.
+ * Does so by advising the system that the mapped contents will be needed soon, which starts reading them ahead
+ * without waiting for them. The contents of a file that is not mapped were already read when it was opened.
+ * 
+ * @param source a pointer to the source-file
+ */
+void prefetch_source_file(SourceFile *source) {
+    if (source->mapped) posix_madvise(source->text, source->length, POSIX_MADV_WILLNEED);
+}
+
+/**
+ * Reads the next line from a source-file into a given character array as long as it is at most 80 characters long.
+ * If the line is longer, copies only its beginning and reports an error.
+ * Does so by finding the line break that ends the line, copying the characters before it (up to the maximum length)
+ * and moving the position past it. If the line is the last one (it has no line break), moves the position past the
+ * end of the text.
+ * 
+ * @param source      a pointer to the source-file
+ * @param file_name   the name of the file (used for error reporting)
+ * @param line_number the number of the line being read (used for error reporting)
+ * @param s           an array that should contain the output
+ * @return 0 if the line was read successfully, 1 otherwise
+ */
+int source_read_line(SourceFile *source, char *file_name, int line_number, char s[]) {
+    char *start;
+    char *line_end;
+    long length;
+    /* if the text has been read up to its end, the line is empty (and it is the last line if the position is at the
+     * end of the text). This is also the only case for an empty file, whose text is NULL */
+    if (source->position >= source->length) {
+        if (source->position == source->length) source->position++;
+        s[0] = '\0';
+        return 0;
+    }
+    start = source->text + source->position;
+    line_end = find_line_break(start, source->text + source->length);
+    length = line_end - start;
+    /* the line break is skipped, and if there is none, the position moves past the end */
+    source->position += length + 1;
+    if (length > MAX_LINE_LENGTH) {
+        console_printf("Input error: Line %d in file %s is too long!\n", line_number, file_name);
+        memcpy(s, start, MAX_LINE_LENGTH);
+        s[MAX_LINE_LENGTH] = '\0';
+        return 1;
+    }
+    memcpy(s, start, length);
+    s[length] = '\0';
+    return 0;
+}
+
+/**
+ * Closes a source-file and frees it from the memory.
+ * Does so by unmapping or freeing its text, and then freeing the pointer to it.
+ * 
+ * @param source a pointer to the source-file that should be closed
+ */
+void close_source_file(SourceFile *source) {
+    if (source->mapped) munmap(source->text, source->length);
+    else free(source->text);
+    free(source);
+}
@@ -3,7 +3,6 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "ctype.h"
-#include "../../headers/alloc_failure_handler.h"
 
 #define BLANKS " \t"
 
@@ -32,88 +31,91 @@ int exists(char *string, char c) {
 }
 
 /**
- * Returns the first maximum substring of a given string that doesn't include any of the given separators.
+ * Returns a view of an entire string.
+ * Does so by pointing the view at the string's first character, with the string's length.
+ * 
+ * @param string the string to be viewed
+ * @return a view of all the characters of the string
+ */
+StringView view_of(char *string) {
+    StringView view;
+    view.start = string;
+    view.length = strlen(string);
+    return view;
+}
+
+/**
+ * Returns a view of the first maximum substring of a given string that doesn't include any of the given separators.
  * For example, if the function would be called with a string parameter of "  x Hello  xx World   " and a separators
- * parameter of " x", the string "Hello" would be returned.
- * If there is no such substring, returns an empty string.
- * Returns the output as a new string that has been allocated on the heap.
- * Places the pointer to the character immediately after the token as the value of rest.
- * Does not assume that the string is not null.
+ * parameter of " x", a view of "Hello" would be returned.
+ * If there is no such substring, returns an empty view.
+ * Places the pointer to the character immediately after the token as the value of rest, or the pointer to the
+ * string's terminating 0 if there is no token.
  * 
  * Does so by advancing a pointer throughout the string until it points to a character that is not a separator.
- * This character marks the start of the token.
- * It then starts counting the number of characters that the token should include while advancing the pointer, and stops
- * when a the pointer points to a separator character, a terminating 0 - the character immediately after the
- * token.
- * Then, allocates memory in the size of the characters counted, plus one for the terminating 0.
- * Next, copies N characters from to the new string starting from the pointer minus N, where N is the number of
- * characters counted.
- * Finally, sets the value of the rest pointer to the pointer that now points to the part after the token.
+ * This character marks the start of the token. It then advances the pointer until it points to a separator character
+ * or a terminating 0 - the character immediately after the token, and counts the characters on the way.
  * 
  * @param string     the string whose first token should be found
  * @param separators a string made of the characters that the token should be split by
  * @param rest       a pointer to a string whose value will be changed to the string that starts immediately after 
  *                   the token (as a pointer to the character in the original string, not as a new string)
- * @return a new string with the first maximum substring of a given string that doesn't include any of the
- *         given separators - essentially the first token when splitting by the separators, an empty string if no
- *         such substring exists, or null if string is null or an allocation failure has occurred
+ * @return a view of the first token when splitting by the separators, or an empty view if no such token exists
  */
-char *find_token(char *string, char *separators, char **rest) {
-    /* the token that should be returned */
-    char *output;
-    /* the size of the token (not including the termination 0) */
-    int output_length = 0;
-    /* checks for nul string */
-    if (string == NULL) return NULL;
-    /* if the string is empty, returns an empty token */
-    if (*string == '\0') {
-        output = malloc(1);
-        /* if an allocation failure has occurred, updates the handler and returns NULL */
-        if (output == NULL) {
-            printf("Memory Error: Memory allocation failure when creating string token\n");
-            set_alloc_failure();
-            return NULL;
-        }
-        output[0] = '\0';
-        return output;
-    }
-    /* advances the string pointer until its value is not a separator */
-    while (exists(separators, *string)) {
-        string++;
-        /* if the pointer's value is 0, then the string only includes separators and an empty token is returned */
-        if (*string == '\0') {
-            output = malloc(1);
-            /* if an allocation failure has occurred, updates the handler and returns NULL */
-            if (output == NULL) {
-                printf("Memory Error: Memory allocation failure when creating string token\n");
-                set_alloc_failure();
-                return NULL;
-            }
-            output[0] = '\0';
-            return output;
-        }
-    }
-    /* advances the string pointer and increments output_length until string
-     * points to a non-separator character or the end of the string */
-    while (!exists(separators, *string) && *string != '\0') {
-        string++;
-        output_length++;
-    }
-    /* allocates memory for the token based on the characters counted */
-    output = (char *) malloc(output_length + 1);
-    /* if an allocation failure has occurred, updates the handler and returns NULL */
-    if (output == NULL) {
-        printf("Memory Error: Memory allocation failure when creating string token\n");
-        set_alloc_failure();
-        return NULL;
-    }
-    /* string now points to the character after the token, so string - output_length points to the token's first
-     * character, which means the first output_length characters of this pointer represent the token, and thus
-     * they are copied */
-    strncpy(output, string - output_length, output_length);
-    output[output_length] = '\0';
-    /* changes the value of the rest pointer to string, which now points to the character after the token */
+StringView next_token(char *string, char *separators, char **rest) {
+    StringView token;
+    /* advances the string pointer until its value is not a separator (or the end of the string) */
+    while (*string != '\0' && exists(separators, *string)) string++;
+    token.start = string;
+    /* advances the string pointer until its value is a separator or the end of the string */
+    while (*string != '\0' && !exists(separators, *string)) string++;
+    token.length = string - token.start;
     *rest = string;
+    return token;
+}
+
+/**
+ * Returns a view of the same characters as a given view, without any heading spaces or tabs and trailing whitespaces.
+ * Does so by advancing the view's start past the blank spaces at its beginning, and shortening it until its last
+ * character is not a whitespace.
+ * 
+ * @param view the view which should be trimmed
+ * @return the trimmed view
+ */
+StringView trim_view(StringView view) {
+    while (view.length > 0 && exists(BLANKS, *view.start)) {
+        view.start++;
+        view.length--;
+    }
+    while (view.length > 0 && isspace(view.start[view.length - 1])) view.length--;
+    return view;
+}
+
+/**
+ * Copies the characters of a view into a given array, followed by a terminating 0.
+ * 
+ * @param view   the view to be copied
+ * @param buffer an array which can hold at least the view's length plus one characters
+ */
+void view_copy(StringView view, char buffer[]) {
+    memcpy(buffer, view.start, view.length);
+    buffer[view.length] = '\0';
+}
+
+/**
+ * Creates a new string (allocated from an arena) with the characters of a given view. Should only be used for strings
+ * that outlive the line they were found in, such as the names of symbols and macros.
+ * Does so by allocating enough memory for the characters and the terminating 0, and copying the view into it.
+ * 
+ * @param view  the view to be copied
+ * @param arena a pointer to the arena that the string should be allocated from
+ * @return the new string, or null if an allocation failure has occurred
+ */
+char *view_duplicate(StringView view, Arena *arena) {
+    /* if an allocation failure has occurred, the arena has already updated the handler */
+    char *output = arena_allocate(arena, view.length + 1);
+    if (output == NULL) return NULL;
+    view_copy(view, output);
     return output;
 }
 
@@ -132,38 +134,6 @@ char is_line_blank(char *string) {
     return 1;
 }
 
-/**
-* Removes any heading and trailing spaces or tabs from a string.
-* Does so by finding the number of blank spaces at the start and creating a copy of the string that starts after
-* those blank spaces, and then placing the closing '\0' after the first non-blank character from the end.
-*
-* @param string a string which should be trimmed
-* @return a new trimmed version of the original string, or NULL if an allocation failure has occurred
-*/
-char *trim(char string[]) {
-    char *output;
-    /* the number of blank spaces at the start of the string */
-    int head_length = strspn(string, BLANKS);
-    /* index of character to check in the string */
-    int i;
-    /* the output string, length is at most the length of the input without the blank spaces at the start */
-    output = (char *) malloc(strlen(string) - head_length + 1);
-    /* if an allocation failure has occurred, updates the handler and returns NULL */
-    if (output == NULL) {
-        printf("Memory Error: Memory allocation failure when creating trimmed string\n");
-        set_alloc_failure();
-        return NULL;
-    }
-    strcpy(output, string + head_length);
-    /* finds the first character (from the end) which isn't a blank space, and sets it to be the last character */
-    i = strlen(output) - 1;
-    while (i >= 0 && (isspace(output[i]))) {
-        i--;
-    }
-    output[i + 1] = '\0';
-    return output;
-}
-
 /**
  * Checks if a given string represents an integer (that may start with one + or -).
  * Assumes the string is not empty.